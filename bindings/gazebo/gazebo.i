@@ -4,6 +4,8 @@
 #define SWIG_FILE_WITH_INIT
 #include "scenario/gazebo/GazeboEntity.h"
 #include "scenario/gazebo/GazeboSimulator.h"
+#include "scenario/gazebo/GazeboSimulatorPool.h"
+#include "scenario/gazebo/InverseKinematics.h"
 #include "scenario/gazebo/Joint.h"
 #include "scenario/gazebo/Link.h"
 #include "scenario/gazebo/Model.h"
@@ -55,14 +57,20 @@ namespace scenario::gazebo::utils {
 %rename("") Limit;
 %rename("") Contact;
 %rename("") JointType;
+%rename("") BaseState;
 %rename("") Verbosity;
 %rename("") JointLimit;
+%rename("") Statistics;
+%rename("") Termination;
 %rename("") ContactPoint;
 %rename("") ECMSingleton;
 %rename("") GazeboEntity;
 %rename("") PhysicsEngine;
 %rename("") GazeboSimulator;
+%rename("") GazeboSimulatorPool;
+%rename("") InverseKinematics;
 %rename("") JointControlMode;
+%rename("") AccumulatedQuantity;
 
 // Public helpers
 %include "scenario/gazebo/utils.h"
@@ -73,6 +81,7 @@ namespace scenario::gazebo::utils {
 %shared_ptr(scenario::gazebo::Model)
 %shared_ptr(scenario::gazebo::World)
 %shared_ptr(scenario::gazebo::GazeboEntity)
+%shared_ptr(scenario::gazebo::GazeboSimulator)
 
 // Ignored methods
 %ignore scenario::gazebo::GazeboEntity::ecm;
@@ -104,6 +113,11 @@ namespace scenario::gazebo::utils {
 
 // GazeboSimulator
 %include "scenario/gazebo/GazeboSimulator.h"
+%template(VectorOfTerminations) std::vector<scenario::gazebo::Termination>;
+%include "scenario/gazebo/GazeboSimulatorPool.h"
+
+// Inverse kinematics
+%include "scenario/gazebo/InverseKinematics.h"
 
 // ECMSingleton
 %ignore scenario::plugins::gazebo::ECMSingleton::clean;
@@ -10,6 +10,7 @@
 #include "gympp/base/Log.h"
 #include "gympp/base/Random.h"
 
+#include <algorithm>
 #include <cassert>
 #include <ostream>
 #include <random>
@@ -27,54 +28,117 @@ class Box::Impl
 public:
     Box::Limit low;
     Box::Limit high;
+    Box::Limit range;
     Shape shape;
+    Shape strides;
+
+    bool initialize(const Shape& shape);
+    void initializeFallback();
 };
 
+bool Box::Impl::initialize(const Shape& shape)
+{
+    this->shape = shape;
+    strides.assign(shape.size(), 1);
+
+    // Row-major strides, expressed in number of elements
+    for (size_t i = shape.size(); i-- > 1;) {
+        strides[i - 1] = strides[i] * shape[i];
+    }
+
+    const size_t size = shape.empty() ? 1 : strides[0] * shape[0];
+
+    if (size == 0) {
+        gymppError << "The shape of the space must not contain empty dimensions"
+                   << std::endl;
+        return false;
+    }
+
+    if (low.size() != size || high.size() != size) {
+        gymppError << "The size of the limits does not match with the shape "
+                   << "of the space (" << size << ")" << std::endl;
+        return false;
+    }
+
+    range.resize(size);
+
+    for (size_t i = 0; i < size; ++i) {
+        range[i] = high[i] - low[i];
+    }
+
+    return true;
+}
+
+void Box::Impl::initializeFallback()
+{
+    // Keep the limits shared by low and high in a flat space
+    const size_t size = std::min(low.size(), high.size());
+
+    gymppError << "Falling back to a flat space of size " << size << std::endl;
+
+    low.resize(size);
+    high.resize(size);
+
+    this->shape = {size};
+    strides = {1};
+    range.resize(size);
+
+    for (size_t i = 0; i < size; ++i) {
+        range[i] = high[i] - low[i];
+    }
+}
+
 Box::Box(const DataSupport low, const DataSupport high, const Shape& shape)
     : pImpl{new Impl(), [](Impl* impl) { delete impl; }}
 {
-    // TODO
-    assert(shape.size() == 1);
+    size_t size = 1;
 
-    pImpl->shape = shape;
-    pImpl->low = Limit(shape[0], low);
-    pImpl->high = Limit(shape[0], high);
+    for (const auto dimension : shape) {
+        size *= dimension;
+    }
+
+    // Broadcast the scalar limits to all the elements
+    pImpl->low = Limit(size, low);
+    pImpl->high = Limit(size, high);
+
+    if (!pImpl->initialize(shape)) {
+        pImpl->initializeFallback();
+    }
 }
 
 Box::Box(const Limit& low, const Limit& high)
+    : Box(low, high, {low.size()})
+{}
+
+Box::Box(const Limit& low, const Limit& high, const Shape& shape)
     : pImpl{new Impl(), [](Impl* impl) { delete impl; }}
 {
-    assert(low.size() == high.size());
-    pImpl->shape = {low.size()};
-
-    // TODO
-    assert(pImpl->shape.size() == 1);
-
     pImpl->low = low;
     pImpl->high = high;
+
+    if (!pImpl->initialize(shape)) {
+        pImpl->initializeFallback();
+    }
 }
 
 Box::Sample Box::Box::sample()
 {
     Space::Sample randomSample;
 
-    // Create the buffer
-    // TODO: 1D
-    assert(pImpl->shape.size() == 1);
-    assert(pImpl->shape[0] != 0);
-    auto data = Buffer(pImpl->shape[0], DataSupport{});
+    auto data = randomSample.resize<DataSupport>(pImpl->range.size());
+    std::uniform_real_distribution<DataSupport> distr(0, 1);
 
-    // Fill it with random data within the bounds
-    for (unsigned i = 0; i < data.size(); ++i) {
-        auto min = pImpl->low[i];
-        auto max = pImpl->high[i];
-
-        std::uniform_real_distribution<> distr(min, max);
+    // Fill the flat buffer with random data within the bounds
+    for (size_t i = 0; i < data.size(); ++i) {
         data[i] = distr(Random::engine());
     }
 
-    // Create a Sample containing the buffer
-    randomSample.buffer = std::move(data);
+    const DataSupport* low = pImpl->low.data();
+    const DataSupport* range = pImpl->range.data();
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = low[i] + data[i] * range[i];
+    }
 
     return randomSample;
 }
@@ -91,44 +155,61 @@ bool Box::contains(const Space::Sample& data) const
         return false;
     }
 
-    // TODO: only 1D
-    assert(pImpl->shape.size() == 1);
+    const size_t size = pImpl->low.size();
 
-    if (bufferPtr->size() != pImpl->shape[0]) {
+    if (bufferPtr->size() != size) {
         gymppError << "The size of the buffer (" << bufferPtr->size()
-                   << ") does not match with the shape of the space ("
-                   << pImpl->shape[0] << ")" << std::endl;
+                   << ") does not match with the shape of the space (" << size
+                   << ")" << std::endl;
         return false;
     }
 
-    for (unsigned i = 0; i < bufferPtr->size(); ++i) {
-        if (((*bufferPtr)[i] > pImpl->high[i])
-            || ((*bufferPtr)[i] < pImpl->low[i])) {
-            gymppError
-                << "The sample does not comply to the limits set for its space"
-                << std::endl;
-            return false;
-        }
+    const DataSupport* x = bufferPtr->data();
+    const DataSupport* low = pImpl->low.data();
+    const DataSupport* high = pImpl->high.data();
+
+    // Branchless accumulation over the flat buffer, it can be vectorized
+    bool inside = true;
+
+    for (size_t i = 0; i < size; ++i) {
+        inside &= (x[i] >= low[i]) & (x[i] <= high[i]);
+    }
+
+    if (!inside) {
+        gymppError
+            << "The sample does not comply to the limits set for its space"
+            << std::endl;
+        return false;
     }
 
     return true;
 }
 
-typename Box::Limit Box::high()
+const typename Box::Limit& Box::high() const
 {
     return pImpl->high;
 }
 
-typename Box::Limit Box::low()
+const typename Box::Limit& Box::low() const
 {
     return pImpl->low;
 }
 
-Box::Shape Box::shape()
+const Box::Shape& Box::shape() const
 {
     return pImpl->shape;
 }
 
+const Box::Shape& Box::strides() const
+{
+    return pImpl->strides;
+}
+
+size_t Box::size() const
+{
+    return pImpl->low.size();
+}
+
 // ========
 // DISCRETE
 // ========
@@ -10,6 +10,7 @@
 #define GYMPP_BASE_COMMON
 
 #include <any>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <typeinfo>
@@ -37,11 +38,38 @@ namespace gympp {
         namespace data {
             using Shape = std::vector<size_t>;
 
+            template <typename T>
+            class Span;
             struct Sample;
         } // namespace data
     } // namespace base
 } // namespace gympp
 
+// Non-owning view of contiguous elements
+template <typename T>
+class gympp::base::data::Span
+{
+public:
+    Span() = default;
+    Span(T* data, const size_t size)
+        : m_data(data)
+        , m_size(size)
+    {}
+
+    T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+
+    T& operator[](const size_t i) const { return m_data[i]; }
+
+private:
+    T* m_data = nullptr;
+    size_t m_size = 0;
+};
+
 struct gympp::base::data::Sample
 {
     GenericBuffer buffer;
@@ -89,6 +117,39 @@ struct gympp::base::data::Sample
     {
         return std::get_if<typename BufferContainer<T>::type>(&buffer);
     }
+
+    // Get a view of the buffer, empty if it does not store the type T
+    template <typename T>
+    Span<const T> span() const
+    {
+        auto bufferPtr = getBuffer<T>();
+        return bufferPtr ? Span<const T>(bufferPtr->data(), bufferPtr->size())
+                         : Span<const T>();
+    }
+
+    template <typename T>
+    Span<T> span()
+    {
+        auto bufferPtr = getBuffer<T>();
+        return bufferPtr ? Span<T>(bufferPtr->data(), bufferPtr->size())
+                         : Span<T>();
+    }
+
+    // Prepare the buffer to store size elements of type T and get its view.
+    // The storage is reused if the sample already stores a buffer of type T
+    // with enough capacity, and it is allocated otherwise.
+    template <typename T>
+    Span<T> resize(const size_t size)
+    {
+        auto bufferPtr = getBuffer<T>();
+
+        if (!bufferPtr) {
+            bufferPtr = &buffer.emplace<typename BufferContainer<T>::type>();
+        }
+
+        bufferPtr->resize(size);
+        return Span<T>(bufferPtr->data(), bufferPtr->size());
+    }
 };
 
 struct gympp::base::Range
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#ifndef GYMPP_BASE_DOUBLEBUFFER_H
+#define GYMPP_BASE_DOUBLEBUFFER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace gympp {
+    namespace base {
+        template <typename T>
+        class DoubleBuffer;
+    } // namespace base
+} // namespace gympp
+
+/**
+ * Lock-free exchange of fixed-size buffers between two threads.
+ *
+ * The buffer supports a single producer and a single consumer. It is a
+ * sequence lock (seqlock) over two slots: the producer always writes the slot
+ * that is not published, therefore the consumer only retries when the
+ * producer publishes twice while a read is in progress.
+ *
+ * Both slots are allocated when the buffer is created. Writes and reads never
+ * allocate memory.
+ */
+template <typename T>
+class gympp::base::DoubleBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "DoubleBuffer only supports trivially copyable elements");
+
+public:
+    explicit DoubleBuffer(const size_t size = 0)
+        : m_slots{std::vector<T>(size), std::vector<T>(size)}
+    {}
+
+    /**
+     * Get the number of elements of the buffer.
+     */
+    size_t size() const { return m_slots[0].size(); }
+
+    /**
+     * Publish new data.
+     *
+     * @note This method can only be called by the producer thread.
+     *
+     * @param fill Callable that receives the pointer to the size() elements
+     * to fill.
+     */
+    template <typename Fill>
+    void publish(Fill&& fill)
+    {
+        const uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+
+        // Odd sequence numbers mark a write in progress
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        fill(m_slots[WriteSlot(sequence)].data());
+
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Publish a copy of the given elements.
+     *
+     * @note This method can only be called by the producer thread.
+     *
+     * @param data Pointer to size() elements.
+     */
+    void write(const T* data)
+    {
+        publish([&](T* slot) { std::copy(data, data + size(), slot); });
+    }
+
+    /**
+     * Copy the last published data.
+     *
+     * @note This method can only be called by the consumer thread.
+     *
+     * @param data Pointer to size() elements where the data is copied.
+     * @return The version of the copied data, that increases at every publish.
+     */
+    uint64_t read(T* data) const
+    {
+        while (true) {
+            const uint64_t before = m_sequence.load(std::memory_order_acquire);
+            const auto& slot = m_slots[ReadSlot(before)];
+
+            std::copy(slot.begin(), slot.end(), data);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t after = m_sequence.load(std::memory_order_relaxed);
+
+            // The copied slot is written again only by the second write that
+            // starts after the read
+            if (after < (before | 1) + 2) {
+                return before / 2;
+            }
+        }
+    }
+
+    /**
+     * Get the version of the last published data.
+     */
+    uint64_t version() const
+    {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static size_t ReadSlot(const uint64_t sequence)
+    {
+        return (sequence / 2) % 2;
+    }
+
+    static size_t WriteSlot(const uint64_t sequence)
+    {
+        return (sequence / 2 + 1) % 2;
+    }
+
+    std::atomic<uint64_t> m_sequence = 0;
+    std::array<std::vector<T>, 2> m_slots;
+};
+
+#endif // GYMPP_BASE_DOUBLEBUFFER_H
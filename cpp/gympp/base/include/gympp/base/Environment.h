@@ -12,6 +12,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gympp/base/Common.h"
@@ -78,6 +79,22 @@ public:
     {}
 
     virtual std::optional<State> step(const Action& action) = 0;
+
+    // Step the environment writing the result in a state owned by the caller.
+    // Environments should override it to reuse the storage of the state, so
+    // that stepping in a loop does not allocate memory.
+    virtual bool step(const Action& action, State& state)
+    {
+        auto newState = step(action);
+
+        if (!newState) {
+            return false;
+        }
+
+        state = std::move(newState.value());
+        return true;
+    }
+
     virtual std::optional<Observation> reset() = 0;
     virtual bool render(RenderMode mode) = 0;
     virtual std::vector<size_t> seed(size_t seed = 0) = 0;
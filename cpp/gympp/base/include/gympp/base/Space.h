@@ -55,14 +55,22 @@ public:
     Box() = delete;
     Box(const DataSupport low, const DataSupport high, const Shape& shape);
     Box(const Limit& low, const Limit& high);
+    Box(const Limit& low, const Limit& high, const Shape& shape);
     ~Box() override = default;
 
     Sample sample() override;
     bool contains(const Sample& data) const override;
 
-    Limit high();
-    Limit low();
-    Shape shape();
+    // The limits are stored contiguously in row-major order
+    const Limit& high() const;
+    const Limit& low() const;
+    const Shape& shape() const;
+
+    // Row-major strides of the dimensions, expressed in number of elements
+    const Shape& strides() const;
+
+    // Total number of elements of the space
+    size_t size() const;
 
 private:
     class Impl;
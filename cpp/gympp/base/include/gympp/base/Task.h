@@ -11,6 +11,7 @@
 
 #include "gympp/base/Environment.h"
 #include <optional>
+#include <utility>
 
 namespace gympp {
     namespace base {
@@ -32,6 +33,20 @@ public:
     virtual bool setAction(const Action& action) = 0;
     virtual std::optional<Reward> computeReward() = 0;
     virtual std::optional<Observation> getObservation() = 0;
+
+    // Write the observation in a sample owned by the caller. Tasks should
+    // override it to reuse the storage of the sample.
+    virtual bool fillObservation(Observation& observation)
+    {
+        auto newObservation = getObservation();
+
+        if (!newObservation) {
+            return false;
+        }
+
+        observation = std::move(newObservation.value());
+        return true;
+    }
 };
 
 #endif // GYMPP_GAZEBO_TASK_H
@@ -92,6 +92,17 @@ GazeboEnvironment::~GazeboEnvironment() = default;
 
 std::optional<GazeboEnvironment::State>
 GazeboEnvironment::step(const Action& action)
+{
+    State state;
+
+    if (!this->step(action, state)) {
+        return {};
+    }
+
+    return state;
+}
+
+bool GazeboEnvironment::step(const Action& action, State& state)
 {
     assert(action_space);
     assert(observation_space);
@@ -101,7 +112,7 @@ GazeboEnvironment::step(const Action& action)
     if (!this->initializeSimulation()) {
         gymppError << "Failed to initialize the simulation" << std::endl;
         assert(false);
-        return {};
+        return false;
     }
 
     // Get the task
@@ -109,40 +120,38 @@ GazeboEnvironment::step(const Action& action)
     if (!task) {
         gymppError << "Failed to get the Task interface from the plugin"
                    << std::endl;
-        return {};
+        return false;
     }
 
     if (!this->action_space->contains(action)) {
         gymppError << "The input action does not belong to the action space"
                    << std::endl;
-        return {};
+        return false;
     }
 
     // Set the action to the environment
     if (!task->setAction(action)) {
         gymppError << "Failed to set the action" << std::endl;
-        return {};
+        return false;
     }
 
     if (!this->run()) {
         gymppError << "Failed to step gazebo" << std::endl;
-        return {};
+        return false;
     }
 
-    // Get the observation from the environment
-    std::optional<Observation> observation = task->getObservation();
-
-    if (!observation) {
+    // Get the observation from the environment reusing the state buffers
+    if (!task->fillObservation(state.observation)) {
         gymppError << "The gympp plugin didn't return the observation"
                    << std::endl;
-        return {};
+        return false;
     }
 
-    if (!this->observation_space->contains(observation.value())) {
+    if (!this->observation_space->contains(state.observation)) {
         gymppError << "The returned observation does not belong to the "
                       "observation space"
                    << std::endl;
-        return {};
+        return false;
     }
 
     // Get the reward from the environment
@@ -150,17 +159,20 @@ GazeboEnvironment::step(const Action& action)
 
     if (!reward) {
         gymppError << "The gympp plugin didn't return the reward" << std::endl;
-        return {};
+        return false;
     }
 
     if (!this->reward_range.contains(reward.value())) {
         gymppError << "The returned reward (" << reward.value()
                    << ") does not belong to the reward space" << std::endl;
-        return {};
+        return false;
     }
 
-    return GazeboEnvironment::State{
-        task->isDone(), {}, reward.value(), observation.value()};
+    state.done = task->isDone();
+    state.info.clear();
+    state.reward = reward.value();
+
+    return true;
 }
 
 std::vector<size_t> GazeboEnvironment::seed(size_t seed)
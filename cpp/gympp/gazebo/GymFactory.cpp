@@ -131,10 +131,14 @@ GymFactory::Impl::makeSpace(const SpaceMetadata& md)
                 space =
                     std::make_shared<gympp::base::spaces::Box>(md.low, md.high);
             }
-            else {
+            else if (md.low.size() == 1) {
                 space = std::make_shared<gympp::base::spaces::Box>(
                     md.low[0], md.high[0], md.dims);
             }
+            else {
+                space = std::make_shared<gympp::base::spaces::Box>(
+                    md.low, md.high, md.dims);
+            }
             break;
         }
         case gympp::gazebo::SpaceType::Discrete: {
@@ -51,6 +51,7 @@ public:
     bool render(RenderMode mode) override;
     std::optional<Observation> reset() override;
     std::optional<State> step(const Action& action) override;
+    bool step(const Action& action, State& state) override;
     std::vector<size_t> seed(size_t seed = 0) override;
 
     base::EnvironmentPtr env();
@@ -106,8 +106,16 @@ private:
             }
         }
         else {
-            if (low.size() != 1) {
-                gymppError << "The limits must be scalar values" << std::endl;
+            size_t size = 1;
+
+            for (const auto dimension : dims) {
+                size *= dimension;
+            }
+
+            // Either scalar limits or one limit per element in row-major order
+            if (low.size() != 1 && low.size() != size) {
+                gymppError << "The limits must be scalar values or match the "
+                           << "number of elements of the space" << std::endl;
                 return false;
             }
         }
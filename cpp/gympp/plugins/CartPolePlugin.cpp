@@ -7,35 +7,18 @@
  */
 
 #include "CartPolePlugin.h"
-#include "gympp/base/Common.h"
 #include "gympp/base/Log.h"
 #include "gympp/base/Random.h"
-#include "gympp/base/TaskSingleton.h"
-#include "scenario/gazebo/Joint.h"
-#include "scenario/gazebo/Model.h"
-#include "scenario/plugins/gazebo/ECMSingleton.h"
-
-#include <ignition/gazebo/Model.hh>
-#include <ignition/gazebo/components/Model.hh>
-#include <ignition/gazebo/components/ParentEntity.hh>
+#include "scenario/core/Joint.h"
+
 #include <ignition/plugin/Register.hh>
 
-#include <cassert>
 #include <cmath>
-#include <mutex>
 #include <ostream>
 #include <random>
-#include <string>
 
 using namespace gympp::plugins;
 
-using ActionDataType = int;
-using ActionSample = gympp::base::BufferContainer<ActionDataType>::type;
-
-using ObservationDataType = double;
-using ObservationSample =
-    gympp::base::BufferContainer<ObservationDataType>::type;
-
 enum ObservationIndex
 {
     CartPosition = 0,
@@ -44,6 +27,12 @@ enum ObservationIndex
     PoleVelocity = 3,
 };
 
+enum JointIndex
+{
+    Linear = 0,
+    Pivot = 1,
+};
+
 const size_t MaxEpisodeLength = 20000;
 const double XThreshold = 2.4;
 const double ThetaThresholdDeg = 12;
@@ -60,15 +49,7 @@ enum CartPoleAction
 class CartPole::Impl
 {
 public:
-    unsigned seed;
-    mutable std::mutex mutex;
-
-    size_t iterations;
-    ObservationSample observationBuffer;
-    std::optional<CartPoleAction> action;
-
-    std::string modelName;
-    scenario::gazebo::ModelPtr model;
+    size_t iterations = 0;
 
     inline double getRandomThetaInRad()
     {
@@ -81,161 +62,66 @@ public:
 // CARTPOLE
 // ========
 
+// - Cart linear position [m]
+// - Cart linear velocity [m/s]
+// - Pole angular position [deg]
+// - Pole angular velocity [deg/s]
 CartPole::CartPole()
-    : System()
+    : TaskPlugin(1, 4, {"linear", "pivot"})
     , pImpl{new Impl()}
-{
-    // - Cart linear position [m]
-    // - Cart linear velocity [m/s]
-    // - Pole angular position [deg]
-    // - Pole angular velocity [deg/s]
-    pImpl->observationBuffer.resize(4);
-}
-
-CartPole::~CartPole()
-{
-    auto& taskSingleton = base::TaskSingleton::get();
+{}
 
-    if (pImpl->model && taskSingleton.hasTask(pImpl->modelName)
-        && !taskSingleton.removeTask(pImpl->modelName)) {
-        gymppError << "Failed to unregister the Task interface";
-        assert(false);
-    }
-}
+CartPole::~CartPole() = default;
 
-void CartPole::Configure(const ignition::gazebo::Entity& entity,
-                         const std::shared_ptr<const sdf::Element>& /*sdf*/,
-                         ignition::gazebo::EntityComponentManager& ecm,
-                         ignition::gazebo::EventManager& eventMgr)
+bool CartPole::applyAction(const std::vector<int>& action)
 {
-    pImpl->model = std::make_shared<scenario::gazebo::Model>();
-
-    if (!pImpl->model->initialize(entity, &ecm, &eventMgr)) {
-        gymppError << "Failed to initialize task's model" << std::endl;
-        assert(false);
-        return;
+    double appliedForce = 0;
+
+    switch (action[0]) {
+        case MOVE_LEFT:
+            appliedForce = AppliedForce;
+            break;
+        case MOVE_RIGHT:
+            appliedForce = -AppliedForce;
+            break;
+        case DONT_MOVE:
+            appliedForce = 0;
+            break;
+    }
+
+    if (!joint(Linear)->setGeneralizedForceTarget(appliedForce)) {
+        gymppError << "Failed to set the force to joint 'linear'" << std::endl;
+        return false;
     }
 
-    // Save the model name
-    pImpl->modelName = pImpl->model->name();
-
-    // Auto-register the task
-    gymppDebug << "Registering the Task interface for robot '"
-               << pImpl->modelName << "'" << std::endl;
-    auto& taskSingleton = base::TaskSingleton::get();
-
-    if (!taskSingleton.storeTask(pImpl->modelName,
-                                 dynamic_cast<gympp::base::Task*>(this))) {
-        gymppError << "Failed to register the Task interface";
-        assert(false);
-        return;
-    }
+    return true;
 }
 
-void CartPole::PreUpdate(const ignition::gazebo::UpdateInfo& info,
-                         ignition::gazebo::EntityComponentManager& /*ecm*/)
+void CartPole::updateObservation(double* observation)
 {
-    if (info.paused) {
-        return;
-    }
-
-    if (!pImpl->model) {
-        return;
-    }
-
-    if (!base::TaskSingleton::get().hasTask(pImpl->modelName)) {
-        return;
-    }
-
-    // Actuate the action
-    // ==================
-
-    {
-        std::lock_guard lock(pImpl->mutex);
-
-        if (pImpl->action) {
-            double appliedForce;
-
-            switch (*pImpl->action) {
-                case MOVE_LEFT:
-                    appliedForce = AppliedForce;
-                    break;
-                case MOVE_RIGHT:
-                    appliedForce = -AppliedForce;
-                    break;
-                case DONT_MOVE:
-                    appliedForce = 0;
-                    break;
-            }
-
-            // Reset the action. This allows to perform multiple simulator
-            // iterations for each environment step.
-            pImpl->action.reset();
-
-            scenario::gazebo::JointPtr linear =
-                pImpl->model->getJoint("linear");
-
-            if (!linear) {
-                gymppError << "Failed to get 'linear' joint" << std::endl;
-                return;
-            }
-
-            if (!linear->setGeneralizedForceTarget(appliedForce)) {
-                gymppError << "Failed to set the force to joint 'linear'"
-                           << std::endl;
-                return;
-            }
-        }
-    }
+    observation[CartPosition] = joint(Linear)->position();
+    observation[CartVelocity] = joint(Linear)->velocity();
+    observation[PolePosition] = (180.0 / M_PI) * joint(Pivot)->position();
+    observation[PoleVelocity] = (180.0 / M_PI) * joint(Pivot)->velocity();
 }
 
-void CartPole::PostUpdate(
-    const ignition::gazebo::UpdateInfo& info,
-    const ignition::gazebo::EntityComponentManager& /*manager*/)
+bool CartPole::validateAction(const std::vector<int>& action)
 {
-    if (info.paused) {
-        return;
-    }
-
-    if (!pImpl->model) {
-        return;
-    }
-
-    if (!base::TaskSingleton::get().hasTask(pImpl->modelName)) {
-        return;
-    }
-
-    auto pivot = pImpl->model->getJoint("pivot");
-    auto linear = pImpl->model->getJoint("linear");
-
-    double poleJointPosition = pivot->position();
-    double cartJointPosition = linear->position();
-
-    double poleJointVelocity = pivot->velocity();
-    double cartJointVelocity = linear->velocity();
+    // This method is called only once every iteration.
+    // It is the right place where to increase the counter.
+    pImpl->iterations++;
 
-    {
-        std::lock_guard lock(pImpl->mutex);
-        pImpl->observationBuffer[ObservationIndex::CartPosition] =
-            cartJointPosition;
-        pImpl->observationBuffer[ObservationIndex::CartVelocity] =
-            cartJointVelocity;
-        pImpl->observationBuffer[ObservationIndex::PolePosition] =
-            (180.0 / M_PI) * poleJointPosition;
-        pImpl->observationBuffer[ObservationIndex::PoleVelocity] =
-            (180.0 / M_PI) * poleJointVelocity;
-    }
+    return action[0] == MOVE_LEFT || action[0] == MOVE_RIGHT
+           || action[0] == DONT_MOVE;
 }
 
 bool CartPole::isDone()
 {
-    std::lock_guard lock(pImpl->mutex);
+    const auto& observationBuffer = observation();
 
     if (pImpl->iterations >= MaxEpisodeLength
-        || std::abs(pImpl->observationBuffer[ObservationIndex::PolePosition])
-               > ThetaThresholdDeg
-        || std::abs(pImpl->observationBuffer[ObservationIndex::CartPosition])
-               > XThreshold) {
+        || std::abs(observationBuffer[PolePosition]) > ThetaThresholdDeg
+        || std::abs(observationBuffer[CartPosition]) > XThreshold) {
         return true;
     }
 
@@ -244,7 +130,7 @@ bool CartPole::isDone()
 
 bool CartPole::resetTask()
 {
-    if (!pImpl->model) {
+    if (!model()) {
         return false;
     }
 
@@ -256,82 +142,39 @@ bool CartPole::resetTask()
     double v0 = 0.0;
     auto theta0 = pImpl->getRandomThetaInRad();
 
-    auto pivot = pImpl->model->getJoint("pivot");
-    auto linear = pImpl->model->getJoint("linear");
-
     // Reset the pendulum
-    if (!pivot->reset(theta0, v0)) {
+    if (!joint(Pivot)->reset(theta0, v0)) {
         gymppError << "Failed to reset the state of joint 'pivot'" << std::endl;
         return false;
     }
 
     // Reset the cart
-    if (!linear->reset(x0, v0)) {
+    if (!joint(Linear)->reset(x0, v0)) {
         gymppError << "Failed to reset the state of joint 'linear'"
                    << std::endl;
         return false;
     }
 
     // Set the control mode
-    if (!linear->setControlMode(scenario::base::JointControlMode::Force)) {
+    if (!joint(Linear)->setControlMode(
+            scenario::core::JointControlMode::Force)) {
         gymppError << "Failed to set the control mode" << std::endl;
         return false;
     }
 
-    {
-        // Update the observation. This is required because the
-        // Environment::reset() method returns the new observation.
-        std::lock_guard lock(pImpl->mutex);
-
-        pImpl->observationBuffer[ObservationIndex::CartPosition] = x0;
-        pImpl->observationBuffer[ObservationIndex::CartVelocity] = v0;
-        pImpl->observationBuffer[ObservationIndex::PolePosition] =
-            (180.0 / M_PI) * theta0;
-        pImpl->observationBuffer[ObservationIndex::PoleVelocity] = v0;
-    }
-
-    return true;
-}
-
-bool CartPole::setAction(const Task::Action& action)
-{
-    std::lock_guard lock(pImpl->mutex);
-
-    // This method is called only once every iteration.
-    // It is the right place where to increase the counter.
-    pImpl->iterations++;
-
-    assert(action.get<ActionDataType>(0));
-    ActionDataType actionValue = action.get<ActionDataType>(0).value();
-
-    if (actionValue == 0) {
-        pImpl->action = MOVE_LEFT;
-    }
-    else if (actionValue == 1) {
-        pImpl->action = MOVE_RIGHT;
-    }
-    else if (actionValue == 2) {
-        pImpl->action = DONT_MOVE;
-    }
-    else {
-        return false;
-    }
+    // Update the observation. This is required because the
+    // Environment::reset() method returns the new observation.
+    const double observation0[] = {x0, v0, (180.0 / M_PI) * theta0, v0};
+    publishObservation(observation0);
 
     return true;
 }
 
 std::optional<gympp::base::Task::Reward> CartPole::computeReward()
 {
-    std::lock_guard lock(pImpl->mutex);
     return 1.0;
 }
 
-std::optional<gympp::base::Task::Observation> CartPole::getObservation()
-{
-    std::lock_guard lock(pImpl->mutex);
-    return Observation(pImpl->observationBuffer);
-}
-
 IGNITION_ADD_PLUGIN(gympp::plugins::CartPole,
                     gympp::plugins::CartPole::System,
                     gympp::plugins::CartPole::ISystemConfigure,
@@ -9,16 +9,11 @@
 #ifndef GYMPP_PLUGINS_CARTPOLE
 #define GYMPP_PLUGINS_CARTPOLE
 
-#include "gympp/base/Task.h"
-
-#include <ignition/gazebo/Entity.hh>
-#include <ignition/gazebo/EntityComponentManager.hh>
-#include <ignition/gazebo/EventManager.hh>
-#include <ignition/gazebo/System.hh>
-#include <sdf/Element.hh>
+#include "gympp/plugins/TaskPlugin.h"
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace gympp {
     namespace plugins {
@@ -27,33 +22,20 @@ namespace gympp {
 } // namespace gympp
 
 class gympp::plugins::CartPole final
-    : public ignition::gazebo::System
-    , public ignition::gazebo::ISystemConfigure
-    , public ignition::gazebo::ISystemPreUpdate
-    , public ignition::gazebo::ISystemPostUpdate
-    , public gympp::base::Task
+    : public gympp::plugins::TaskPlugin<int, double>
 {
 public:
     CartPole();
     ~CartPole() override;
 
-    void Configure(const ignition::gazebo::Entity& entity,
-                   const std::shared_ptr<const sdf::Element>& sdf,
-                   ignition::gazebo::EntityComponentManager& ecm,
-                   ignition::gazebo::EventManager& eventMgr) override;
-
-    void PreUpdate(const ignition::gazebo::UpdateInfo& info,
-                   ignition::gazebo::EntityComponentManager& manager) override;
-
-    void PostUpdate(
-        const ignition::gazebo::UpdateInfo& info,
-        const ignition::gazebo::EntityComponentManager& manager) override;
-
     bool isDone() override;
     bool resetTask() override;
-    bool setAction(const Action& action) override;
     std::optional<Reward> computeReward() override;
-    std::optional<Observation> getObservation() override;
+
+protected:
+    bool applyAction(const std::vector<int>& action) override;
+    void updateObservation(double* observation) override;
+    bool validateAction(const std::vector<int>& action) override;
 
 private:
     class Impl;
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#ifndef GYMPP_PLUGINS_TASKPLUGIN_H
+#define GYMPP_PLUGINS_TASKPLUGIN_H
+
+#include "gympp/base/DoubleBuffer.h"
+#include "gympp/base/Log.h"
+#include "gympp/base/Task.h"
+#include "gympp/base/TaskSingleton.h"
+#include "scenario/gazebo/Joint.h"
+#include "scenario/gazebo/Model.h"
+
+#include <ignition/gazebo/Entity.hh>
+#include <ignition/gazebo/EntityComponentManager.hh>
+#include <ignition/gazebo/EventManager.hh>
+#include <ignition/gazebo/System.hh>
+#include <sdf/Element.hh>
+
+#include <cassert>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace gympp {
+    namespace plugins {
+        template <typename ActionType, typename ObservationType>
+        class TaskPlugin;
+    } // namespace plugins
+} // namespace gympp
+
+/**
+ * Base class of the Task plugins.
+ *
+ * The plugin runs in the simulator thread, while the methods of the Task
+ * interface are called by the environment thread. Actions and observations
+ * are exchanged through lock-free double buffers allocated when the plugin is
+ * created, and the joints are resolved once when the plugin is configured.
+ *
+ * Derived tasks implement:
+ *
+ * - ``applyAction``, called in the simulator thread before the physics step
+ *   only when a new action was set.
+ * - ``updateObservation``, called in the simulator thread after every
+ *   physics step.
+ * - ``isDone``, ``resetTask`` and ``computeReward``, called in the
+ *   environment thread. They can access the last observation with
+ *   ``observation()``.
+ *
+ * @note The resetTask method is called when the simulator is not stepping,
+ * therefore it can publish the initial observation with
+ * ``publishObservation``.
+ */
+template <typename ActionType, typename ObservationType>
+class gympp::plugins::TaskPlugin
+    : public ignition::gazebo::System
+    , public ignition::gazebo::ISystemConfigure
+    , public ignition::gazebo::ISystemPreUpdate
+    , public ignition::gazebo::ISystemPostUpdate
+    , public gympp::base::Task
+{
+public:
+    using JointPtr = std::shared_ptr<scenario::gazebo::Joint>;
+
+    /**
+     * Create the task.
+     *
+     * @param actionSize The number of elements of the action.
+     * @param observationSize The number of elements of the observation.
+     * @param jointNames The joints resolved when the plugin is configured,
+     * in the order used by ``joint``.
+     */
+    TaskPlugin(const size_t actionSize,
+               const size_t observationSize,
+               const std::vector<std::string>& jointNames)
+        : m_jointNames(jointNames)
+        , m_actions(actionSize)
+        , m_observations(observationSize)
+        , m_simAction(actionSize)
+        , m_envObservation(observationSize)
+    {}
+
+    ~TaskPlugin() override
+    {
+        if (!m_registered) {
+            return;
+        }
+
+        if (!base::TaskSingleton::get().removeTask(m_modelName)) {
+            gymppError << "Failed to unregister the Task interface";
+            assert(false);
+        }
+    }
+
+    void Configure(const ignition::gazebo::Entity& entity,
+                   const std::shared_ptr<const sdf::Element>& /*sdf*/,
+                   ignition::gazebo::EntityComponentManager& ecm,
+                   ignition::gazebo::EventManager& eventMgr) final
+    {
+        auto model = std::make_shared<scenario::gazebo::Model>();
+
+        if (!model->initialize(entity, &ecm, &eventMgr)) {
+            gymppError << "Failed to initialize task's model" << std::endl;
+            assert(false);
+            return;
+        }
+
+        // Resolve the joints once, the hot paths use the handles
+        for (const auto& jointName : m_jointNames) {
+            try {
+                m_joints.push_back(
+                    std::static_pointer_cast<scenario::gazebo::Joint>(
+                        model->getJoint(jointName)));
+            }
+            catch (const std::exception& e) {
+                gymppError << e.what() << std::endl;
+                m_joints.clear();
+                return;
+            }
+        }
+
+        m_model = model;
+        m_modelName = m_model->name();
+
+        // Auto-register the task
+        gymppDebug << "Registering the Task interface for robot '"
+                   << m_modelName << "'" << std::endl;
+
+        if (!base::TaskSingleton::get().storeTask(
+                m_modelName, static_cast<gympp::base::Task*>(this))) {
+            gymppError << "Failed to register the Task interface";
+            assert(false);
+            return;
+        }
+
+        m_registered = true;
+    }
+
+    void PreUpdate(const ignition::gazebo::UpdateInfo& info,
+                   ignition::gazebo::EntityComponentManager& /*ecm*/) final
+    {
+        if (info.paused || !m_registered) {
+            return;
+        }
+
+        // Actuate the action only once. This allows to perform multiple
+        // simulator iterations for each environment step.
+        if (m_actions.version() == m_appliedActionVersion) {
+            return;
+        }
+
+        m_appliedActionVersion = m_actions.read(m_simAction.data());
+
+        if (!applyAction(m_simAction)) {
+            gymppError << "Failed to apply the action" << std::endl;
+        }
+    }
+
+    void PostUpdate(const ignition::gazebo::UpdateInfo& info,
+                    const ignition::gazebo::EntityComponentManager& /*ecm*/)
+        final
+    {
+        if (info.paused || !m_registered) {
+            return;
+        }
+
+        m_observations.publish(
+            [this](ObservationType* data) { updateObservation(data); });
+    }
+
+    bool setAction(const Action& action) final
+    {
+        const auto* buffer = action.template getBuffer<ActionType>();
+
+        if (!buffer || buffer->size() != m_actions.size()) {
+            gymppError << "The action does not match the task" << std::endl;
+            return false;
+        }
+
+        if (!validateAction(*buffer)) {
+            return false;
+        }
+
+        m_actions.write(buffer->data());
+        return true;
+    }
+
+    std::optional<Observation> getObservation() final
+    {
+        return Observation(observation());
+    }
+
+    bool fillObservation(Observation& sample) final
+    {
+        auto data = sample.template resize<ObservationType>(
+            m_observations.size());
+        m_observations.read(data.data());
+        return true;
+    }
+
+protected:
+    /**
+     * Actuate a new action. Called in the simulator thread.
+     *
+     * @param action The action.
+     * @return True for success, false otherwise.
+     */
+    virtual bool applyAction(const std::vector<ActionType>& action) = 0;
+
+    /**
+     * Fill the observation. Called in the simulator thread.
+     *
+     * @param observation Pointer to the elements of the observation.
+     */
+    virtual void updateObservation(ObservationType* observation) = 0;
+
+    /**
+     * Validate an action before storing it. Called in the environment thread.
+     *
+     * @param action The action.
+     * @return True if the action is valid, false otherwise.
+     */
+    virtual bool validateAction(const std::vector<ActionType>& /*action*/)
+    {
+        return true;
+    }
+
+    /**
+     * Get the last observation. Called in the environment thread.
+     *
+     * @return The observation.
+     */
+    const std::vector<ObservationType>& observation()
+    {
+        m_observations.read(m_envObservation.data());
+        return m_envObservation;
+    }
+
+    /**
+     * Publish an observation outside the simulator steps, e.g. when the
+     * task is reset.
+     *
+     * @param observation Pointer to the elements of the observation.
+     */
+    void publishObservation(const ObservationType* observation)
+    {
+        m_observations.write(observation);
+    }
+
+    const JointPtr& joint(const size_t index) const
+    {
+        return m_joints[index];
+    }
+
+    const std::shared_ptr<scenario::gazebo::Model>& model() const
+    {
+        return m_model;
+    }
+
+private:
+    bool m_registered = false;
+    std::string m_modelName;
+    std::vector<std::string> m_jointNames;
+
+    std::shared_ptr<scenario::gazebo::Model> m_model;
+    std::vector<JointPtr> m_joints;
+
+    base::DoubleBuffer<ActionType> m_actions;
+    base::DoubleBuffer<ObservationType> m_observations;
+
+    // Buffers owned by the simulator and environment threads
+    std::vector<ActionType> m_simAction;
+    std::vector<ObservationType> m_envObservation;
+    uint64_t m_appliedActionVersion = 0;
+};
+
+#endif // GYMPP_PLUGINS_TASKPLUGIN_H
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#include "gympp/base/Common.h"
+#include "gympp/base/Environment.h"
+#include "gympp/base/Log.h"
+#include "gympp/gazebo/GymFactory.h"
+#include "gympp/plugins/PluginDatabase.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace gympp::base;
+
+// Stepping repeatedly into the same state must reuse its buffers
+int main()
+{
+    auto env = gympp::gazebo::GymFactory::Instance()->make("CartPole");
+
+    if (!env) {
+        gymppError << "Failed to load the CartPole environment" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    env->seed(42);
+
+    if (!env->reset()) {
+        gymppError << "Failed to reset the environment" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const Environment::Action action(std::vector<int>{0});
+    Environment::State state;
+
+    // The first step allocates the buffer of the observation
+    if (!env->step(action, state)) {
+        gymppError << "Failed to step the environment" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto* buffer = state.observation.getBuffer<double>();
+
+    if (!buffer || buffer->empty()) {
+        gymppError << "The state does not contain the observation"
+                   << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const double* const data = buffer->data();
+    const size_t capacity = buffer->capacity();
+
+    for (size_t i = 0; i < 100 && !state.done; ++i) {
+        if (!env->step(action, state)) {
+            gymppError << "Failed to step the environment" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        buffer = state.observation.getBuffer<double>();
+
+        if (!buffer || buffer->data() != data
+            || buffer->capacity() != capacity) {
+            gymppError << "The buffer of the observation was reallocated"
+                       << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#include "gympp/base/Common.h"
+#include "gympp/base/Log.h"
+#include "gympp/base/Task.h"
+
+#include <cstdlib>
+#include <optional>
+#include <vector>
+
+using namespace gympp::base;
+
+// Task that only implements the copying API
+class CopyingTask final : public Task
+{
+public:
+    bool isDone() override { return false; }
+    bool resetTask() override { return true; }
+    bool setAction(const Action& /*action*/) override { return true; }
+    std::optional<Reward> computeReward() override { return 0; }
+
+    std::optional<Observation> getObservation() override
+    {
+        return Observation(observation);
+    }
+
+    std::vector<double> observation = {1.0, 2.0, 3.0};
+};
+
+// The default fillObservation must work for tasks that do not override it
+int main()
+{
+    CopyingTask task;
+
+    // The sample initially stores a buffer of a different type
+    Task::Observation sample(std::vector<int>{42});
+
+    for (const double value : {0.0, 10.0}) {
+        for (auto& element : task.observation) {
+            element += value;
+        }
+
+        if (!task.fillObservation(sample)) {
+            gymppError << "Failed to fill the observation" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto* buffer = sample.getBuffer<double>();
+
+        if (!buffer || *buffer != task.observation) {
+            gymppError << "The filled observation does not match the task"
+                       << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#ifndef SCENARIO_CONTROLLERS_COMPUTEDTORQUEFLOATINGBASE_H
+#define SCENARIO_CONTROLLERS_COMPUTEDTORQUEFLOATINGBASE_H
+
+#include "scenario/controllers/Controller.h"
+#include "scenario/controllers/References.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace scenario::core {
+    class Model;
+} // namespace scenario::core
+
+namespace scenario::controllers {
+    class ComputedTorqueFloatingBase;
+} // namespace scenario::controllers
+
+/**
+ * Inverse dynamics controller of floating-base robots.
+ *
+ * The desired joint accelerations are computed with a PD law on the joint
+ * references. The base is not actuated: its acceleration is the one that
+ * the desired joint accelerations produce according to the base rows of the
+ * floating-base dynamics. The joint torques are the joint rows of the
+ * inverse dynamics of the resulting accelerations. The contact forces are
+ * not compensated.
+ *
+ * The floating base of the dynamics is the base frame of the model.
+ */
+class scenario::controllers::ComputedTorqueFloatingBase final
+    : public scenario::controllers::Controller
+    , public scenario::controllers::UseScenarioModel
+    , public scenario::controllers::SetJointReferences
+{
+public:
+    ComputedTorqueFloatingBase() = delete;
+    ComputedTorqueFloatingBase(const std::string& urdfFile,
+                               std::shared_ptr<core::Model> model,
+                               const std::vector<double>& kp,
+                               const std::vector<double>& kd,
+                               const std::vector<std::string>& controlledJoints,
+                               const std::array<double, 3> gravity = g);
+    ~ComputedTorqueFloatingBase() override;
+
+    bool initialize() override;
+    bool step(const StepSize& dt) override;
+    bool terminate() override;
+
+    bool updateStateFromModel() override;
+
+    const std::vector<std::string>& controlledJoints() override;
+    bool setJointReferences(const JointReferences& jointReferences) override;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // SCENARIO_CONTROLLERS_COMPUTEDTORQUEFLOATINGBASE_H
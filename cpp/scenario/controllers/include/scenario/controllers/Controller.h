@@ -21,6 +21,7 @@ namespace scenario::controllers {
     class UseScenarioModel;
     class SetBaseReferences;
     class SetJointReferences;
+    class GetJointReferences;
     using ControllerPtr = std::shared_ptr<Controller>;
     constexpr std::array<double, 3> g = {0, 0, -9.80665};
 } // namespace scenario::controllers
@@ -78,4 +79,15 @@ protected:
     std::vector<std::string> m_controlledJoints;
 };
 
+class scenario::controllers::GetJointReferences
+{
+public:
+    GetJointReferences() = default;
+    virtual ~GetJointReferences() = default;
+
+    // Joint references computed by the last step. They are the input of the
+    // controllers chained to this one.
+    virtual const JointReferences& outputJointReferences() = 0;
+};
+
 #endif // SCENARIO_CONTROLLERS_CONTROLLER_H
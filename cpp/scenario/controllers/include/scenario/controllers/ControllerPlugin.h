@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#ifndef SCENARIO_CONTROLLERS_CONTROLLERPLUGIN_H
+#define SCENARIO_CONTROLLERS_CONTROLLERPLUGIN_H
+
+#include "scenario/controllers/Controller.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace scenario::controllers {
+    class ControllerPlugin;
+    struct ParameterInfo;
+    struct Parameters;
+    enum class ParameterType
+    {
+        String,
+        StringList,
+        Double,
+        DoubleList,
+    };
+} // namespace scenario::controllers
+
+/**
+ * Description of a parameter accepted by a controller plugin.
+ *
+ * The parameter is read from the element of the controller context with the
+ * same name, e.g. <kp>10 10 10</kp>.
+ */
+struct scenario::controllers::ParameterInfo
+{
+    std::string name;
+    ParameterType type = ParameterType::String;
+    bool required = true;
+
+    // Expected number of elements of list parameters, 0 accepts any size
+    size_t size = 0;
+};
+
+/**
+ * Parameters parsed from the controller context.
+ *
+ * Each parameter of the schema is stored in the map of its type.
+ * Parameters that are not required and are missing from the context
+ * are not stored.
+ */
+struct scenario::controllers::Parameters
+{
+    std::unordered_map<std::string, std::string> strings;
+    std::unordered_map<std::string, std::vector<std::string>> stringLists;
+    std::unordered_map<std::string, double> doubles;
+    std::unordered_map<std::string, std::vector<double>> doubleLists;
+};
+
+/**
+ * Factory of a controller that can be loaded from a shared library.
+ *
+ * Custom controllers are registered with ignition-plugin and are
+ * instantiated by the ControllerRunner plugin:
+ *
+ * @code
+ * #include <ignition/plugin/Register.hh>
+ *
+ * IGNITION_ADD_PLUGIN(MyControllerPlugin,
+ *                     scenario::controllers::ControllerPlugin)
+ * @endcode
+ *
+ * The controller is selected by its name. The library is passed in the
+ * filename attribute of the context, and it is searched in the
+ * IGN_GAZEBO_SYSTEM_PLUGIN_PATH folders:
+ *
+ * @code
+ * <controller name="MyController" filename="libMyController.so">
+ *     <kp>10 10 10</kp>
+ * </controller>
+ * @endcode
+ */
+class scenario::controllers::ControllerPlugin
+{
+public:
+    ControllerPlugin() = default;
+    virtual ~ControllerPlugin() = default;
+
+    /**
+     * Get the name of the controller.
+     *
+     * @return The name matched with the name attribute of the context.
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * Get the schema of the parameters of the controller.
+     *
+     * @return The parameters parsed from the context before creating the
+     * controller.
+     */
+    virtual std::vector<ParameterInfo> parameters() const = 0;
+
+    /**
+     * Create a new controller.
+     *
+     * @param parameters The parameters parsed with the schema of the plugin.
+     * @param model The model to control.
+     * @return The controller if it was created successfully, nullptr
+     * otherwise.
+     */
+    virtual ControllerPtr create(const Parameters& parameters,
+                                 core::ModelPtr model) const = 0;
+};
+
+#endif // SCENARIO_CONTROLLERS_CONTROLLERPLUGIN_H
@@ -43,6 +43,10 @@ public:
 
     JointReferences jointReferences;
     std::unique_ptr<Buffers> buffers;
+
+    // Handles of the controlled joints, resolved once during initialization
+    // so that the control loop does not perform any lookup by name
+    std::vector<core::JointPtr> joints;
     std::unique_ptr<iDynTree::KinDynComputations> kinDyn;
 
     static Eigen::Map<Eigen::VectorXd> toEigen(std::vector<double>& vector)
@@ -67,8 +71,6 @@ public:
         dds_star = Eigen::VectorXd(controlledDofs);
         positionError = Eigen::VectorXd(controlledDofs);
         velocityError = Eigen::VectorXd(controlledDofs);
-
-        torquesVector.reserve(controlledDofs);
     }
 
     iDynTree::Vector3 gravity = {g.data(), 3};
@@ -84,8 +86,6 @@ public:
     Eigen::VectorXd dds_star;
     Eigen::VectorXd positionError;
     Eigen::VectorXd velocityError;
-
-    std::vector<double> torquesVector;
 };
 
 ComputedTorqueFixedBase::ComputedTorqueFixedBase(
@@ -149,7 +149,9 @@ bool ComputedTorqueFixedBase::initialize()
         m_controlledJoints = m_model->jointNames();
     }
 
-    for (auto& joint : m_model->joints(m_controlledJoints)) {
+    pImpl->joints = m_model->joints(m_controlledJoints);
+
+    for (auto& joint : pImpl->joints) {
         if (joint->dofs() != 1) {
             sError << "Joint '" << joint->name()
                    << "' does not have 1 DoF and is not supported" << std::endl;
@@ -175,7 +177,7 @@ bool ComputedTorqueFixedBase::initialize()
     }
 
     // Set controlled joints in torque control mode
-    for (auto& joint : m_model->joints(m_controlledJoints)) {
+    for (auto& joint : pImpl->joints) {
         pImpl->initialValues.controlMode[joint->name()] = joint->controlMode();
 
         if (!joint->setControlMode(core::JointControlMode::Force)) {
@@ -254,17 +256,22 @@ bool ComputedTorqueFixedBase::step(const Controller::StepSize& /*dt*/)
     // Compute the acceleration
     dds_star = dds_ref.array() - kp * s_tilde.array() - kd * ds_tilde.array();
 
-    // Compute the torque
-    tau = M * dds_star + h;
+    // Compute the torque.
+    // The product does not alias its operands, this prevents Eigen from
+    // allocating a temporary at every step.
+    tau.noalias() = M * dds_star;
+    tau += h;
 
-    pImpl->buffers->torquesVector = std::vector<double>(
-        pImpl->buffers->torques.data(),
-        pImpl->buffers->torques.data() + pImpl->buffers->torques.size());
+    // Write the torques directly from the Eigen buffer through the
+    // pre-resolved joint handles
+    assert(pImpl->joints.size() == nrControlledDofs);
 
-    if (!m_model->setJointGeneralizedForceTargets(pImpl->buffers->torquesVector,
-                                                  m_controlledJoints)) {
-        sError << "Failed to set joint forces" << std::endl;
-        return false;
+    for (unsigned i = 0; i < pImpl->joints.size(); ++i) {
+        if (!pImpl->joints[i]->setGeneralizedForceTarget(tau[i])) {
+            sError << "Failed to set the force of joint '"
+                   << m_controlledJoints[i] << "'" << std::endl;
+            return false;
+        }
     }
 
     return true;
@@ -286,6 +293,7 @@ bool ComputedTorqueFixedBase::terminate()
         }
     }
 
+    pImpl->joints.clear();
     pImpl->kinDyn.reset();
     pImpl->buffers.reset();
     return ok;
@@ -293,20 +301,19 @@ bool ComputedTorqueFixedBase::terminate()
 
 bool ComputedTorqueFixedBase::updateStateFromModel()
 {
-    assert(m_model->jointPositions(m_controlledJoints).size()
-           == pImpl->buffers->jointPositions.size());
-    assert(m_model->jointVelocities(m_controlledJoints).size()
-           == pImpl->buffers->jointVelocities.size());
-
-    for (unsigned i = 0; i < m_controlledJoints.size(); ++i) {
-        // Get the joint
-        const auto& jointName = m_controlledJoints[i];
-        auto joint = m_model->getJoint(jointName);
+    assert(pImpl->joints.size() == pImpl->buffers->jointPositions.size());
+    assert(pImpl->joints.size() == pImpl->buffers->jointVelocities.size());
+
+    // Write the state directly in the raw storage of the iDynTree buffers
+    double* const positions = pImpl->buffers->jointPositions.data();
+    double* const velocities = pImpl->buffers->jointVelocities.data();
+
+    for (unsigned i = 0; i < pImpl->joints.size(); ++i) {
+        const auto& joint = pImpl->joints[i];
         assert(joint->dofs() == 1);
 
-        // Update the buffers
-        pImpl->buffers->jointPositions.setVal(i, joint->position());
-        pImpl->buffers->jointVelocities.setVal(i, joint->velocity());
+        positions[i] = joint->position();
+        velocities[i] = joint->velocity();
     }
 
     if (!pImpl->kinDyn->setRobotState(pImpl->buffers->jointPositions,
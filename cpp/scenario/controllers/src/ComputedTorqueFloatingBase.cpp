@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#include "scenario/controllers/ComputedTorqueFloatingBase.h"
+#include "scenario/controllers/References.h"
+#include "scenario/core/Joint.h"
+#include "scenario/core/Model.h"
+#include "scenario/core/utils/Log.h"
+
+#include <Eigen/Dense>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/Position.h>
+#include <iDynTree/Core/Rotation.h>
+#include <iDynTree/Core/Transform.h>
+#include <iDynTree/Core/Twist.h>
+#include <iDynTree/Core/VectorDynSize.h>
+#include <iDynTree/Core/VectorFixSize.h>
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/Model/FreeFloatingState.h>
+#include <iDynTree/ModelIO/ModelLoader.h>
+
+#include <cassert>
+#include <unordered_map>
+
+using namespace scenario::controllers;
+
+class ComputedTorqueFloatingBase::Impl
+{
+public:
+    class Buffers;
+
+    std::string urdfFile;
+
+    struct
+    {
+        std::vector<double> kp;
+        std::vector<double> kd;
+        std::array<double, 3> gravity;
+        std::unordered_map<std::string, core::JointControlMode> controlMode;
+    } initialValues;
+
+    JointReferences jointReferences;
+    std::unique_ptr<Buffers> buffers;
+    std::unique_ptr<iDynTree::KinDynComputations> kinDyn;
+
+    // Handles of the controlled joints, resolved once during initialization
+    // so that the control loop does not perform any lookup by name
+    std::vector<core::JointPtr> joints;
+
+    static Eigen::Map<Eigen::VectorXd> toEigen(std::vector<double>& vector)
+    {
+        return {vector.data(), Eigen::Index(vector.size())};
+    }
+};
+
+class ComputedTorqueFloatingBase::Impl::Buffers
+{
+public:
+    Buffers(const unsigned controlledDofs = 0)
+    {
+        jointPositions.resize(controlledDofs);
+        jointVelocities.resize(controlledDofs);
+        massMatrix.resize(controlledDofs + 6, controlledDofs + 6);
+
+        kp = Eigen::ArrayXd(controlledDofs);
+        kd = Eigen::ArrayXd(controlledDofs);
+
+        torques = Eigen::VectorXd(controlledDofs);
+        dds_star = Eigen::VectorXd(controlledDofs);
+        positionError = Eigen::VectorXd(controlledDofs);
+        velocityError = Eigen::VectorXd(controlledDofs);
+    }
+
+    iDynTree::Vector3 gravity = {g.data(), 3};
+    iDynTree::MatrixDynSize massMatrix;
+    iDynTree::VectorDynSize jointPositions;
+    iDynTree::VectorDynSize jointVelocities;
+    iDynTree::FreeFloatingGeneralizedTorques biasForces;
+
+    // Base state in mixed representation
+    iDynTree::Transform world_H_base;
+    iDynTree::Twist baseVelocity;
+
+    Eigen::ArrayXd kp;
+    Eigen::ArrayXd kd;
+
+    Eigen::VectorXd torques;
+    Eigen::VectorXd dds_star;
+    Eigen::VectorXd positionError;
+    Eigen::VectorXd velocityError;
+
+    // Fixed-size buffers of the unactuated base dynamics
+    Eigen::Matrix<double, 6, 1> baseBias;
+    Eigen::Matrix<double, 6, 1> baseAcceleration;
+    Eigen::LDLT<Eigen::Matrix<double, 6, 6>> baseMassMatrix;
+};
+
+ComputedTorqueFloatingBase::ComputedTorqueFloatingBase(
+    const std::string& urdfFile,
+    std::shared_ptr<core::Model> model,
+    const std::vector<double>& kp,
+    const std::vector<double>& kd,
+    const std::vector<std::string>& controlledJoints,
+    const std::array<double, 3> gravity)
+    : Controller()
+    , UseScenarioModel()
+    , SetJointReferences()
+    , pImpl{std::make_unique<Impl>()}
+{
+    m_model = model;
+    pImpl->urdfFile = urdfFile;
+    m_controlledJoints = controlledJoints;
+
+    pImpl->initialValues.gravity = gravity;
+
+    pImpl->initialValues.kp = kp;
+    pImpl->initialValues.kd = kd;
+    assert(kp.size() == kd.size());
+}
+
+ComputedTorqueFloatingBase::~ComputedTorqueFloatingBase() = default;
+
+bool ComputedTorqueFloatingBase::initialize()
+{
+    sDebug << "Initializing ComputedTorqueFloatingBase" << std::endl;
+
+    if (pImpl->kinDyn) {
+        sWarning << "The KinDynComputations object has been already initialized"
+                 << std::endl;
+        return true;
+    }
+
+    if (!(m_model && m_model->valid())) {
+        sError << "Couldn't initialize controller. Model not valid."
+               << std::endl;
+        return false;
+    }
+
+    if (m_controlledJoints.empty()) {
+        sDebug << "No list of controlled joints. Controlling all the "
+                  "robots joints."
+               << std::endl;
+
+        // Read the joint names from the robot object.
+        // This is useful to use the same joint serialization in the vectorized
+        // methods.
+        m_controlledJoints = m_model->jointNames();
+    }
+
+    if (pImpl->initialValues.kp.size() != m_controlledJoints.size()
+        || pImpl->initialValues.kd.size() != m_controlledJoints.size()) {
+        sError << "The gains do not match the number of controlled joints"
+               << std::endl;
+        return false;
+    }
+
+    pImpl->joints = m_model->joints(m_controlledJoints);
+
+    for (auto& joint : pImpl->joints) {
+        if (joint->dofs() != 1) {
+            sError << "Joint '" << joint->name()
+                   << "' does not have 1 DoF and is not supported" << std::endl;
+            return false;
+        }
+    }
+
+    iDynTree::ModelLoader loader;
+    if (!loader.loadReducedModelFromFile(pImpl->urdfFile, m_controlledJoints)) {
+        sError << "Failed to load reduced model from the urdf file"
+               << std::endl;
+        return false;
+    }
+
+    pImpl->kinDyn = std::make_unique<iDynTree::KinDynComputations>();
+    pImpl->kinDyn->setFrameVelocityRepresentation(
+        iDynTree::MIXED_REPRESENTATION);
+
+    if (!pImpl->kinDyn->loadRobotModel(loader.model())) {
+        sError << "Failed to insert model in the KinDynComputations object"
+               << std::endl;
+        return false;
+    }
+
+    // The base state read from the model refers to its base frame
+    if (!pImpl->kinDyn->setFloatingBase(m_model->baseFrame())) {
+        sError << "Failed to set the floating base '" << m_model->baseFrame()
+               << "'" << std::endl;
+        return false;
+    }
+
+    // Set controlled joints in torque control mode
+    for (auto& joint : pImpl->joints) {
+        pImpl->initialValues.controlMode[joint->name()] = joint->controlMode();
+
+        if (!joint->setControlMode(core::JointControlMode::Force)) {
+            sError << "Failed to control joint '" << joint->name()
+                   << "' in Force" << std::endl;
+            return false;
+        }
+    }
+
+    // Initialize buffers
+    sDebug << "Controlling " << m_controlledJoints.size() << " DoFs"
+           << std::endl;
+    pImpl->buffers = std::make_unique<Impl::Buffers>(m_controlledJoints.size());
+
+    pImpl->buffers->kp = Impl::toEigen(pImpl->initialValues.kp);
+    pImpl->buffers->kd = Impl::toEigen(pImpl->initialValues.kd);
+    pImpl->buffers->biasForces.resize(loader.model());
+
+    // Set the gravity
+    pImpl->buffers->gravity[0] = pImpl->initialValues.gravity[0];
+    pImpl->buffers->gravity[1] = pImpl->initialValues.gravity[1];
+    pImpl->buffers->gravity[2] = pImpl->initialValues.gravity[2];
+
+    return true;
+}
+
+bool ComputedTorqueFloatingBase::step(const Controller::StepSize& /*dt*/)
+{
+    // ===================
+    // Intermediate Values
+    // ===================
+
+    auto& buffers = *pImpl->buffers;
+    const auto nrControlledDofs = buffers.jointPositions.size();
+
+    auto M = iDynTree::toEigen(buffers.massMatrix);
+    auto h = iDynTree::toEigen(buffers.biasForces.jointTorques());
+    assert(h.size() == nrControlledDofs);
+    assert(M.rows() == nrControlledDofs + 6);
+
+    auto s = iDynTree::toEigen(buffers.jointPositions);
+    auto ds = iDynTree::toEigen(buffers.jointVelocities);
+
+    auto s_ref = Impl::toEigen(pImpl->jointReferences.position);
+    auto ds_ref = Impl::toEigen(pImpl->jointReferences.velocity);
+    auto dds_ref = Impl::toEigen(pImpl->jointReferences.acceleration);
+    assert(s_ref.size() == nrControlledDofs);
+    assert(ds_ref.size() == nrControlledDofs);
+    assert(dds_ref.size() == nrControlledDofs);
+
+    auto& tau = buffers.torques;
+    auto& dds_star = buffers.dds_star;
+    auto& s_tilde = buffers.positionError;
+    auto& ds_tilde = buffers.velocityError;
+    auto& dv_base = buffers.baseAcceleration;
+    auto& h_base = buffers.baseBias;
+
+    // ===========
+    // Control Law
+    // ===========
+
+    // Compute the joint errors
+    s_tilde = s - s_ref;
+    ds_tilde = ds - ds_ref;
+
+    // Compute the desired joint accelerations
+    dds_star.array() = dds_ref.array() - buffers.kp * s_tilde.array()
+                       - buffers.kd * ds_tilde.array();
+
+    // The base is not actuated. Its rows of the dynamics give the base
+    // acceleration produced by the desired joint accelerations:
+    //
+    //     M_bb * dv_base + M_bs * dds_star + h_base = 0
+    //
+    // The products do not alias their operands, this prevents Eigen from
+    // allocating temporaries at every step.
+    h_base.noalias() = M.topRightCorner(6, nrControlledDofs) * dds_star;
+    h_base += iDynTree::toEigen(buffers.biasForces.baseWrench());
+
+    buffers.baseMassMatrix.compute(M.topLeftCorner<6, 6>());
+    dv_base = -buffers.baseMassMatrix.solve(h_base);
+
+    // Compute the torques from the joint rows of the dynamics
+    tau.noalias() = M.bottomLeftCorner(nrControlledDofs, 6) * dv_base;
+    tau.noalias() += M.bottomRightCorner(nrControlledDofs, nrControlledDofs)
+                     * dds_star;
+    tau += h;
+
+    // Write the torques directly from the Eigen buffer through the
+    // pre-resolved joint handles
+    assert(pImpl->joints.size() == nrControlledDofs);
+
+    for (unsigned i = 0; i < pImpl->joints.size(); ++i) {
+        if (!pImpl->joints[i]->setGeneralizedForceTarget(tau[i])) {
+            sError << "Failed to set the force of joint '"
+                   << m_controlledJoints[i] << "'" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ComputedTorqueFloatingBase::terminate()
+{
+    bool ok = true;
+
+    for (const auto& [jointName, controlMode] :
+         pImpl->initialValues.controlMode) {
+
+        auto joint = m_model->getJoint(jointName);
+
+        if (!joint->setControlMode(controlMode)) {
+            sError << "Failed to restore original control mode of joint '"
+                   << jointName << "'" << std::endl;
+            ok = ok && false;
+        }
+    }
+
+    pImpl->joints.clear();
+    pImpl->kinDyn.reset();
+    pImpl->buffers.reset();
+    return ok;
+}
+
+bool ComputedTorqueFloatingBase::updateStateFromModel()
+{
+    auto& buffers = *pImpl->buffers;
+
+    assert(pImpl->joints.size() == buffers.jointPositions.size());
+    assert(pImpl->joints.size() == buffers.jointVelocities.size());
+
+    // Write the state directly in the raw storage of the iDynTree buffers
+    double* const positions = buffers.jointPositions.data();
+    double* const velocities = buffers.jointVelocities.data();
+
+    for (unsigned i = 0; i < pImpl->joints.size(); ++i) {
+        const auto& joint = pImpl->joints[i];
+        assert(joint->dofs() == 1);
+
+        positions[i] = joint->position();
+        velocities[i] = joint->velocity();
+    }
+
+    // Read the base state from the model
+    const auto position = m_model->basePosition();
+    const auto orientation = m_model->baseOrientation();
+    const auto linearVelocity = m_model->baseWorldLinearVelocity();
+    const auto angularVelocity = m_model->baseWorldAngularVelocity();
+
+    buffers.world_H_base.setPosition(
+        iDynTree::Position(position[0], position[1], position[2]));
+    buffers.world_H_base.setRotation(iDynTree::Rotation::RotationFromQuaternion(
+        iDynTree::Vector4(orientation.data(), 4)));
+
+    buffers.baseVelocity =
+        iDynTree::Twist(iDynTree::LinVelocity(linearVelocity.data(), 3),
+                        iDynTree::AngVelocity(angularVelocity.data(), 3));
+
+    if (!pImpl->kinDyn->setRobotState(buffers.world_H_base,
+                                      buffers.jointPositions,
+                                      buffers.baseVelocity,
+                                      buffers.jointVelocities,
+                                      buffers.gravity)) {
+        sError << "Failed to set the robot state" << std::endl;
+        return false;
+    }
+
+    if (!pImpl->kinDyn->getFreeFloatingMassMatrix(buffers.massMatrix)) {
+        sError << "Failed to get the mass matrix" << std::endl;
+        return false;
+    }
+
+    if (!pImpl->kinDyn->generalizedBiasForces(buffers.biasForces)) {
+        sError << "Failed to get the bias forces " << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+const std::vector<std::string>& ComputedTorqueFloatingBase::controlledJoints()
+{
+    return m_controlledJoints;
+}
+
+bool ComputedTorqueFloatingBase::setJointReferences(
+    const JointReferences& jointReferences)
+{
+    pImpl->jointReferences = jointReferences;
+    return pImpl->jointReferences.valid();
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#include "scenario/controllers/ComputedTorqueFixedBase.h"
+#include "scenario/controllers/References.h"
+#include "scenario/core/Model.h"
+#include "scenario/core/utils/Log.h"
+#include "scenario/gazebo/GazeboSimulator.h"
+#include "scenario/gazebo/World.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The allocator of glibc, wrapped by the counting functions below
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t nmemb, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+}
+
+namespace {
+    // Only the allocations of the thread running the controller are counted,
+    // the threads of the simulator could allocate meanwhile
+    thread_local bool counting = false;
+    thread_local size_t allocations = 0;
+} // namespace
+
+// Defined in the executable, they replace the functions of glibc also for
+// the shared libraries. The operator new of libstdc++ and the dynamic
+// buffers of Eigen are allocated through them.
+extern "C" void* malloc(size_t size)
+{
+    allocations += counting ? 1 : 0;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t nmemb, size_t size)
+{
+    allocations += counting ? 1 : 0;
+    return __libc_calloc(nmemb, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+    allocations += counting ? 1 : 0;
+    return __libc_realloc(ptr, size);
+}
+
+using namespace scenario;
+
+// The control loop of the controller must not allocate after its first cycle
+int main()
+{
+    const std::string urdfFile = URDF_FILE;
+    const controllers::Controller::StepSize dt(0.001);
+
+    gazebo::GazeboSimulator simulator(dt.count(), 1.0, 1);
+
+    if (!simulator.insertWorldFromSDF() || !simulator.initialize()) {
+        sError << "Failed to initialize the simulator" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto world =
+        std::static_pointer_cast<gazebo::World>(simulator.getWorld());
+
+    if (!world->setPhysicsEngine(gazebo::PhysicsEngine::Dart)
+        || !world->insertModel(urdfFile, core::Pose::Identity(), "pendulum")
+        || !simulator.run()) {
+        sError << "Failed to insert the model" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<std::string> joints = {"shoulder", "elbow"};
+
+    controllers::ComputedTorqueFixedBase controller(
+        urdfFile, world->getModel("pendulum"), {10, 10}, {3, 3}, joints);
+
+    controllers::JointReferences references(joints.size());
+    references.position = {0.5, -0.5};
+
+    if (!controller.initialize()
+        || !controller.setJointReferences(references)) {
+        sError << "Failed to initialize the controller" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The first cycle could create the components of the force targets
+    if (!controller.updateStateFromModel() || !controller.step(dt)) {
+        sError << "Failed to step the controller" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < 100; ++i) {
+        // The physics changes the state read by the next cycle
+        if (!simulator.run()) {
+            sError << "Failed to run the simulator" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        counting = true;
+        const bool ok = controller.updateStateFromModel() //
+                        && controller.step(dt);
+        counting = false;
+
+        if (!ok) {
+            sError << "Failed to step the controller" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (allocations != 0) {
+            sError << "The control cycle #" << i << " performed "
+                   << allocations << " allocations" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!controller.terminate()) {
+        sError << "Failed to terminate the controller" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#ifndef SCENARIO_CORE_UTILS_THREADPOOL_H
+#define SCENARIO_CORE_UTILS_THREADPOOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace scenario::core::utils {
+    class ThreadPool;
+} // namespace scenario::core::utils
+
+/**
+ * Fixed-size pool of threads executing indexed tasks.
+ *
+ * The threads are created once and are kept alive until the pool is
+ * destroyed. The calling thread takes part in the execution, therefore a
+ * pool with a single thread executes the tasks sequentially without any
+ * synchronization overhead.
+ */
+class scenario::core::utils::ThreadPool
+{
+public:
+    using Task = std::function<void(const size_t index)>;
+
+    /**
+     * Create the pool.
+     *
+     * @param numOfThreads The number of threads, including the calling one.
+     * If zero, the hardware concurrency is used.
+     */
+    ThreadPool(const size_t numOfThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Get the number of threads of the pool, including the calling one.
+     *
+     * @return The number of threads.
+     */
+    size_t numOfThreads() const;
+
+    /**
+     * Execute a task for all indices in [0, numOfTasks).
+     *
+     * The method blocks until all the tasks are completed. The order of
+     * execution of the tasks is not specified.
+     *
+     * @param numOfTasks The number of tasks.
+     * @param task The callable executed for each index.
+     */
+    void parallelFor(const size_t numOfTasks, const Task& task);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // SCENARIO_CORE_UTILS_THREADPOOL_H
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ */
+
+#include "scenario/core/utils/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace scenario::core::utils;
+
+class ThreadPool::Impl
+{
+public:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workCompleted;
+
+    // Data of the batch being processed, protected by the mutex
+    bool terminate = false;
+    uint64_t batch = 0;
+    size_t numOfTasks = 0;
+    size_t busyWorkers = 0;
+    const Task* task = nullptr;
+
+    // Index of the next task to process
+    std::atomic<size_t> nextTask{0};
+
+    void worker();
+    void processTasks(const Task& task, const size_t numOfTasks);
+};
+
+ThreadPool::ThreadPool(const size_t numOfThreads)
+    : pImpl{std::make_unique<Impl>()}
+{
+    size_t threads = numOfThreads;
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The calling thread also processes the tasks
+    for (size_t i = 1; i < threads; ++i) {
+        pImpl->workers.emplace_back(&Impl::worker, pImpl.get());
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock lock(pImpl->mutex);
+        pImpl->terminate = true;
+    }
+
+    pImpl->workAvailable.notify_all();
+
+    for (auto& worker : pImpl->workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::numOfThreads() const
+{
+    return pImpl->workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(const size_t numOfTasks, const Task& task)
+{
+    if (numOfTasks == 0) {
+        return;
+    }
+
+    // Avoid waking up the workers if there's nothing to parallelize
+    if (pImpl->workers.empty() || numOfTasks == 1) {
+        for (size_t index = 0; index < numOfTasks; ++index) {
+            task(index);
+        }
+        return;
+    }
+
+    {
+        std::unique_lock lock(pImpl->mutex);
+        pImpl->task = &task;
+        pImpl->numOfTasks = numOfTasks;
+        pImpl->nextTask = 0;
+        pImpl->busyWorkers = pImpl->workers.size();
+        pImpl->batch++;
+    }
+
+    pImpl->workAvailable.notify_all();
+
+    // Process the tasks also in the calling thread
+    pImpl->processTasks(task, numOfTasks);
+
+    // Wait that all the workers are done with this batch
+    std::unique_lock lock(pImpl->mutex);
+    pImpl->workCompleted.wait(lock, [&] { return pImpl->busyWorkers == 0; });
+    pImpl->task = nullptr;
+}
+
+// ==============
+// Implementation
+// ==============
+
+void ThreadPool::Impl::worker()
+{
+    uint64_t lastBatch = 0;
+
+    while (true) {
+        const Task* batchTask = nullptr;
+        size_t batchNumOfTasks = 0;
+
+        {
+            std::unique_lock lock(mutex);
+            workAvailable.wait(
+                lock, [&] { return terminate || batch != lastBatch; });
+
+            if (terminate) {
+                return;
+            }
+
+            lastBatch = batch;
+            batchTask = task;
+            batchNumOfTasks = numOfTasks;
+        }
+
+        this->processTasks(*batchTask, batchNumOfTasks);
+
+        {
+            std::unique_lock lock(mutex);
+            busyWorkers--;
+        }
+
+        workCompleted.notify_one();
+    }
+}
+
+void ThreadPool::Impl::processTasks(const Task& task, const size_t numOfTasks)
+{
+    for (size_t index = nextTask++; index < numOfTasks; index = nextTask++) {
+        task(index);
+    }
+}
@@ -36,6 +36,7 @@
 namespace scenario::gazebo {
     class World;
     class GazeboSimulator;
+    struct Termination;
 } // namespace scenario::gazebo
 
 class scenario::gazebo::GazeboSimulator
@@ -80,6 +81,131 @@ public:
      */
     size_t stepsPerRun() const;
 
+    /**
+     * Set the size of a simulator step.
+     *
+     * If the simulator is already initialized, the new step size is applied
+     * to all the worlds starting from the next run, without restarting the
+     * server.
+     *
+     * @param stepSize The new step size in seconds.
+     * @return True for success, false otherwise.
+     */
+    bool setStepSize(const double stepSize);
+
+    /**
+     * Set the number of steps to execute every simulator run.
+     *
+     * The new value takes effect starting from the next run.
+     *
+     * @param stepsPerRun The new number of steps per run.
+     * @return True for success, false otherwise.
+     */
+    bool setStepsPerRun(const size_t stepsPerRun);
+
+    /**
+     * Enable stepping the worlds of the simulator in parallel.
+     *
+     * When enabled, each world is simulated by a dedicated server and the
+     * servers are stepped concurrently by a pool of threads at every run.
+     * Worlds do not share their ECM nor their physics instance, therefore the
+     * evolution of each world is bit-identical to the one obtained stepping
+     * the worlds sequentially.
+     *
+     * @note The random generator of ignition::math is global to the process
+     * and it is shared by all the worlds. Systems drawing random numbers from
+     * it are not deterministic when the worlds are stepped in parallel.
+     *
+     * @note This method must be called before initializing the simulator.
+     *
+     * @param enable True to step the worlds in parallel, false otherwise.
+     * @param numOfThreads The number of threads of the pool. If zero, the
+     * hardware concurrency is used.
+     * @return True for success, false otherwise.
+     */
+    bool enableParallelWorlds(const bool enable = true,
+                              const size_t numOfThreads = 0);
+
+    /**
+     * Check if the worlds of the simulator are stepped in parallel.
+     *
+     * @return True if the worlds are stepped in parallel, false otherwise.
+     */
+    bool parallelWorldsEnabled() const;
+
+    /**
+     * Terminate the run when the base of a model falls below a height.
+     *
+     * Termination predicates are evaluated after every physics step of
+     * unpaused runs. When a predicate fires, the remaining steps of the run
+     * of the server simulating the affected world are skipped.
+     *
+     * @note Without parallel worlds, all the worlds are simulated by the same
+     * server. A predicate firing in one of them stops all the worlds, that
+     * execute the same number of steps. With parallel worlds enabled, each
+     * world has its own server and the other worlds complete their run.
+     *
+     * @note This method must be called after initializing the simulator.
+     *
+     * @param name The name of the predicate, used to report the termination.
+     * @param modelName The name of the model.
+     * @param minHeight The minimum height of the base in world coordinates.
+     * @param worldName The name of the world containing the model. It can be
+     * omitted if the simulator has a single world.
+     * @return True for success, false otherwise.
+     */
+    bool addBaseHeightTermination(const std::string& name,
+                                  const std::string& modelName,
+                                  const double minHeight,
+                                  const std::string& worldName = "");
+
+    /**
+     * Terminate the run when any of the given links is in contact.
+     *
+     * @note The contact detection of the links is enabled by this method.
+     *
+     * @param name The name of the predicate, used to report the termination.
+     * @param modelName The name of the model.
+     * @param linkNames The links that must not be in contact.
+     * @param worldName The name of the world containing the model. It can be
+     * omitted if the simulator has a single world.
+     * @return True for success, false otherwise.
+     */
+    bool addContactTermination(const std::string& name,
+                               const std::string& modelName,
+                               const std::vector<std::string>& linkNames,
+                               const std::string& worldName = "");
+
+    /**
+     * Terminate the run when any joint position is out of its limits.
+     *
+     * @param name The name of the predicate, used to report the termination.
+     * @param modelName The name of the model.
+     * @param jointNames Optional vector of considered joints. By default, all
+     * the joints of the model are considered.
+     * @param worldName The name of the world containing the model. It can be
+     * omitted if the simulator has a single world.
+     * @return True for success, false otherwise.
+     */
+    bool addJointLimitsTermination( //
+        const std::string& name,
+        const std::string& modelName,
+        const std::vector<std::string>& jointNames = {},
+        const std::string& worldName = "");
+
+    /**
+     * Remove all the termination predicates.
+     */
+    void clearTerminationPredicates();
+
+    /**
+     * Get the predicates that fired during the last run.
+     *
+     * @return The terminations of the last run, one for each terminated world.
+     * The vector is empty if no predicate fired.
+     */
+    std::vector<Termination> terminations() const;
+
     /**
      * Initialize the simulator.
      *
@@ -117,7 +243,7 @@ public:
      *
      * @return True for success, false otherwise.
      */
-    bool close();
+    virtual bool close();
 
     /**
      * Pause the simulator.
@@ -189,4 +315,11 @@ private:
     std::unique_ptr<Impl> pImpl;
 };
 
+struct scenario::gazebo::Termination
+{
+    std::string predicate;
+    std::string worldName;
+    size_t step = 0;
+};
+
 #endif // SCENARIO_GAZEBO_GAZEBOSIMULATOR_H
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCENARIO_GAZEBO_GAZEBOSIMULATORPOOL_H
+#define SCENARIO_GAZEBO_GAZEBOSIMULATORPOOL_H
+
+#include "scenario/gazebo/World.h"
+
+#include <memory>
+#include <string>
+
+namespace scenario::gazebo {
+    class GazeboSimulator;
+    class GazeboSimulatorPool;
+} // namespace scenario::gazebo
+
+class scenario::gazebo::GazeboSimulatorPool
+{
+public:
+    /**
+     * Pool of pre-initialized simulators.
+     *
+     * All the simulators of the pool are created, initialized and
+     * configured with the physics engine once, when the pool is initialized.
+     * Simulators are then handed out and, when they are given back, they are
+     * reset to their pristine state instead of being destroyed.
+     *
+     * The pristine state is the state of the world right after the physics
+     * engine has been loaded. Resetting a simulator removes the models
+     * inserted afterwards, restores the state, the joint control modes, the
+     * PIDs and the joint and base targets of the original models, rewinds the
+     * simulated time, and restores the step size and the steps per run.
+     *
+     * @note Plugins cannot be unloaded from a running simulator. Simulators
+     * that loaded plugins other than the JointController of the original
+     * models are replaced by new ones when they are released.
+     *
+     * @param size The number of simulators of the pool.
+     * @param stepSize The size of the physics step.
+     * @param rtf The desired real-time factor.
+     * @param stepsPerRun Number of steps to execute at each simulator run.
+     * @param worldFile The optional path to the SDF world file. If empty, the
+     * default empty world is used.
+     * @param engine The physics engine inserted in the worlds.
+     */
+    GazeboSimulatorPool(const size_t size,
+                        const double stepSize = 0.001,
+                        const double rtf = 1.0,
+                        const size_t stepsPerRun = 1,
+                        const std::string& worldFile = "",
+                        const PhysicsEngine engine = PhysicsEngine::Dart);
+    virtual ~GazeboSimulatorPool();
+
+    /**
+     * Create and initialize all the simulators of the pool.
+     *
+     * @return True for success, false otherwise.
+     */
+    bool initialize();
+
+    /**
+     * Get the number of simulators of the pool.
+     *
+     * @return The number of simulators.
+     */
+    size_t size() const;
+
+    /**
+     * Get the number of simulators that can be acquired.
+     *
+     * @return The number of available simulators.
+     */
+    size_t available() const;
+
+    /**
+     * Get an initialized simulator from the pool.
+     *
+     * @return The simulator if one is available, nullptr otherwise.
+     */
+    std::shared_ptr<GazeboSimulator> acquire();
+
+    /**
+     * Give a simulator back to the pool.
+     *
+     * The simulator is reset to its pristine state. If the reset fails, the
+     * simulator cannot be reset in place, or it was closed, it is replaced
+     * by a new one.
+     *
+     * @param simulator The simulator previously acquired from the pool.
+     * @return True for success, false otherwise.
+     */
+    bool release(const std::shared_ptr<GazeboSimulator>& simulator);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // SCENARIO_GAZEBO_GAZEBOSIMULATORPOOL_H
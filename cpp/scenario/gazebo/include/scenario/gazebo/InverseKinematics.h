@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCENARIO_GAZEBO_INVERSEKINEMATICS_H
+#define SCENARIO_GAZEBO_INVERSEKINEMATICS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace scenario::gazebo {
+    class Model;
+    class InverseKinematics;
+} // namespace scenario::gazebo
+
+class scenario::gazebo::InverseKinematics
+{
+public:
+    /**
+     * Damped least squares inverse kinematics of a model frame.
+     *
+     * The kinematic chain from the base link of the model to the link of the
+     * target frame is built from the links and joints of the simulated model
+     * when the solver is initialized. Only fixed, revolute and prismatic
+     * joints are supported.
+     *
+     * Targets are expressed in the world frame and are read at every solve
+     * together with the pose of the base link. Joints of the chain that are
+     * not optimized keep their current position.
+     *
+     * Each target is a pose stored in 7 consecutive elements: the position
+     * followed by the wxyz quaternion. Multiple targets can be solved in a
+     * single call by concatenating them.
+     */
+    InverseKinematics();
+    virtual ~InverseKinematics();
+
+    /**
+     * Initialize the solver.
+     *
+     * @param model The model.
+     * @param frame The name of the link whose pose is controlled.
+     * @param jointNames Optional vector of optimized joints. By default, all
+     * the non-fixed joints of the chain are optimized.
+     * @return True for success, false otherwise.
+     */
+    bool initialize(std::shared_ptr<Model> model,
+                    const std::string& frame,
+                    const std::vector<std::string>& jointNames = {});
+
+    /**
+     * Get the optimized joints.
+     *
+     * @return The names of the joints defining the serialization of the
+     * solutions.
+     */
+    std::vector<std::string> jointNames() const;
+
+    /**
+     * Get the number of optimized joints.
+     *
+     * @return The number of optimized joints.
+     */
+    size_t dofs() const;
+
+    /**
+     * Set the damping of the least squares problem.
+     *
+     * @param damping The non-negative damping factor.
+     * @return True for success, false otherwise.
+     */
+    bool setDamping(const double damping);
+
+    /**
+     * Set the maximum number of iterations of each target.
+     *
+     * @param maxIterations The maximum number of iterations.
+     * @return True for success, false otherwise.
+     */
+    bool setMaxIterations(const size_t maxIterations);
+
+    /**
+     * Set the tolerance on the norm of the weighted pose error.
+     *
+     * @param tolerance The positive tolerance.
+     * @return True for success, false otherwise.
+     */
+    bool setTolerance(const double tolerance);
+
+    /**
+     * Set the weight of the orientation error.
+     *
+     * @param weight The non-negative weight. Use 0 to only control the
+     * position of the frame.
+     * @return True for success, false otherwise.
+     */
+    bool setRotationWeight(const double weight);
+
+    /**
+     * Set the initial configuration of the next solve.
+     *
+     * @note After each solve, the solver is warm started from the solution of
+     * the last target.
+     *
+     * @param jointPositions The positions of the optimized joints.
+     * @return True for success, false otherwise.
+     */
+    bool setWarmStart(const std::vector<double>& jointPositions);
+
+    /**
+     * Solve the inverse kinematics of a batch of targets.
+     *
+     * @param targets The concatenated poses of the targets.
+     * @param chainWarmStart If true, each target is warm started from the
+     * solution of the previous target, that is convenient for trajectories.
+     * Otherwise, all the targets are warm started from the same configuration.
+     * @return True if all the targets converged, false otherwise.
+     */
+    bool solve(const std::vector<double>& targets,
+               const bool chainWarmStart = true);
+
+    /**
+     * Get the solutions of the last solve.
+     *
+     * @return The concatenated positions of the optimized joints, one set
+     * for each target.
+     */
+    std::vector<double> solution() const;
+
+    /**
+     * Get the residual errors of the last solve.
+     *
+     * @return The norm of the weighted pose error of each target.
+     */
+    std::vector<double> residuals() const;
+
+    /**
+     * Compute the pose of the frame.
+     *
+     * @param jointPositions The positions of the optimized joints.
+     * @return The pose of the frame in the world frame, stored as the
+     * position followed by the wxyz quaternion.
+     */
+    std::vector<double>
+    forwardKinematics(const std::vector<double>& jointPositions) const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // SCENARIO_GAZEBO_INVERSEKINEMATICS_H
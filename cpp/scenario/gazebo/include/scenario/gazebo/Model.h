@@ -27,6 +27,7 @@
 #ifndef SCENARIO_GAZEBO_MODEL_H
 #define SCENARIO_GAZEBO_MODEL_H
 
+#include "scenario/core/Link.h"
 #include "scenario/core/Model.h"
 #include "scenario/gazebo/GazeboEntity.h"
 
@@ -35,12 +36,33 @@
 #include <ignition/gazebo/EventManager.hh>
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace scenario::gazebo {
     class Model;
+    struct BaseState;
+    struct Statistics;
+
+    /**
+     * Model quantities that can be accumulated over the physics steps.
+     *
+     * - ``JointPower``: sum over the joints of the applied force times the
+     *   joint velocity. Its integral is the mechanical work of the joints.
+     * - ``JointVelocity``: maximum absolute velocity of the joints.
+     * - ``ContactForce``: norm of the total contact force on the links.
+     * - ``LinkLinearVelocity``: maximum norm of the linear mixed velocity of
+     *   the links.
+     */
+    enum class AccumulatedQuantity
+    {
+        JointPower,
+        JointVelocity,
+        ContactForce,
+        LinkLinearVelocity,
+    };
 } // namespace scenario::gazebo
 
 class scenario::gazebo::Model final
@@ -163,6 +185,79 @@ public:
         const std::array<double, 3>& linear = {0, 0, 0},
         const std::array<double, 3>& angular = {0, 0, 0});
 
+    /**
+     * Get the complete state of the base link.
+     *
+     * The pose and all the velocities are computed from a single read of
+     * the components, and are equivalent to those returned by the
+     * individual methods.
+     *
+     * @return The state of the base link.
+     */
+    BaseState baseState() const;
+
+    /**
+     * Enable the accumulation of model quantities over the physics steps.
+     *
+     * The accumulators are updated at every physics step, therefore they
+     * capture what happens within runs with multiple steps. They can be read
+     * and reset at every run.
+     *
+     * @param enable True to enable the accumulators, false to disable.
+     * @return True for success, false otherwise.
+     */
+    bool enableAccumulators(const bool enable = true);
+
+    /**
+     * Check if the accumulators of model quantities are enabled.
+     *
+     * @return True if the accumulators are enabled, false otherwise.
+     */
+    bool accumulatorsEnabled() const;
+
+    /**
+     * Get the statistics of an accumulated quantity.
+     *
+     * @param quantity The accumulated quantity.
+     * @return The statistics accumulated since the last reset. All the fields
+     * are zero if no physics steps were executed or if the accumulators are
+     * not enabled.
+     */
+    Statistics accumulator(const AccumulatedQuantity quantity) const;
+
+    /**
+     * Reset the statistics of all the accumulated quantities.
+     *
+     * @return True for success, false otherwise.
+     */
+    bool resetAccumulators();
+
+    /**
+     * Set the collision bitmask of all the collisions of the model.
+     *
+     * Two collisions can collide only if the bitwise AND of their bitmasks is
+     * not zero. The default bitmask is ``0xFFFF``. Replicas of a robot
+     * simulated in the same world can be isolated by assigning a different
+     * bit to each of them. Models with the default bitmask, like the ground
+     * plane, keep colliding with all the replicas.
+     *
+     * @note The bitmask is applied when the physics engine creates the
+     * collisions, therefore this method must be called before the first run
+     * following the insertion of the model. It is not applied to the mesh
+     * collisions.
+     *
+     * @param bitmask The collision bitmask.
+     * @return True for success, false otherwise.
+     */
+    bool setCollisionBitmask(const uint16_t bitmask);
+
+    /**
+     * Get the collision bitmask of the model.
+     *
+     * @return The collision bitmask.
+     */
+    uint16_t collisionBitmask() const;
+
     // ==========
     // Model Core
     // ==========
@@ -342,4 +437,22 @@ private:
     std::unique_ptr<Impl> pImpl;
 };
 
+struct scenario::gazebo::BaseState
+{
+    core::Pose pose;
+    std::array<double, 3> worldLinearVelocity = {0, 0, 0};
+    std::array<double, 3> worldAngularVelocity = {0, 0, 0};
+    std::array<double, 3> bodyLinearVelocity = {0, 0, 0};
+    std::array<double, 3> bodyAngularVelocity = {0, 0, 0};
+};
+
+struct scenario::gazebo::Statistics
+{
+    size_t samples = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+    double integral = 0;
+};
+
 #endif // SCENARIO_GAZEBO_MODEL_H
@@ -97,6 +97,26 @@ public:
      */
     bool setPhysicsEngine(const PhysicsEngine engine);
 
+    /**
+     * Control the joints of all the models with a single world plugin.
+     *
+     * By default, a JointController plugin is inserted in every model with
+     * joints controlled in Position or Velocity. This method inserts instead
+     * a plugin that runs the PIDs of all the models of the world in a single
+     * pass. Models that already have their own JointController plugin keep
+     * using it.
+     *
+     * @return True for success, false otherwise.
+     */
+    bool enableWorldJointController();
+
+    /**
+     * Check if the joints are controlled by the world plugin.
+     *
+     * @return True if the world joint controller is enabled, false otherwise.
+     */
+    bool worldJointControllerEnabled() const;
+
     /**
      * Set the gravity of the world.
      *
@@ -108,6 +128,55 @@ public:
      */
     bool setGravity(const std::array<double, 3>& gravity);
 
+    /**
+     * Set the number of physics sub-steps.
+     *
+     * Every update of the world is split in the given number of physics
+     * engine steps. The joint and link commands are kept constant during
+     * the sub-steps, and the state of the entities is updated only after the
+     * last one.
+     *
+     * @note Sub-stepping is disabled as long as any entity has the
+     * ``RequiresEveryPhysicsStep`` component, that can be created by the
+     * systems that need the state of every physics step.
+     *
+     * @param subSteps The number of sub-steps, greater than zero.
+     * @return True for success, false otherwise.
+     */
+    bool setPhysicsSubSteps(const size_t subSteps);
+
+    /**
+     * Get the number of physics sub-steps.
+     *
+     * @return The number of physics engine steps of each world update.
+     */
+    size_t physicsSubSteps() const;
+
+    /**
+     * Set the number of threads used to process the physics state.
+     *
+     * After every step, the state of the models is read from the physics
+     * engine and written to their components. This process can be executed
+     * in parallel, partitioning the entities by model. The engine is
+     * stepped and commanded always from a single thread.
+     *
+     * The number of threads can be changed between runs, the threads are
+     * created again at the beginning of the following step.
+     *
+     * @param numOfThreads The number of threads. If zero, the hardware
+     * concurrency is used. It cannot exceed four times the hardware
+     * concurrency.
+     * @return True for success, false otherwise.
+     */
+    bool setPhysicsThreads(const size_t numOfThreads);
+
+    /**
+     * Get the number of threads used to process the physics state.
+     *
+     * @return The number of threads. Zero means the hardware concurrency.
+     */
+    size_t physicsThreads() const;
+
     /**
      * Insert a model in the world.
      *
@@ -138,6 +207,67 @@ public:
      */
     bool removeModel(const std::string& modelName);
 
+    /**
+     * Get the joint positions of multiple models.
+     *
+     * The positions are stacked in a row-major buffer with one row for each
+     * model. All the models must have the same number of considered DoFs.
+     *
+     * @note The joints of a set of models are resolved only the first time
+     * the set is used. Following calls with the same arguments only read the
+     * joint states.
+     *
+     * @param modelNames The names of the models.
+     * @param jointNames Optional vector of considered joints, common to all
+     * the models. By default, ``Model::jointNames`` is used.
+     * @return The models x dofs buffer of joint positions. The buffer is empty
+     * in case of failure.
+     */
+    std::vector<double> batchJointPositions( //
+        const std::vector<std::string>& modelNames,
+        const std::vector<std::string>& jointNames = {}) const;
+
+    /**
+     * Get the joint velocities of multiple models.
+     *
+     * @param modelNames The names of the models.
+     * @param jointNames Optional vector of considered joints, common to all
+     * the models. By default, ``Model::jointNames`` is used.
+     * @return The models x dofs buffer of joint velocities. The buffer is
+     * empty in case of failure.
+     */
+    std::vector<double> batchJointVelocities( //
+        const std::vector<std::string>& modelNames,
+        const std::vector<std::string>& jointNames = {}) const;
+
+    /**
+     * Get the base poses of multiple models.
+     *
+     * Each row of the buffer contains the position and the wxyz quaternion of
+     * the base.
+     *
+     * @param modelNames The names of the models.
+     * @return The models x 7 buffer of base poses. The buffer is empty in case
+     * of failure.
+     */
+    std::vector<double>
+    batchBasePoses(const std::vector<std::string>& modelNames) const;
+
+    /**
+     * Set the generalized force targets of the joints of multiple models.
+     *
+     * @param forces The models x dofs buffer of generalized forces, with the
+     * same layout returned by ``World::batchJointPositions``.
+     * @param modelNames The names of the models.
+     * @param jointNames Optional vector of considered joints, common to all
+     * the models. By default, ``Model::jointNames`` is used.
+     * @return True for success, false otherwise.
+     */
+    bool setBatchJointGeneralizedForceTargets( //
+        const std::vector<double>& forces,
+        const std::vector<std::string>& modelNames,
+        const std::vector<std::string>& jointNames = {});
+
     // ==========
     // World Core
     // ==========
@@ -56,6 +56,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -131,6 +132,28 @@ namespace scenario::gazebo::utils {
                                   const ignition::gazebo::Entity entity)
         -> decltype(ComponentTypeT().Data());
 
+    // Non-throwing variants of the getters above, meant for code running at
+    // every simulation step. They return nullptr if the component is missing.
+
+    template <typename ComponentTypeT>
+    ComponentTypeT*
+    tryGetExistingComponent(ignition::gazebo::EntityComponentManager* ecm,
+                            const ignition::gazebo::Entity entity) noexcept;
+
+    template <typename ComponentTypeT>
+    auto
+    tryGetExistingComponentData(ignition::gazebo::EntityComponentManager* ecm,
+                                const ignition::gazebo::Entity entity) noexcept
+        -> std::remove_reference_t<decltype(ComponentTypeT().Data())>*;
+
+    bool isModelRemoved(ignition::gazebo::EntityComponentManager* ecm,
+                        const ignition::gazebo::Entity modelEntity);
+
+    // Increment the version of the references of a model. It has to be
+    // called by all the setters of base and joint targets.
+    void updateReferencesVersion(ignition::gazebo::EntityComponentManager* ecm,
+                                 const ignition::gazebo::Entity modelEntity);
+
     scenario::core::Pose
     fromIgnitionPose(const ignition::math::Pose3d& ignitionPose);
 
@@ -157,6 +180,11 @@ namespace scenario::gazebo::utils {
                           const double realTimeUpdateRate,
                           const size_t worldIndex = 0);
 
+    bool updateSDFPhysics(const sdf::ElementPtr worldElement,
+                          const double maxStepSize,
+                          const double rtf,
+                          const double realTimeUpdateRate);
+
     sdf::ElementPtr getPluginSDFElement(const std::string& libName,
                                         const std::string& className);
 
@@ -452,6 +480,29 @@ auto scenario::gazebo::utils::getExistingComponentData(
     return component->Data();
 }
 
+template <typename ComponentTypeT>
+ComponentTypeT* scenario::gazebo::utils::tryGetExistingComponent(
+    ignition::gazebo::EntityComponentManager* ecm,
+    const ignition::gazebo::Entity entity) noexcept
+{
+    if (!ecm) {
+        return nullptr;
+    }
+
+    return ecm->Component<ComponentTypeT>(entity);
+}
+
+template <typename ComponentTypeT>
+auto scenario::gazebo::utils::tryGetExistingComponentData(
+    ignition::gazebo::EntityComponentManager* ecm,
+    const ignition::gazebo::Entity entity) noexcept
+    -> std::remove_reference_t<decltype(ComponentTypeT().Data())>*
+{
+    auto* component = tryGetExistingComponent<ComponentTypeT>(ecm, entity);
+
+    return component ? &component->Data() : nullptr;
+}
+
 template <typename ComponentTypeT, typename ComponentDataTypeT>
 auto scenario::gazebo::utils::setComponentData(
     ignition::gazebo::EntityComponentManager* ecm,
@@ -26,8 +26,10 @@
 
 #include "scenario/gazebo/GazeboSimulator.h"
 #include "process.hpp"
+#include "scenario/core/utils/ThreadPool.h"
 #include "scenario/core/utils/signals.h"
 #include "scenario/gazebo/Log.h"
+#include "scenario/gazebo/Model.h"
 #include "scenario/gazebo/World.h"
 #include "scenario/gazebo/components/SimulatedTime.h"
 #include "scenario/gazebo/components/Timestamp.h"
@@ -35,10 +37,13 @@
 #include "scenario/gazebo/utils.h"
 #include "scenario/plugins/gazebo/ECMSingleton.h"
 
+#include <ignition/common/Profiler.hh>
 #include <ignition/gazebo/Server.hh>
 #include <ignition/gazebo/ServerConfig.hh>
 #include <ignition/gazebo/components/Name.hh>
+#include <ignition/gazebo/components/PhysicsCmd.hh>
 #include <ignition/gazebo/components/World.hh>
+#include <ignition/msgs/physics.pb.h>
 #include <ignition/transport/Node.hh>
 #include <ignition/transport/Publisher.hh>
 #include <sdf/Element.hh>
@@ -47,11 +52,12 @@
 #include <sdf/World.hh>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
-#include <cmath>
 #include <csignal>
-#include <limits>
+#include <functional>
+#include <mutex>
 #include <optional>
 #include <thread>
 #include <unordered_map>
@@ -68,19 +74,6 @@ struct detail::PhysicsData
     double maxStepSize = -1;
     double realTimeUpdateRate = -1;
 
-    bool operator==(const PhysicsData& other)
-    {
-        return doubleEq(this->rtf, other.rtf)
-               && doubleEq(this->maxStepSize, other.maxStepSize)
-               && doubleEq(this->realTimeUpdateRate, other.realTimeUpdateRate);
-    }
-
-    static bool doubleEq(const double first, const double second)
-    {
-        return std::abs(first - second)
-               < 10 * std::numeric_limits<double>::epsilon();
-    }
-
     friend std::ostream& operator<<(std::ostream& out, const PhysicsData& data)
     {
         out << "max_step_size=" << data.maxStepSize << std::endl;
@@ -98,25 +91,61 @@ class GazeboSimulator::Impl
 {
 public:
     sdf::ElementPtr sdfElement = nullptr;
+    std::vector<std::string> sdfWorldNames;
+
+    using ServerPtr = std::shared_ptr<ignition::gazebo::Server>;
 
     struct
     {
         detail::PhysicsData physics;
         uint64_t numOfIterations = 0;
         std::unique_ptr<TinyProcessLib::Process> gui;
-        std::shared_ptr<ignition::gazebo::Server> server;
+        // A single server simulating all the worlds, or one server per world
+        // if the worlds are stepped in parallel
+        std::vector<ServerPtr> servers;
+        size_t worldsPerServer = 0;
+        // The names of the worlds simulated by each server
+        std::vector<std::vector<std::string>> serverWorlds;
     } gazebo;
 
+    struct
+    {
+        bool enabled = false;
+        size_t numOfThreads = 0;
+        std::unique_ptr<core::utils::ThreadPool> pool;
+    } parallelWorlds;
+
+    struct TerminationPredicate
+    {
+        std::string name;
+        std::string worldName;
+        std::function<bool()> fired;
+    };
+
+    struct
+    {
+        std::vector<TerminationPredicate> predicates;
+        std::vector<Termination> terminations;
+        // Guards both the containers. The predicates must not be modified
+        // while the simulator runs.
+        std::mutex mutex;
+    } termination;
+
     bool insertWorld(const sdf::World& world);
-    std::shared_ptr<ignition::gazebo::Server> getServer();
+    const std::vector<ServerPtr>& getServers();
+    bool runServer(const size_t serverIdx, const bool paused);
+    bool addTerminationPredicate(const GazeboSimulator& simulator,
+                                 const std::string& name,
+                                 const std::string& modelName,
+                                 const std::string& worldName,
+                                 std::function<bool(core::ModelPtr)> fired);
     bool postProcessWorld(const std::string& worldName);
+    bool setWorldPhysics(const std::string& worldName, const double stepSize);
 
     using WorldName = std::string;
     using GazeboWorldPtr = std::shared_ptr<scenario::gazebo::World>;
     std::unordered_map<WorldName, GazeboWorldPtr> worlds;
 
-    static detail::PhysicsData getPhysicsData(const sdf::Root& root,
-                                              const size_t worldIndex);
     bool sceneBroadcasterActive(const std::string& worldName);
 };
 
@@ -157,6 +186,161 @@ size_t GazeboSimulator::stepsPerRun() const
     return pImpl->gazebo.numOfIterations;
 }
 
+bool GazeboSimulator::setStepSize(const double stepSize)
+{
+    if (stepSize <= 0) {
+        sError << "Invalid physics max step size (" << stepSize << ")"
+               << std::endl;
+        return false;
+    }
+
+    // Before the initialization, the step size is stored in the SDF
+    // physics element when the server is created
+    if (this->initialized()) {
+        for (const auto& worldName : this->worldNames()) {
+            if (!pImpl->setWorldPhysics(worldName, stepSize)) {
+                sError << "Failed to update the physics of world "
+                       << worldName << std::endl;
+                return false;
+            }
+        }
+    }
+
+    pImpl->gazebo.physics.maxStepSize = stepSize;
+    return true;
+}
+
+bool GazeboSimulator::setStepsPerRun(const size_t stepsPerRun)
+{
+    if (stepsPerRun == 0) {
+        sError << "Non-deterministic mode (iterations=0) is not "
+               << "currently supported" << std::endl;
+        return false;
+    }
+
+    pImpl->gazebo.numOfIterations = stepsPerRun;
+    return true;
+}
+
+bool GazeboSimulator::enableParallelWorlds(const bool enable,
+                                           const size_t numOfThreads)
+{
+    if (this->initialized()) {
+        sError << "Parallel worlds must be configured before initializing "
+               << "the simulator" << std::endl;
+        return false;
+    }
+
+    pImpl->parallelWorlds.enabled = enable;
+    pImpl->parallelWorlds.numOfThreads = numOfThreads;
+
+    return true;
+}
+
+bool GazeboSimulator::parallelWorldsEnabled() const
+{
+    return pImpl->parallelWorlds.enabled;
+}
+
+bool GazeboSimulator::addBaseHeightTermination(const std::string& name,
+                                               const std::string& modelName,
+                                               const double minHeight,
+                                               const std::string& worldName)
+{
+    return pImpl->addTerminationPredicate(
+        *this, name, modelName, worldName, [=](core::ModelPtr model) {
+            return model->basePosition()[2] < minHeight;
+        });
+}
+
+bool GazeboSimulator::addContactTermination(
+    const std::string& name,
+    const std::string& modelName,
+    const std::vector<std::string>& linkNames,
+    const std::string& worldName)
+{
+    if (linkNames.empty()) {
+        sError << "No links passed to the contact termination" << std::endl;
+        return false;
+    }
+
+    std::shared_ptr<World> world = this->getWorld(worldName);
+
+    if (!world) {
+        sError << "Failed to get world '" << worldName << "'" << std::endl;
+        return false;
+    }
+
+    std::vector<core::LinkPtr> links;
+
+    try {
+        links = world->getModel(modelName)->links(linkNames);
+    }
+    catch (const std::exception& e) {
+        sError << e.what() << std::endl;
+        return false;
+    }
+
+    for (const auto& link : links) {
+        if (!link->enableContactDetection(true)) {
+            sError << "Failed to enable contact detection of link '"
+                   << link->name() << "'" << std::endl;
+            return false;
+        }
+    }
+
+    return pImpl->addTerminationPredicate(
+        *this, name, modelName, worldName, [links](core::ModelPtr) {
+            return std::any_of(links.begin(), links.end(), [](const auto& l) {
+                return l->inContact();
+            });
+        });
+}
+
+bool GazeboSimulator::addJointLimitsTermination(
+    const std::string& name,
+    const std::string& modelName,
+    const std::vector<std::string>& jointNames,
+    const std::string& worldName)
+{
+    return pImpl->addTerminationPredicate(
+        *this,
+        name,
+        modelName,
+        worldName,
+        [jointNames, limits = std::optional<core::JointLimit>()](
+            core::ModelPtr model) mutable {
+            // Limits do not change, read them only once
+            if (!limits) {
+                limits = model->jointLimits(jointNames);
+            }
+
+            const std::vector<double> positions =
+                model->jointPositions(jointNames);
+
+            for (size_t i = 0; i < positions.size(); ++i) {
+                if (positions[i] < limits->min[i]
+                    || positions[i] > limits->max[i]) {
+                    return true;
+                }
+            }
+
+            return false;
+        });
+}
+
+void GazeboSimulator::clearTerminationPredicates()
+{
+    std::lock_guard lock(pImpl->termination.mutex);
+    pImpl->termination.predicates.clear();
+}
+
+std::vector<Termination> GazeboSimulator::terminations() const
+{
+    std::lock_guard lock(pImpl->termination.mutex);
+    return pImpl->termination.terminations;
+}
+
 bool GazeboSimulator::initialize()
 {
     if (this->initialized()) {
@@ -165,7 +349,7 @@ bool GazeboSimulator::initialize()
     }
 
     // Initialize the server
-    if (!pImpl->getServer()) {
+    if (pImpl->getServers().empty()) {
         sError << "Failed to get the Gazebo server" << std::endl;
         return false;
     }
@@ -187,7 +371,7 @@ bool GazeboSimulator::initialize()
 
 bool GazeboSimulator::initialized() const
 {
-    return bool(pImpl->gazebo.server);
+    return !pImpl->gazebo.servers.empty();
 }
 
 bool GazeboSimulator::run(const bool paused)
@@ -197,48 +381,35 @@ bool GazeboSimulator::run(const bool paused)
         return false;
     }
 
-    // Get the gazebo server
-    auto server = pImpl->getServer();
-    if (!server) {
+    // Get the gazebo servers
+    const auto& servers = pImpl->getServers();
+    if (servers.empty()) {
         sError << "Failed to get the ignition server" << std::endl;
         return false;
     }
 
-    // If the server was configured to run in background (iterations = 0)
-    // only the first call to this run method should trigger the start of
-    // the simulation in non-blocking mode.
-    // NOTE: non-blocking implementation is partial and not supported
-    bool deterministic = pImpl->gazebo.numOfIterations != 0 ? true : false;
-
-    if (!deterministic && server->Running()) {
-        sWarning << "The server is already running in background" << std::endl;
-        return true;
+    // Clear the terminations of the previous run
+    {
+        std::lock_guard lock(pImpl->termination.mutex);
+        pImpl->termination.terminations.clear();
     }
 
-    size_t iterations = pImpl->gazebo.numOfIterations;
-
-    // Allow executing a single paused step in non-blocking mode,
-    // allowing to refresh the visualized world state
-    if (!deterministic && !server->Running() && paused) {
-        deterministic = true;
-        iterations = 1;
+    if (servers.size() == 1) {
+        return pImpl->runServer(0, paused);
     }
 
-    if (paused && !server->RunOnce(/*paused=*/true)) {
-        sError << "The server couldn't execute the paused step" << std::endl;
-        return false;
-    }
+    // Worlds simulated by different servers do not share any state and they
+    // can be stepped concurrently without affecting their evolution
+    std::atomic<bool> ok{true};
 
-    // Run the simulation
-    if (!paused
-        && !server->Run(/*blocking=*/deterministic,
-                        /*iterations=*/iterations,
-                        /*paused=*/false)) {
-        sError << "The server couldn't execute the step" << std::endl;
-        return false;
-    }
+    pImpl->parallelWorlds.pool->parallelFor(
+        servers.size(), [&](const size_t serverIdx) {
+            if (!pImpl->runServer(serverIdx, paused)) {
+                ok = false;
+            }
+        });
 
-    return true;
+    return ok;
 }
 
 bool GazeboSimulator::gui(const int verbosity)
@@ -321,7 +492,7 @@ bool GazeboSimulator::close()
     }
 
     // Pause the simulator before tearing it down
-    if (pImpl->gazebo.server && this->running()) {
+    if (this->initialized() && this->running()) {
         this->pause();
     }
 
@@ -341,7 +512,10 @@ bool GazeboSimulator::close()
     }
 
     // Delete the simulator
-    pImpl->gazebo.server.reset();
+    pImpl->gazebo.servers.clear();
+    pImpl->gazebo.serverWorlds.clear();
+    this->clearTerminationPredicates();
+    pImpl->parallelWorlds.pool.reset();
 
     return true;
 }
@@ -359,10 +533,11 @@ bool GazeboSimulator::pause()
         return true;
     }
 
-    size_t numOfWorlds = this->worldNames().size();
-
-    for (unsigned worldIdx = 0; worldIdx < numOfWorlds; ++worldIdx) {
-        pImpl->getServer()->SetPaused(true, worldIdx);
+    for (const auto& server : pImpl->getServers()) {
+        for (unsigned worldIdx = 0; worldIdx < pImpl->gazebo.worldsPerServer;
+             ++worldIdx) {
+            server->SetPaused(true, worldIdx);
+        }
     }
 
     return !this->running();
@@ -375,7 +550,13 @@ bool GazeboSimulator::running() const
         return false;
     }
 
-    return pImpl->gazebo.server->Running();
+    for (const auto& server : pImpl->gazebo.servers) {
+        if (server->Running()) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 bool GazeboSimulator::insertWorldFromSDF(const std::string& worldFile,
@@ -473,11 +654,15 @@ std::vector<std::string> GazeboSimulator::worldNames() const
         return {};
     }
 
-    if (!scenario::plugins::gazebo::ECMSingleton::Instance().valid()) {
-        throw std::runtime_error("The ECM singleton is not valid");
+    // The singleton could also contain the worlds of other simulators
+    for (const auto& worldName : pImpl->sdfWorldNames) {
+        if (!scenario::plugins::gazebo::ECMSingleton::Instance().valid(
+                worldName)) {
+            throw std::runtime_error("The ECM singleton is not valid");
+        }
     }
 
-    return scenario::plugins::gazebo::ECMSingleton::Instance().worldNames();
+    return pImpl->sdfWorldNames;
 }
 
 std::shared_ptr<scenario::gazebo::World>
@@ -559,56 +744,63 @@ GazeboSimulator::getWorld(const std::string& worldName) const
 
 bool GazeboSimulator::Impl::insertWorld(const sdf::World& world)
 {
+    // Check that there are no worlds with the same name already stored
+    if (std::find(sdfWorldNames.begin(), sdfWorldNames.end(), world.Name())
+        != sdfWorldNames.end()) {
+        sError << "Another world with name " << world.Name()
+               << " already exists" << std::endl;
+        return false;
+    }
+
     if (!sdfElement) {
         sdfElement = sdf::SDF::WrapInRoot(world.Element()->Clone());
     }
     else {
-        // Check that there are no worlds with the same name already stored
-        auto root = utils::getSdfRootFromString(sdfElement->ToString(""));
-
-        if (!root) {
-            return false;
-        }
-
-        if (root->WorldNameExists(world.Name())) {
-            sError << "Another world with name " << world.Name()
-                   << " already exists" << std::endl;
-            return false;
-        }
-
         // Insert the new world in the DOM
         sdfElement->InsertElement(world.Element()->Clone());
     }
 
+    sdfWorldNames.push_back(world.Name());
     return true;
 }
 
-std::shared_ptr<ignition::gazebo::Server> GazeboSimulator::Impl::getServer()
+const std::vector<GazeboSimulator::Impl::ServerPtr>&
+GazeboSimulator::Impl::getServers()
 {
     // Lazy initialization of the server
-    if (!gazebo.server) {
+    if (gazebo.servers.empty()) {
+        IGN_PROFILE("GazeboSimulator::Startup");
 
         if (gazebo.numOfIterations == 0) {
             sError << "Non-deterministic mode (iterations=0) is not "
                    << "currently supported" << std::endl;
-            return nullptr;
+            return gazebo.servers;
         }
 
-        sdf::Root root;
-
         if (!sdfElement) {
             sMessage << "Using default empty world" << std::endl;
-            auto errors = root.LoadSdfString(utils::getEmptyWorld());
-            assert(errors.empty()); // TODO
+            auto root = utils::getSdfRootFromString(utils::getEmptyWorld());
+
+            if (!root || !this->insertWorld(*root->WorldByIndex(0))) {
+                sError << "Failed to insert the default empty world"
+                       << std::endl;
+                return gazebo.servers;
+            }
         }
-        else {
-            auto errors = root.LoadSdfString(sdfElement->ToString(""));
-            assert(errors.empty()); // TODO
+
+        // The worlds stored in the DOM were already validated when inserted.
+        // From now on, the DOM is never parsed again.
+        std::vector<sdf::ElementPtr> worldElements;
+
+        for (auto worldElement = sdfElement->GetElementImpl("world");
+             worldElement;
+             worldElement = worldElement->GetNextElement("world")) {
+            worldElements.push_back(worldElement);
         }
 
-        if (root.WorldCount() == 0) {
+        if (worldElements.empty()) {
             sError << "Failed to find a world in the SDF root" << std::endl;
-            return nullptr;
+            return gazebo.servers;
         }
 
         // Get the plugin info of the ECM provider
@@ -622,77 +814,280 @@ std::shared_ptr<ignition::gazebo::Server> GazeboSimulator::Impl::getServer()
             return pluginInfo;
         };
 
-        // Check if there are sdf parsing errors
-        assert(utils::sdfStringValid(root.Element()->Clone()->ToString("")));
-
         // There is no way yet to set the physics step size if not passing
         // through the physics element of the SDF. We update here the SDF
         // overriding the default profile.
         // NOTE: this could be avoided if gazebo::Server would expose the
         //       SimulationRunner::SetStepSize method.
-        for (size_t worldIdx = 0; worldIdx < root.WorldCount(); ++worldIdx) {
-            if (!utils::updateSDFPhysics(root,
-                                         gazebo.physics.maxStepSize,
-                                         gazebo.physics.rtf,
-                                         /*realTimeUpdateRate=*/-1,
-                                         worldIdx)) {
-                sError << "Failed to set physics profile" << std::endl;
-                return nullptr;
+        {
+            IGN_PROFILE("GazeboSimulator::Startup::UpdatePhysics");
+
+            for (const auto& worldElement : worldElements) {
+                if (!utils::updateSDFPhysics(worldElement,
+                                             gazebo.physics.maxStepSize,
+                                             gazebo.physics.rtf,
+                                             /*realTimeUpdateRate=*/-1)) {
+                    sError << "Failed to set physics profile" << std::endl;
+                    return gazebo.servers;
+                }
             }
-
-            assert(Impl::getPhysicsData(root, worldIdx) == gazebo.physics);
         }
 
         sDebug << "Physics profile:" << std::endl
                << this->gazebo.physics << std::endl;
 
-        if (utils::verboseFromEnvironment()) {
-            sDebug << "Loading the following SDF file in the gazebo server:"
-                   << std::endl;
-            std::cout << root.Element()->ToString("") << std::endl;
-        }
+        auto getServerConfig = [&](const std::string& sdfString) {
+            ignition::gazebo::ServerConfig config;
+
+            config.SetSeed(0);
+            config.SetUseLevels(false);
+            config.SetSdfString(sdfString);
+
+            if (utils::verboseFromEnvironment()) {
+                sDebug << "Loading the following SDF file in the gazebo "
+                       << "server:" << std::endl
+                       << sdfString << std::endl;
+            }
+
+            return config;
+        };
 
-        ignition::gazebo::ServerConfig config;
+        std::vector<ServerPtr> servers;
+        std::vector<std::vector<std::string>> serverWorlds;
+
+        if (parallelWorlds.enabled) {
+            // Create a server for each world. Servers do not share any
+            // resource and can be safely stepped from different threads.
+            for (const auto& worldElement : worldElements) {
+                const auto worldName = worldElement->Get<std::string>("name");
+                ignition::gazebo::ServerConfig config;
+
+                {
+                    IGN_PROFILE("GazeboSimulator::Startup::SerializeSDF");
+                    config = getServerConfig(
+                        sdf::SDF::WrapInRoot(worldElement->Clone())
+                            ->ToString(""));
+                    config.AddPlugin(getECMPluginInfo(worldName));
+                }
+
+                IGN_PROFILE("GazeboSimulator::Startup::CreateServer");
+                servers.push_back(
+                    std::make_shared<ignition::gazebo::Server>(config));
+                serverWorlds.push_back({worldName});
+            }
 
-        config.SetSeed(0);
-        config.SetUseLevels(false);
-        config.SetSdfString(root.Element()->ToString(""));
+            gazebo.worldsPerServer = 1;
+            parallelWorlds.pool = std::make_unique<core::utils::ThreadPool>(
+                parallelWorlds.numOfThreads);
 
-        // Add the ECMProvider plugin for all worlds
-        for (size_t worldIdx = 0; worldIdx < root.WorldCount(); ++worldIdx) {
-            auto worldName = root.WorldByIndex(worldIdx)->Name();
-            config.AddPlugin(getECMPluginInfo(worldName));
+            sDebug << "Stepping " << servers.size() << " worlds in parallel "
+                   << "with " << parallelWorlds.pool->numOfThreads()
+                   << " threads" << std::endl;
         }
+        else {
+            ignition::gazebo::ServerConfig config;
+            serverWorlds.emplace_back();
+
+            {
+                // This is the only serialization of the DOM, that is required
+                // since the server can only be configured from a string
+                IGN_PROFILE("GazeboSimulator::Startup::SerializeSDF");
+                config = getServerConfig(sdfElement->ToString(""));
+
+                // Add the ECMProvider plugin for all worlds
+                for (const auto& worldElement : worldElements) {
+                    const auto worldName =
+                        worldElement->Get<std::string>("name");
+                    config.AddPlugin(getECMPluginInfo(worldName));
+                    serverWorlds.front().push_back(worldName);
+                }
+            }
 
-        // Create the server
-        auto server = std::make_shared<ignition::gazebo::Server>(config);
-        assert(server);
+            IGN_PROFILE("GazeboSimulator::Startup::CreateServer");
+            servers.push_back(
+                std::make_shared<ignition::gazebo::Server>(config));
+            gazebo.worldsPerServer = worldElements.size();
+        }
 
         sDebug << "Starting the gazebo server" << std::endl;
 
-        if (!server->RunOnce(/*paused=*/true)) {
-            sError << "Failed to initialize the first gazebo server run"
-                   << std::endl;
-            return nullptr;
+        {
+            IGN_PROFILE("GazeboSimulator::Startup::FirstRun");
+
+            for (auto& server : servers) {
+                assert(server);
+
+                if (!server->RunOnce(/*paused=*/true)) {
+                    sError << "Failed to initialize the first gazebo server run"
+                           << std::endl;
+                    parallelWorlds.pool.reset();
+                    return gazebo.servers;
+                }
+            }
         }
 
-        for (size_t worldIdx = 0; worldIdx < root.WorldCount(); ++worldIdx) {
+        IGN_PROFILE("GazeboSimulator::Startup::PostProcessWorlds");
+
+        for (const auto& worldElement : worldElements) {
             // Get the world name
-            const auto& worldName = root.WorldByIndex(worldIdx)->Name();
+            const auto worldName = worldElement->Get<std::string>("name");
 
             // Post-process the world
             if (!this->postProcessWorld(worldName)) {
                 sError << "Failed to post-process world " << worldName
                        << std::endl;
-                return nullptr;
+                parallelWorlds.pool.reset();
+                return gazebo.servers;
+            }
+        }
+
+        // Store the servers
+        gazebo.servers = std::move(servers);
+        gazebo.serverWorlds = std::move(serverWorlds);
+    }
+
+    return gazebo.servers;
+}
+
+bool GazeboSimulator::Impl::runServer(const size_t serverIdx,
+                                      const bool paused)
+{
+    auto& server = *gazebo.servers[serverIdx];
+
+    // If the server was configured to run in background (iterations = 0)
+    // only the first call to this run method should trigger the start of
+    // the simulation in non-blocking mode.
+    // NOTE: non-blocking implementation is partial and not supported
+    bool deterministic = gazebo.numOfIterations != 0 ? true : false;
+
+    if (!deterministic && server.Running()) {
+        sWarning << "The server is already running in background" << std::endl;
+        return true;
+    }
+
+    size_t iterations = gazebo.numOfIterations;
+
+    // Allow executing a single paused step in non-blocking mode,
+    // allowing to refresh the visualized world state
+    if (!deterministic && !server.Running() && paused) {
+        deterministic = true;
+        iterations = 1;
+    }
+
+    if (paused && !server.RunOnce(/*paused=*/true)) {
+        sError << "The server couldn't execute the paused step" << std::endl;
+        return false;
+    }
+
+    if (paused) {
+        return true;
+    }
+
+    // Get the termination predicates of the worlds simulated by the server
+    std::vector<const TerminationPredicate*> predicates;
+
+    {
+        std::lock_guard lock(termination.mutex);
+
+        for (const auto& predicate : termination.predicates) {
+            const auto& worlds = gazebo.serverWorlds[serverIdx];
+
+            if (std::find(worlds.begin(), worlds.end(), predicate.worldName)
+                != worlds.end()) {
+                predicates.push_back(&predicate);
+            }
+        }
+    }
+
+    // Run the simulation
+    if (!deterministic || predicates.empty()) {
+        if (!server.Run(/*blocking=*/deterministic,
+                        /*iterations=*/iterations,
+                        /*paused=*/false)) {
+            sError << "The server couldn't execute the step" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Run the simulation one step at a time and stop as soon as a predicate
+    // fires. Worlds simulated by the same server are all stopped.
+    for (size_t step = 1; step <= iterations; ++step) {
+        if (!server.Run(/*blocking=*/true,
+                        /*iterations=*/1,
+                        /*paused=*/false)) {
+            sError << "The server couldn't execute the step" << std::endl;
+            return false;
+        }
+
+        bool terminated = false;
+
+        for (const auto* predicate : predicates) {
+            if (!predicate->fired()) {
+                continue;
             }
+
+            sDebug << "Termination predicate '" << predicate->name
+                   << "' fired in world '" << predicate->worldName
+                   << "' at step " << step << std::endl;
+
+            std::lock_guard lock(termination.mutex);
+            termination.terminations.push_back(
+                {predicate->name, predicate->worldName, step});
+            terminated = true;
         }
 
-        // Store the server
-        gazebo.server = server;
+        if (terminated) {
+            break;
+        }
     }
 
-    return gazebo.server;
+    return true;
+}
+
+bool GazeboSimulator::Impl::addTerminationPredicate(
+    const GazeboSimulator& simulator,
+    const std::string& name,
+    const std::string& modelName,
+    const std::string& worldName,
+    std::function<bool(core::ModelPtr)> fired)
+{
+    std::shared_ptr<World> world = simulator.getWorld(worldName);
+
+    if (!world) {
+        sError << "Failed to get world '" << worldName << "'" << std::endl;
+        return false;
+    }
+
+    core::ModelPtr model;
+
+    try {
+        model = world->getModel(modelName);
+    }
+    catch (const std::exception& e) {
+        sError << e.what() << std::endl;
+        return false;
+    }
+
+    auto predicate = [model, fired = std::move(fired)]() {
+        // The model could have been removed from the world
+        if (!model->valid()) {
+            return false;
+        }
+
+        try {
+            return fired(model);
+        }
+        catch (const std::exception& e) {
+            sError << e.what() << std::endl;
+            return false;
+        }
+    };
+
+    std::lock_guard lock(termination.mutex);
+    termination.predicates.push_back({name, world->name(), predicate});
+    return true;
 }
 
 bool GazeboSimulator::Impl::postProcessWorld(const std::string& worldName)
@@ -731,19 +1126,40 @@ bool GazeboSimulator::Impl::postProcessWorld(const std::string& worldName)
     return true;
 }
 
-detail::PhysicsData
-GazeboSimulator::Impl::getPhysicsData(const sdf::Root& root,
-                                      const size_t worldIndex)
+bool GazeboSimulator::Impl::setWorldPhysics(const std::string& worldName,
+                                            const double stepSize)
 {
-    const sdf::World* world = root.WorldByIndex(worldIndex);
-    assert(world->PhysicsCount() == 1);
+    auto* ecm = plugins::gazebo::ECMSingleton::Instance().getECM(worldName);
 
-    detail::PhysicsData physics;
+    if (!ecm) {
+        return false;
+    }
 
-    physics.rtf = world->PhysicsByIndex(0)->RealTimeFactor();
-    physics.maxStepSize = world->PhysicsByIndex(0)->MaxStepSize();
+    auto worldEntity =
+        ecm->EntityByComponents(ignition::gazebo::components::World(),
+                                ignition::gazebo::components::Name(worldName));
+
+    if (worldEntity == ignition::gazebo::kNullEntity) {
+        sError << "Couldn't find world entity" << std::endl;
+        return false;
+    }
 
-    return physics;
+    ignition::msgs::Physics physicsMsg;
+    physicsMsg.set_max_step_size(stepSize);
+    physicsMsg.set_real_time_factor(gazebo.physics.rtf);
+
+    // The command is processed by the SimulationRunner before the next step,
+    // that updates its step size and removes the component
+    using ignition::gazebo::components::PhysicsCmd;
+
+    if (auto* physicsCmd = ecm->Component<PhysicsCmd>(worldEntity)) {
+        physicsCmd->Data() = physicsMsg;
+    }
+    else {
+        ecm->CreateComponent(worldEntity, PhysicsCmd(physicsMsg));
+    }
+
+    return true;
 }
 
 bool GazeboSimulator::Impl::sceneBroadcasterActive(const std::string& worldName)
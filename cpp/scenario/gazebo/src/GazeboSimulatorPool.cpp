@@ -0,0 +1,712 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scenario/gazebo/GazeboSimulatorPool.h"
+#include "scenario/gazebo/GazeboSimulator.h"
+#include "scenario/gazebo/Joint.h"
+#include "scenario/gazebo/Log.h"
+#include "scenario/gazebo/Model.h"
+#include "scenario/gazebo/World.h"
+#include "scenario/gazebo/components/BasePoseTarget.h"
+#include "scenario/gazebo/components/BaseWorldAccelerationTarget.h"
+#include "scenario/gazebo/components/BaseWorldVelocityTarget.h"
+#include "scenario/gazebo/components/JointAccelerationTarget.h"
+#include "scenario/gazebo/components/JointPID.h"
+#include "scenario/gazebo/components/JointPositionTarget.h"
+#include "scenario/gazebo/components/JointVelocityTarget.h"
+#include "scenario/gazebo/helpers.h"
+
+#include <ignition/common/Event.hh>
+#include <ignition/gazebo/EntityComponentManager.hh>
+#include <ignition/gazebo/Events.hh>
+#include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/world_control.pb.h>
+#include <ignition/transport/Node.hh>
+#include <sdf/Element.hh>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace scenario::gazebo;
+
+template <typename ComponentTypeT>
+using ComponentSnapshot = std::optional<typename ComponentTypeT::Type>;
+
+struct JointState
+{
+    core::JointControlMode controlMode;
+    ComponentSnapshot<ignition::gazebo::components::JointPID> pid;
+    ComponentSnapshot<ignition::gazebo::components::JointPositionTarget>
+        positionTarget;
+    ComponentSnapshot<ignition::gazebo::components::JointVelocityTarget>
+        velocityTarget;
+    ComponentSnapshot<ignition::gazebo::components::JointAccelerationTarget>
+        accelerationTarget;
+};
+
+struct ModelState
+{
+    ignition::gazebo::Entity entity;
+    std::array<double, 3> basePosition;
+    std::array<double, 4> baseOrientation;
+    std::array<double, 3> baseWorldLinearVelocity;
+    std::array<double, 3> baseWorldAngularVelocity;
+    std::vector<double> jointPositions;
+    std::vector<double> jointVelocities;
+    std::unordered_map<std::string, JointState> joints;
+
+    ComponentSnapshot<ignition::gazebo::components::BasePoseTarget>
+        basePoseTarget;
+    ComponentSnapshot<
+        ignition::gazebo::components::BaseWorldLinearVelocityTarget>
+        baseWorldLinearVelocityTarget;
+    ComponentSnapshot<
+        ignition::gazebo::components::BaseWorldAngularVelocityTarget>
+        baseWorldAngularVelocityTarget;
+    ComponentSnapshot<
+        ignition::gazebo::components::BaseWorldLinearAccelerationTarget>
+        baseWorldLinearAccelerationTarget;
+    ComponentSnapshot<
+        ignition::gazebo::components::BaseWorldAngularAccelerationTarget>
+        baseWorldAngularAccelerationTarget;
+};
+
+struct LoadedPlugin
+{
+    ignition::gazebo::Entity entity;
+    std::vector<std::string> fileNames;
+};
+
+struct WorldState
+{
+    std::unordered_map<std::string, ModelState> models;
+
+    // Plugins loaded after the snapshot. Systems cannot be unloaded from a
+    // running server, therefore they are tracked to detect the simulators
+    // that cannot be restored in place.
+    std::shared_ptr<std::vector<LoadedPlugin>> loadedPlugins;
+};
+
+class PooledSimulator final : public GazeboSimulator
+{
+public:
+    using GazeboSimulator::GazeboSimulator;
+
+    // The connections to the events of the server must be dropped before the
+    // server and its event managers are destroyed, also when the simulator
+    // is closed by the user while acquired. The destructor of the base class
+    // closes the simulator after the connections are destroyed.
+    bool close() override
+    {
+        connections.clear();
+        return GazeboSimulator::close();
+    }
+
+    std::vector<ignition::common::ConnectionPtr> connections;
+};
+
+struct PoolEntry
+{
+    bool available = true;
+    std::shared_ptr<PooledSimulator> simulator;
+    std::unordered_map<std::string, WorldState> worlds;
+};
+
+template <typename ComponentTypeT>
+ComponentSnapshot<ComponentTypeT>
+takeSnapshot(ignition::gazebo::EntityComponentManager* ecm,
+             const ignition::gazebo::Entity entity)
+{
+    const auto* component = ecm->Component<ComponentTypeT>(entity);
+
+    if (!component) {
+        return {};
+    }
+
+    return component->Data();
+}
+
+template <typename ComponentTypeT>
+void restoreSnapshot(ignition::gazebo::EntityComponentManager* ecm,
+                     const ignition::gazebo::Entity entity,
+                     const ComponentSnapshot<ComponentTypeT>& snapshot)
+{
+    if (!snapshot) {
+        ecm->RemoveComponent(entity, ComponentTypeT().TypeId());
+        return;
+    }
+
+    if (auto* component = ecm->Component<ComponentTypeT>(entity)) {
+        component->Data() = snapshot.value();
+    }
+    else {
+        ecm->CreateComponent(entity, ComponentTypeT(snapshot.value()));
+    }
+}
+
+static std::vector<std::string> pluginFileNames(const sdf::ElementPtr& element)
+{
+    std::vector<std::string> fileNames;
+
+    if (!element) {
+        return fileNames;
+    }
+
+    if (element->GetName() == "plugin" && element->HasAttribute("filename")) {
+        fileNames.push_back(element->Get<std::string>("filename"));
+    }
+
+    // Plugins could be nested, e.g. in the SDF of an inserted model
+    for (auto child = element->GetFirstElement(); child;
+         child = child->GetNextElement()) {
+        auto childFileNames = pluginFileNames(child);
+        fileNames.insert(
+            fileNames.end(), childFileNames.begin(), childFileNames.end());
+    }
+
+    return fileNames;
+}
+
+class GazeboSimulatorPool::Impl
+{
+public:
+    size_t size;
+    double stepSize;
+    double rtf;
+    size_t stepsPerRun;
+    std::string worldFile;
+    PhysicsEngine engine;
+
+    bool initialized = false;
+
+    mutable std::mutex mutex;
+    std::vector<PoolEntry> entries;
+
+    bool createEntry(PoolEntry& entry) const;
+    static std::string uniqueWorldName();
+    static bool storeState(PoolEntry& entry);
+    bool restoreState(PoolEntry& entry) const;
+    static bool restorablePlugins(const WorldState& worldState);
+    static bool rewindTime(GazeboSimulator& simulator);
+};
+
+GazeboSimulatorPool::GazeboSimulatorPool(const size_t size,
+                                         const double stepSize,
+                                         const double rtf,
+                                         const size_t stepsPerRun,
+                                         const std::string& worldFile,
+                                         const PhysicsEngine engine)
+    : pImpl{std::make_unique<Impl>()}
+{
+    pImpl->size = size;
+    pImpl->stepSize = stepSize;
+    pImpl->rtf = rtf;
+    pImpl->stepsPerRun = stepsPerRun;
+    pImpl->worldFile = worldFile;
+    pImpl->engine = engine;
+}
+
+GazeboSimulatorPool::~GazeboSimulatorPool()
+{
+    std::lock_guard lock(pImpl->mutex);
+
+    for (auto& entry : pImpl->entries) {
+        if (entry.simulator && entry.available) {
+            entry.simulator->close();
+        }
+    }
+}
+
+bool GazeboSimulatorPool::initialize()
+{
+    std::lock_guard lock(pImpl->mutex);
+
+    if (pImpl->initialized) {
+        sWarning << "The simulator pool is already initialized" << std::endl;
+        return true;
+    }
+
+    if (pImpl->size == 0) {
+        sError << "The simulator pool must contain at least one simulator"
+               << std::endl;
+        return false;
+    }
+
+    pImpl->entries.resize(pImpl->size);
+
+    for (auto& entry : pImpl->entries) {
+        if (!pImpl->createEntry(entry)) {
+            sError << "Failed to create a simulator of the pool" << std::endl;
+            pImpl->entries.clear();
+            return false;
+        }
+    }
+
+    sDebug << "Initialized a pool of " << pImpl->size << " simulators"
+           << std::endl;
+
+    pImpl->initialized = true;
+    return true;
+}
+
+size_t GazeboSimulatorPool::size() const
+{
+    return pImpl->size;
+}
+
+size_t GazeboSimulatorPool::available() const
+{
+    std::lock_guard lock(pImpl->mutex);
+
+    return static_cast<size_t>(
+        std::count_if(pImpl->entries.begin(),
+                      pImpl->entries.end(),
+                      [](const PoolEntry& entry) { return entry.available; }));
+}
+
+std::shared_ptr<GazeboSimulator> GazeboSimulatorPool::acquire()
+{
+    std::lock_guard lock(pImpl->mutex);
+
+    if (!pImpl->initialized) {
+        sError << "The simulator pool was not initialized" << std::endl;
+        return nullptr;
+    }
+
+    for (auto& entry : pImpl->entries) {
+        if (entry.available) {
+            entry.available = false;
+            return entry.simulator;
+        }
+    }
+
+    sWarning << "No simulators are available in the pool" << std::endl;
+    return nullptr;
+}
+
+bool GazeboSimulatorPool::release(
+    const std::shared_ptr<GazeboSimulator>& simulator)
+{
+    std::lock_guard lock(pImpl->mutex);
+
+    auto it = std::find_if(
+        pImpl->entries.begin(),
+        pImpl->entries.end(),
+        [&](const PoolEntry& entry) { return entry.simulator == simulator; });
+
+    if (!simulator || it == pImpl->entries.end()) {
+        sError << "The simulator does not belong to the pool" << std::endl;
+        return false;
+    }
+
+    if (it->available) {
+        sWarning << "The simulator was already released" << std::endl;
+        return true;
+    }
+
+    if (pImpl->restoreState(*it)) {
+        it->available = true;
+        return true;
+    }
+
+    // Replacing the simulator costs as much as not using the pool
+    sError << "Failed to restore the state of the released simulator, "
+           << "replacing it with a new one" << std::endl;
+
+    it->simulator->close();
+    *it = {};
+
+    if (!pImpl->createEntry(*it)) {
+        sError << "Failed to replace the simulator of the pool" << std::endl;
+        it->available = false;
+        return false;
+    }
+
+    return true;
+}
+
+// ===============
+// Implementations
+// ===============
+
+std::string GazeboSimulatorPool::Impl::uniqueWorldName()
+{
+    // World names must be unique within the process since the worlds of all
+    // the simulators are registered in the same ECM singleton
+    static std::atomic<size_t> counter{0};
+    return "pool_world" + std::to_string(counter++);
+}
+
+bool GazeboSimulatorPool::Impl::createEntry(PoolEntry& entry) const
+{
+    auto simulator =
+        std::make_shared<PooledSimulator>(stepSize, rtf, stepsPerRun);
+
+    if (!simulator->insertWorldFromSDF(worldFile, uniqueWorldName())) {
+        sError << "Failed to insert the world" << std::endl;
+        return false;
+    }
+
+    if (!simulator->initialize()) {
+        sError << "Failed to initialize the simulator" << std::endl;
+        return false;
+    }
+
+    for (const auto& worldName : simulator->worldNames()) {
+        if (!simulator->getWorld(worldName)->setPhysicsEngine(engine)) {
+            sError << "Failed to insert the physics in world '" << worldName
+                   << "'" << std::endl;
+            return false;
+        }
+    }
+
+    // Process the physics insertion
+    if (!simulator->run(/*paused=*/true)) {
+        sError << "Failed to run the simulator" << std::endl;
+        return false;
+    }
+
+    entry.simulator = simulator;
+
+    if (!storeState(entry)) {
+        sError << "Failed to store the initial state" << std::endl;
+        return false;
+    }
+
+    entry.available = true;
+    return true;
+}
+
+bool GazeboSimulatorPool::Impl::storeState(PoolEntry& entry)
+{
+    using namespace ignition::gazebo;
+
+    try {
+        for (const auto& worldName : entry.simulator->worldNames()) {
+            auto world = std::static_pointer_cast<World>(
+                entry.simulator->getWorld(worldName));
+            WorldState& worldState = entry.worlds[worldName];
+            auto* ecm = world->ecm();
+
+            for (const auto& modelName : world->modelNames()) {
+                auto model =
+                    std::static_pointer_cast<Model>(world->getModel(modelName));
+
+                const BaseState baseState = model->baseState();
+                const Entity modelEntity = model->entity();
+
+                ModelState state;
+                state.entity = modelEntity;
+                state.basePosition = baseState.pose.position;
+                state.baseOrientation = baseState.pose.orientation;
+                state.baseWorldLinearVelocity = baseState.worldLinearVelocity;
+                state.baseWorldAngularVelocity = baseState.worldAngularVelocity;
+                state.jointPositions = model->jointPositions();
+                state.jointVelocities = model->jointVelocities();
+
+                state.basePoseTarget = takeSnapshot< //
+                    components::BasePoseTarget>(ecm, modelEntity);
+                state.baseWorldLinearVelocityTarget = takeSnapshot<
+                    components::BaseWorldLinearVelocityTarget>(ecm,
+                                                               modelEntity);
+                state.baseWorldAngularVelocityTarget = takeSnapshot<
+                    components::BaseWorldAngularVelocityTarget>(ecm,
+                                                                modelEntity);
+                state.baseWorldLinearAccelerationTarget = takeSnapshot<
+                    components::BaseWorldLinearAccelerationTarget>(
+                    ecm, modelEntity);
+                state.baseWorldAngularAccelerationTarget = takeSnapshot<
+                    components::BaseWorldAngularAccelerationTarget>(
+                    ecm, modelEntity);
+
+                for (const auto& jointName : model->jointNames()) {
+                    auto joint = std::static_pointer_cast<Joint>(
+                        model->getJoint(jointName));
+                    const Entity jointEntity = joint->entity();
+
+                    JointState& jointState = state.joints[jointName];
+                    jointState.controlMode = joint->controlMode();
+                    jointState.pid = takeSnapshot< //
+                        components::JointPID>(ecm, jointEntity);
+                    jointState.positionTarget = takeSnapshot<
+                        components::JointPositionTarget>(ecm, jointEntity);
+                    jointState.velocityTarget = takeSnapshot<
+                        components::JointVelocityTarget>(ecm, jointEntity);
+                    jointState.accelerationTarget = takeSnapshot<
+                        components::JointAccelerationTarget>(ecm,
+                                                             jointEntity);
+                }
+
+                worldState.models[modelName] = std::move(state);
+            }
+
+            // Track the plugins loaded from now on
+            auto loadedPlugins = std::make_shared<std::vector<LoadedPlugin>>();
+            worldState.loadedPlugins = loadedPlugins;
+            entry.simulator->connections.push_back(
+                world->eventManager()->Connect<events::LoadPlugins>(
+                    [loadedPlugins](const Entity entity,
+                                    const sdf::ElementPtr& element) {
+                        loadedPlugins->push_back(
+                            {entity, pluginFileNames(element)});
+                    }));
+        }
+    }
+    catch (const std::exception& e) {
+        sError << e.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool GazeboSimulatorPool::Impl::restoreState(PoolEntry& entry) const
+{
+    using namespace ignition::gazebo;
+    auto& simulator = entry.simulator;
+
+    if (!simulator->initialized()) {
+        sError << "The released simulator was closed" << std::endl;
+        return false;
+    }
+
+    // Pause the simulator in case it was left running in non-deterministic
+    // mode
+    if (simulator->running() && !simulator->pause()) {
+        sError << "Failed to pause the simulator" << std::endl;
+        return false;
+    }
+
+    for (const auto& [worldName, worldState] : entry.worlds) {
+        if (!restorablePlugins(worldState)) {
+            sDebug << "World '" << worldName << "' loaded plugins that cannot "
+                   << "be unloaded" << std::endl;
+            return false;
+        }
+    }
+
+    try {
+        for (const auto& [worldName, worldState] : entry.worlds) {
+            auto world =
+                std::static_pointer_cast<World>(simulator->getWorld(worldName));
+            auto* ecm = world->ecm();
+
+            // Remove the models inserted after the creation of the pool
+            for (const auto& modelName : world->modelNames()) {
+                if (worldState.models.find(modelName)
+                        == worldState.models.end()
+                    && !world->removeModel(modelName)) {
+                    sError << "Failed to remove model '" << modelName << "'"
+                           << std::endl;
+                    return false;
+                }
+            }
+
+            for (const auto& [modelName, state] : worldState.models) {
+                auto model =
+                    std::static_pointer_cast<Model>(world->getModel(modelName));
+
+                bool ok = true;
+                ok = ok
+                     && model->resetBasePose(state.basePosition,
+                                             state.baseOrientation);
+                ok = ok
+                     && model->resetBaseWorldVelocity(
+                         state.baseWorldLinearVelocity,
+                         state.baseWorldAngularVelocity);
+                ok = ok && model->resetJointPositions(state.jointPositions);
+                ok = ok && model->resetJointVelocities(state.jointVelocities);
+
+                // The control mode is restored first since changing it
+                // resets the targets and the PID
+                for (const auto& [jointName, jointState] : state.joints) {
+                    auto joint = std::static_pointer_cast<Joint>(
+                        model->getJoint(jointName));
+                    const Entity jointEntity = joint->entity();
+
+                    ok = ok && joint->setControlMode(jointState.controlMode);
+
+                    restoreSnapshot<components::JointPID>(
+                        ecm, jointEntity, jointState.pid);
+                    restoreSnapshot<components::JointPositionTarget>(
+                        ecm, jointEntity, jointState.positionTarget);
+                    restoreSnapshot<components::JointVelocityTarget>(
+                        ecm, jointEntity, jointState.velocityTarget);
+                    restoreSnapshot<components::JointAccelerationTarget>(
+                        ecm, jointEntity, jointState.accelerationTarget);
+                }
+
+                restoreSnapshot<components::BasePoseTarget>(
+                    ecm, state.entity, state.basePoseTarget);
+                restoreSnapshot<components::BaseWorldLinearVelocityTarget>(
+                    ecm, state.entity, state.baseWorldLinearVelocityTarget);
+                restoreSnapshot<components::BaseWorldAngularVelocityTarget>(
+                    ecm, state.entity, state.baseWorldAngularVelocityTarget);
+                restoreSnapshot<components::BaseWorldLinearAccelerationTarget>(
+                    ecm, state.entity, state.baseWorldLinearAccelerationTarget);
+                restoreSnapshot<components::BaseWorldAngularAccelerationTarget>(
+                    ecm,
+                    state.entity,
+                    state.baseWorldAngularAccelerationTarget);
+
+                // Make the controllers read the restored references
+                utils::updateReferencesVersion(ecm, state.entity);
+
+                if (!ok) {
+                    sError << "Failed to restore the state of model '"
+                           << modelName << "'" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        sError << e.what() << std::endl;
+        return false;
+    }
+
+    if (!simulator->setStepSize(stepSize)
+        || !simulator->setStepsPerRun(stepsPerRun)) {
+        sError << "Failed to restore the simulator parameters" << std::endl;
+        return false;
+    }
+
+    // Process the model removals and the state resets
+    if (!simulator->run(/*paused=*/true)) {
+        sError << "Failed to run the simulator" << std::endl;
+        return false;
+    }
+
+    if (!rewindTime(*simulator)) {
+        sError << "Failed to rewind the simulated time" << std::endl;
+        return false;
+    }
+
+    // Forget the plugins loaded by the JointController of restored models
+    for (auto& [worldName, worldState] : entry.worlds) {
+        worldState.loadedPlugins->clear();
+    }
+
+    return true;
+}
+
+bool GazeboSimulatorPool::Impl::restorablePlugins(const WorldState& worldState)
+{
+    for (const auto& plugin : *worldState.loadedPlugins) {
+        // The JointController of the original models is the only plugin that
+        // is kept. It is inserted the first time the joints are controlled in
+        // position or velocity, and it is idle once the control mode of the
+        // joints is restored.
+        const bool originalModel =
+            std::any_of(worldState.models.begin(),
+                        worldState.models.end(),
+                        [&](const auto& model) {
+                            return model.second.entity == plugin.entity;
+                        });
+
+        const bool onlyJointController =
+            !plugin.fileNames.empty()
+            && std::all_of(plugin.fileNames.begin(),
+                           plugin.fileNames.end(),
+                           [](const std::string& fileName) {
+                               return fileName == "JointController";
+                           });
+
+        if (!(originalModel && onlyJointController)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool GazeboSimulatorPool::Impl::rewindTime(GazeboSimulator& simulator)
+{
+    ignition::transport::Node node;
+
+    for (const auto& worldName : simulator.worldNames()) {
+        ignition::msgs::WorldControl request;
+        request.set_pause(true);
+        request.mutable_reset()->set_all(true);
+
+        bool result = false;
+        ignition::msgs::Boolean response;
+        constexpr unsigned timeoutMs = 5000;
+
+        // The request is buffered by the server and processed by the
+        // following runs
+        if (!node.Request("/world/" + worldName + "/control",
+                          request,
+                          timeoutMs,
+                          response,
+                          result)
+            || !result || !response.data()) {
+            sError << "Failed to request the rewind of world '" << worldName
+                   << "'" << std::endl;
+            return false;
+        }
+    }
+
+    auto rewound = [&]() {
+        for (const auto& worldName : simulator.worldNames()) {
+            if (simulator.getWorld(worldName)->time() != 0.0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // The accepted requests are processed by the servers within the next
+    // paused runs, that do not advance the time. The rewind is acknowledged
+    // by the simulated time of the worlds stored in their ECM.
+    constexpr size_t maxRuns = 10;
+
+    for (size_t run = 0; run < maxRuns; ++run) {
+        if (!simulator.run(/*paused=*/true)) {
+            sError << "Failed to run the simulator" << std::endl;
+            return false;
+        }
+
+        if (rewound()) {
+            sDebug << "Simulated time rewound after " << run + 1 << " runs"
+                   << std::endl;
+            return true;
+        }
+    }
+
+    sError << "The servers did not rewind the simulated time after "
+           << maxRuns << " runs" << std::endl;
+    return false;
+}
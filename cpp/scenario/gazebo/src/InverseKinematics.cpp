@@ -0,0 +1,663 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scenario/gazebo/InverseKinematics.h"
+#include "scenario/gazebo/Joint.h"
+#include "scenario/gazebo/Log.h"
+#include "scenario/gazebo/Model.h"
+#include "scenario/gazebo/helpers.h"
+
+#include <Eigen/Dense>
+#include <ignition/gazebo/components/ChildLinkName.hh>
+#include <ignition/gazebo/components/JointAxis.hh>
+#include <ignition/gazebo/components/ParentLinkName.hh>
+#include <ignition/gazebo/components/Pose.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+#include <sdf/JointAxis.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace scenario::gazebo;
+
+using Matrix6X = Eigen::Matrix<double, 6, Eigen::Dynamic>;
+using Vector6d = Eigen::Matrix<double, 6, 1>;
+using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+struct ChainElement
+{
+    core::JointPtr joint;
+    core::JointType type = core::JointType::Fixed;
+
+    // Fixed transforms measured when the solver is initialized
+    Eigen::Isometry3d parent_H_joint0 = Eigen::Isometry3d::Identity();
+    Eigen::Isometry3d joint_H_child = Eigen::Isometry3d::Identity();
+
+    // Unit axis of the joint expressed in the joint frame
+    Eigen::Vector3d axis = Eigen::Vector3d::Zero();
+
+    // Index of the joint in the optimized variables, -1 if not optimized
+    int index = -1;
+};
+
+class InverseKinematics::Impl
+{
+public:
+    std::shared_ptr<Model> model;
+
+    // The chain starts from the world if the base link is not set
+    core::LinkPtr baseLink;
+    std::vector<ChainElement> chain;
+    std::vector<std::string> jointNames;
+
+    double damping = 0.05;
+    size_t maxIterations = 100;
+    double tolerance = 1e-4;
+    double rotationWeight = 1.0;
+
+    Eigen::VectorXd lowerLimits;
+    Eigen::VectorXd upperLimits;
+    Eigen::VectorXd warmStart;
+
+    std::vector<double> solution;
+    std::vector<double> residuals;
+
+    // Buffers allocated when the solver is initialized
+    Eigen::VectorXd q;
+    Eigen::VectorXd dq;
+    Matrix6X jacobian;
+    std::vector<double> chainPositions;
+    std::vector<Eigen::Vector3d> worldAxes;
+    std::vector<Eigen::Vector3d> worldOrigins;
+
+    static Eigen::Isometry3d ToEigen(const std::array<double, 3>& position,
+                                     const std::array<double, 4>& orientation);
+    static Eigen::Isometry3d ToEigen(const ignition::math::Pose3d& pose);
+    static Eigen::Isometry3d Motion(const ChainElement& element,
+                                    const double position);
+
+    Eigen::Isometry3d worldBaseTransform() const;
+    bool readChainPositions(std::vector<double>& positions) const;
+
+    Eigen::Isometry3d kinematics(const Eigen::VectorXd& jointPositions,
+                                 const Eigen::Isometry3d& world_H_base,
+                                 std::vector<double>& positions,
+                                 Matrix6X* frameJacobian);
+
+    double solveTarget(const Eigen::Isometry3d& target,
+                       const Eigen::Isometry3d& world_H_base);
+};
+
+InverseKinematics::InverseKinematics()
+    : pImpl{std::make_unique<Impl>()}
+{}
+
+InverseKinematics::~InverseKinematics() = default;
+
+bool InverseKinematics::initialize(std::shared_ptr<Model> model,
+                                   const std::string& frame,
+                                   const std::vector<std::string>& jointNames)
+{
+    using namespace ignition::gazebo;
+
+    if (!(model && model->valid())) {
+        sError << "The model is not valid" << std::endl;
+        return false;
+    }
+
+    // Map the child links to the joints of the model
+    std::unordered_map<std::string, std::shared_ptr<Joint>> childToJoint;
+
+    for (const auto& jointName : model->jointNames()) {
+        auto joint =
+            std::static_pointer_cast<Joint>(model->getJoint(jointName));
+
+        const std::string& childLinkName = utils::getExistingComponentData<
+            components::ChildLinkName>(joint->ecm(), joint->entity());
+
+        childToJoint[childLinkName] = joint;
+    }
+
+    const auto linkNames = model->linkNames();
+
+    if (std::find(linkNames.begin(), linkNames.end(), frame)
+        == linkNames.end()) {
+        sError << "Failed to find link '" << frame << "' in model '"
+               << model->name() << "'" << std::endl;
+        return false;
+    }
+
+    // Walk the tree from the frame towards the base link
+    std::string linkName = frame;
+    std::vector<std::shared_ptr<Joint>> chainJoints;
+
+    while (childToJoint.find(linkName) != childToJoint.end()) {
+        auto joint = childToJoint.at(linkName);
+        chainJoints.push_back(joint);
+
+        if (chainJoints.size() > model->nrOfJoints()) {
+            sError << "The kinematic tree of the model contains a loop"
+                   << std::endl;
+            return false;
+        }
+
+        linkName = utils::getExistingComponentData< //
+            components::ParentLinkName>(joint->ecm(), joint->entity());
+
+        if (linkName == "world") {
+            linkName.clear();
+            break;
+        }
+    }
+
+    if (chainJoints.empty()) {
+        sError << "Link '" << frame << "' is not the child of any joint"
+               << std::endl;
+        return false;
+    }
+
+    std::reverse(chainJoints.begin(), chainJoints.end());
+
+    auto impl = std::make_unique<Impl>();
+    impl->model = model;
+    impl->baseLink = linkName.empty() ? nullptr : model->getLink(linkName);
+
+    // The fixed transforms are measured from the current state of the model
+    Eigen::Isometry3d world_H_parent = impl->worldBaseTransform();
+
+    for (const auto& joint : chainJoints) {
+        ChainElement element;
+        element.joint = joint;
+        element.type = joint->type();
+
+        if (!(element.type == core::JointType::Fixed
+              || element.type == core::JointType::Revolute
+              || element.type == core::JointType::Prismatic)) {
+            sError << "Joint '" << joint->name()
+                   << "' has a type not supported by the solver" << std::endl;
+            return false;
+        }
+
+        const auto& childLinkName = utils::getExistingComponentData< //
+            components::ChildLinkName>(joint->ecm(), joint->entity());
+
+        // The pose of the joint is expressed in the child link frame
+        const auto child_H_joint = Impl::ToEigen(
+            utils::getExistingComponentData<components::Pose>(
+                joint->ecm(), joint->entity()));
+        element.joint_H_child = child_H_joint.inverse();
+
+        double position = 0;
+
+        if (element.type != core::JointType::Fixed) {
+            const sdf::JointAxis& sdfAxis = utils::getExistingComponentData<
+                components::JointAxis>(joint->ecm(), joint->entity());
+
+            // Resolve the axis in the joint frame
+            ignition::math::Vector3d xyz = sdfAxis.Xyz();
+
+            if (!sdfAxis.ResolveXyz(xyz).empty()
+                && !sdfAxis.XyzExpressedIn().empty()) {
+                sError << "Failed to resolve the axis of joint '"
+                       << joint->name() << "'" << std::endl;
+                return false;
+            }
+
+            element.axis =
+                Eigen::Vector3d(xyz.X(), xyz.Y(), xyz.Z()).normalized();
+
+            try {
+                position = joint->position();
+            }
+            catch (const std::exception& e) {
+                sError << e.what() << std::endl;
+                return false;
+            }
+        }
+
+        auto childLink = model->getLink(childLinkName);
+        const auto world_H_child =
+            Impl::ToEigen(childLink->position(), childLink->orientation());
+
+        element.parent_H_joint0 = world_H_parent.inverse() * world_H_child
+                                  * child_H_joint
+                                  * Impl::Motion(element, position).inverse();
+
+        world_H_parent = world_H_child;
+        impl->chain.push_back(element);
+    }
+
+    // Select the optimized joints
+    if (jointNames.empty()) {
+        for (const auto& element : impl->chain) {
+            if (element.type != core::JointType::Fixed) {
+                impl->jointNames.push_back(element.joint->name());
+            }
+        }
+    }
+    else {
+        impl->jointNames = jointNames;
+    }
+
+    for (size_t i = 0; i < impl->jointNames.size(); ++i) {
+        auto it = std::find_if(
+            impl->chain.begin(), impl->chain.end(), [&](const auto& element) {
+                return element.joint->name() == impl->jointNames[i];
+            });
+
+        if (it == impl->chain.end() || it->type == core::JointType::Fixed) {
+            sError << "Joint '" << impl->jointNames[i]
+                   << "' is not a movable joint of the chain of '" << frame
+                   << "'" << std::endl;
+            return false;
+        }
+
+        if (it->index >= 0) {
+            sError << "Joint '" << impl->jointNames[i]
+                   << "' is optimized more than once" << std::endl;
+            return false;
+        }
+
+        it->index = static_cast<int>(i);
+    }
+
+    if (impl->jointNames.empty()) {
+        sError << "The chain of '" << frame << "' has no movable joints"
+               << std::endl;
+        return false;
+    }
+
+    const auto dofs = static_cast<Eigen::Index>(impl->jointNames.size());
+    const auto limits = model->jointLimits(impl->jointNames);
+    const auto positions = model->jointPositions(impl->jointNames);
+
+    using ConstMap = Eigen::Map<const Eigen::VectorXd>;
+    impl->lowerLimits = ConstMap(limits.min.data(), dofs);
+    impl->upperLimits = ConstMap(limits.max.data(), dofs);
+    impl->warmStart = ConstMap(positions.data(), dofs);
+
+    impl->damping = pImpl->damping;
+    impl->maxIterations = pImpl->maxIterations;
+    impl->tolerance = pImpl->tolerance;
+    impl->rotationWeight = pImpl->rotationWeight;
+
+    impl->q.setZero(dofs);
+    impl->dq.setZero(dofs);
+    impl->jacobian.setZero(6, dofs);
+    impl->chainPositions.resize(impl->chain.size(), 0.0);
+    impl->worldAxes.resize(impl->chain.size());
+    impl->worldOrigins.resize(impl->chain.size());
+
+    pImpl = std::move(impl);
+    return true;
+}
+
+std::vector<std::string> InverseKinematics::jointNames() const
+{
+    return pImpl->jointNames;
+}
+
+size_t InverseKinematics::dofs() const
+{
+    return pImpl->jointNames.size();
+}
+
+bool InverseKinematics::setDamping(const double damping)
+{
+    if (damping < 0) {
+        sError << "The damping must be non-negative" << std::endl;
+        return false;
+    }
+
+    pImpl->damping = damping;
+    return true;
+}
+
+bool InverseKinematics::setMaxIterations(const size_t maxIterations)
+{
+    pImpl->maxIterations = maxIterations;
+    return true;
+}
+
+bool InverseKinematics::setTolerance(const double tolerance)
+{
+    if (tolerance <= 0) {
+        sError << "The tolerance must be positive" << std::endl;
+        return false;
+    }
+
+    pImpl->tolerance = tolerance;
+    return true;
+}
+
+bool InverseKinematics::setRotationWeight(const double weight)
+{
+    if (weight < 0) {
+        sError << "The rotation weight must be non-negative" << std::endl;
+        return false;
+    }
+
+    pImpl->rotationWeight = weight;
+    return true;
+}
+
+bool InverseKinematics::setWarmStart(const std::vector<double>& jointPositions)
+{
+    if (jointPositions.size() != this->dofs()) {
+        sError << "The warm start has " << jointPositions.size()
+               << " elements but the solver has " << this->dofs() << " DoFs"
+               << std::endl;
+        return false;
+    }
+
+    pImpl->warmStart = Eigen::Map<const Eigen::VectorXd>(
+        jointPositions.data(), pImpl->warmStart.size());
+    return true;
+}
+
+bool InverseKinematics::solve(const std::vector<double>& targets,
+                              const bool chainWarmStart)
+{
+    if (!pImpl->model) {
+        sError << "The solver was not initialized" << std::endl;
+        return false;
+    }
+
+    if (targets.empty() || targets.size() % 7 != 0) {
+        sError << "The targets must be a sequence of 7-element poses"
+               << std::endl;
+        return false;
+    }
+
+    if (!pImpl->readChainPositions(pImpl->chainPositions)) {
+        return false;
+    }
+
+    const size_t nrOfTargets = targets.size() / 7;
+    const auto dofs = static_cast<Eigen::Index>(this->dofs());
+    const Eigen::Isometry3d world_H_base = pImpl->worldBaseTransform();
+
+    pImpl->solution.resize(nrOfTargets * this->dofs());
+    pImpl->residuals.resize(nrOfTargets);
+    pImpl->q = pImpl->warmStart;
+
+    bool converged = true;
+
+    for (size_t t = 0; t < nrOfTargets; ++t) {
+        const double* pose = targets.data() + 7 * t;
+        const Eigen::Quaterniond quaternion(pose[3], pose[4], pose[5], pose[6]);
+
+        if (quaternion.norm() == 0) {
+            sError << "The orientation of target " << t << " is not valid"
+                   << std::endl;
+            return false;
+        }
+
+        Eigen::Isometry3d target = Eigen::Isometry3d::Identity();
+        target.translation() = Eigen::Vector3d(pose[0], pose[1], pose[2]);
+        target.linear() = quaternion.normalized().toRotationMatrix();
+
+        if (!chainWarmStart) {
+            pImpl->q = pImpl->warmStart;
+        }
+
+        const double residual = pImpl->solveTarget(target, world_H_base);
+
+        double* solution = pImpl->solution.data() + t * this->dofs();
+        Eigen::Map<Eigen::VectorXd>(solution, dofs) = pImpl->q;
+        pImpl->residuals[t] = residual;
+        converged = converged && residual <= pImpl->tolerance;
+    }
+
+    // The next solve starts from the solution of the last target
+    pImpl->warmStart = pImpl->q;
+
+    return converged;
+}
+
+std::vector<double> InverseKinematics::solution() const
+{
+    return pImpl->solution;
+}
+
+std::vector<double> InverseKinematics::residuals() const
+{
+    return pImpl->residuals;
+}
+
+std::vector<double> InverseKinematics::forwardKinematics(
+    const std::vector<double>& jointPositions) const
+{
+    if (!pImpl->model) {
+        throw std::runtime_error("The solver was not initialized");
+    }
+
+    if (jointPositions.size() != this->dofs()) {
+        throw std::runtime_error("The joint positions do not match the DoFs");
+    }
+
+    std::vector<double> positions(pImpl->chain.size(), 0.0);
+
+    if (!pImpl->readChainPositions(positions)) {
+        throw std::runtime_error("Failed to read the positions of the chain");
+    }
+
+    const Eigen::Isometry3d world_H_frame = pImpl->kinematics(
+        Eigen::Map<const Eigen::VectorXd>(jointPositions.data(),
+                                          pImpl->warmStart.size()),
+        pImpl->worldBaseTransform(),
+        positions,
+        nullptr);
+
+    const Eigen::Vector3d p = world_H_frame.translation();
+    const Eigen::Quaterniond quaternion(world_H_frame.rotation());
+
+    return {p[0],
+            p[1],
+            p[2],
+            quaternion.w(),
+            quaternion.x(),
+            quaternion.y(),
+            quaternion.z()};
+}
+
+// ===============
+// Private methods
+// ===============
+
+Eigen::Isometry3d
+InverseKinematics::Impl::ToEigen(const std::array<double, 3>& position,
+                                 const std::array<double, 4>& orientation)
+{
+    Eigen::Isometry3d transform = Eigen::Isometry3d::Identity();
+    transform.translation() =
+        Eigen::Vector3d(position[0], position[1], position[2]);
+    transform.linear() = Eigen::Quaterniond(orientation[0],
+                                            orientation[1],
+                                            orientation[2],
+                                            orientation[3])
+                             .normalized()
+                             .toRotationMatrix();
+    return transform;
+}
+
+Eigen::Isometry3d
+InverseKinematics::Impl::ToEigen(const ignition::math::Pose3d& pose)
+{
+    return ToEigen({pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z()},
+                   {pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(),
+                    pose.Rot().Z()});
+}
+
+Eigen::Isometry3d InverseKinematics::Impl::Motion(const ChainElement& element,
+                                                  const double position)
+{
+    Eigen::Isometry3d motion = Eigen::Isometry3d::Identity();
+
+    switch (element.type) {
+        case core::JointType::Revolute:
+            motion.linear() =
+                Eigen::AngleAxisd(position, element.axis).toRotationMatrix();
+            break;
+        case core::JointType::Prismatic:
+            motion.translation() = position * element.axis;
+            break;
+        default:
+            break;
+    }
+
+    return motion;
+}
+
+Eigen::Isometry3d InverseKinematics::Impl::worldBaseTransform() const
+{
+    if (!baseLink) {
+        return Eigen::Isometry3d::Identity();
+    }
+
+    return ToEigen(baseLink->position(), baseLink->orientation());
+}
+
+bool InverseKinematics::Impl::readChainPositions(
+    std::vector<double>& positions) const
+{
+    // Joints that are not optimized keep their current position
+    for (size_t i = 0; i < chain.size(); ++i) {
+        if (chain[i].type == core::JointType::Fixed || chain[i].index >= 0) {
+            continue;
+        }
+
+        try {
+            positions[i] = chain[i].joint->position();
+        }
+        catch (const std::exception& e) {
+            sError << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Eigen::Isometry3d
+InverseKinematics::Impl::kinematics(const Eigen::VectorXd& jointPositions,
+                                    const Eigen::Isometry3d& world_H_base,
+                                    std::vector<double>& positions,
+                                    Matrix6X* frameJacobian)
+{
+    Eigen::Isometry3d world_H_link = world_H_base;
+
+    for (size_t i = 0; i < chain.size(); ++i) {
+        const auto& element = chain[i];
+
+        if (element.index >= 0) {
+            positions[i] = jointPositions[element.index];
+        }
+
+        const Eigen::Isometry3d world_H_joint =
+            world_H_link * element.parent_H_joint0;
+
+        if (frameJacobian) {
+            worldAxes[i] = world_H_joint.linear() * element.axis;
+            worldOrigins[i] = world_H_joint.translation();
+        }
+
+        world_H_link = world_H_joint * Motion(element, positions[i])
+                       * element.joint_H_child;
+    }
+
+    if (!frameJacobian) {
+        return world_H_link;
+    }
+
+    // Mixed Jacobian of the frame, the linear part is the first
+    const Eigen::Vector3d frameOrigin = world_H_link.translation();
+
+    for (size_t i = 0; i < chain.size(); ++i) {
+        if (chain[i].index < 0) {
+            continue;
+        }
+
+        auto column = frameJacobian->col(chain[i].index);
+
+        if (chain[i].type == core::JointType::Revolute) {
+            column.head<3>() =
+                worldAxes[i].cross(frameOrigin - worldOrigins[i]);
+            column.tail<3>() = worldAxes[i];
+        }
+        else {
+            column.head<3>() = worldAxes[i];
+            column.tail<3>().setZero();
+        }
+    }
+
+    return world_H_link;
+}
+
+double
+InverseKinematics::Impl::solveTarget(const Eigen::Isometry3d& target,
+                                     const Eigen::Isometry3d& world_H_base)
+{
+    Vector6d error;
+    double residual = 0;
+
+    for (size_t iteration = 0;; ++iteration) {
+        const Eigen::Isometry3d world_H_frame =
+            kinematics(q, world_H_base, chainPositions, &jacobian);
+
+        // Orientation error as rotation vector in the world frame
+        const Eigen::AngleAxisd rotationError(
+            target.linear() * world_H_frame.linear().transpose());
+
+        error.head<3>() = target.translation() - world_H_frame.translation();
+        error.tail<3>() =
+            rotationWeight * rotationError.angle() * rotationError.axis();
+
+        residual = error.norm();
+
+        if (residual <= tolerance || iteration >= maxIterations) {
+            break;
+        }
+
+        jacobian.bottomRows<3>() *= rotationWeight;
+
+        // dq = J^T (J J^T + λ² I)^-1 e
+        Matrix6d A = jacobian * jacobian.transpose();
+        A.diagonal().array() += damping * damping;
+
+        dq.noalias() = jacobian.transpose() * A.ldlt().solve(error);
+        q += dq;
+        q = q.cwiseMax(lowerLimits).cwiseMin(upperLimits);
+    }
+
+    return residual;
+}
@@ -37,6 +37,7 @@
 #include "scenario/gazebo/components/JointPositionTarget.h"
 #include "scenario/gazebo/components/JointVelocityTarget.h"
 #include "scenario/gazebo/components/MaxJointForce.h"
+#include "scenario/gazebo/components/WorldJointController.h"
 #include "scenario/gazebo/exceptions.h"
 #include "scenario/gazebo/helpers.h"
 
@@ -50,10 +51,13 @@
 #include <ignition/gazebo/components/JointVelocityReset.hh>
 #include <ignition/gazebo/components/Name.hh>
 #include <ignition/gazebo/components/ParentEntity.hh>
+#include <ignition/gazebo/components/World.hh>
 #include <ignition/math/PID.hh>
 #include <sdf/Joint.hh>
 #include <sdf/JointAxis.hh>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <utility>
 
@@ -63,8 +67,23 @@ const ignition::math::PID DefaultPID(1, 0.1, 0.01, 1, -1, 10000, -10000);
 class Joint::Impl
 {
 public:
+    static void
+    updateReferencesVersion(ignition::gazebo::EntityComponentManager* ecm,
+                            const ignition::gazebo::Entity jointEntity);
 };
 
+void Joint::Impl::updateReferencesVersion(
+    ignition::gazebo::EntityComponentManager* ecm,
+    const ignition::gazebo::Entity jointEntity)
+{
+    // The references are versioned by the parent model
+    const ignition::gazebo::Entity modelEntity =
+        utils::getExistingComponentData<
+            ignition::gazebo::components::ParentEntity>(ecm, jointEntity);
+
+    utils::updateReferencesVersion(ecm, modelEntity);
+}
+
 Joint::Joint()
     : pImpl{std::make_unique<Impl>()}
 {}
@@ -328,10 +347,19 @@ bool Joint::setControlMode(const scenario::core::JointControlMode mode)
         return false;
     }
 
+    // Check if the joints of all models are controlled by the world plugin
+    auto worldEntity = utils::getFirstParentEntityWithComponent< //
+        ignition::gazebo::components::World>(m_ecm, m_entity);
+
+    const bool* worldJointController = utils::tryGetExistingComponentData<
+        ignition::gazebo::components::WorldJointController>(m_ecm,
+                                                            worldEntity);
+
     // Insert the JointController plugin to the model if the control
     // mode is either Position or Velocity
-    if (mode == core::JointControlMode::Position
-        || mode == core::JointControlMode::Velocity) {
+    if (!(worldJointController && *worldJointController)
+        && (mode == core::JointControlMode::Position
+            || mode == core::JointControlMode::Velocity)) {
 
         // Get the parent model entity
         auto parentModelEntity = m_ecm->Component< //
@@ -401,6 +429,10 @@ bool Joint::setControlMode(const scenario::core::JointControlMode mode)
             return false;
     }
 
+    // The targets have been removed or reset, the controllers have to read
+    // them again
+    Impl::updateReferencesVersion(m_ecm, m_entity);
+
     // Get the PID
     ignition::math::PID& pid = utils::getExistingComponentData< //
         ignition::gazebo::components::JointPID>(m_ecm, m_entity);
@@ -533,7 +565,10 @@ double Joint::maxGeneralizedForce(const size_t dof) const
         throw exceptions::DOFMismatch(this->dofs(), dof, this->name());
     }
 
-    std::vector<double> maxForce = this->jointMaxGeneralizedForce();
+    // Read the component by reference, this is called at every force target
+    const std::vector<double>& maxForce = utils::getExistingComponentData<
+        ignition::gazebo::components::MaxJointForce>(m_ecm, m_entity);
+
     return maxForce[dof];
 }
 
@@ -563,7 +598,15 @@ double Joint::position(const size_t dof) const
         throw exceptions::DOFMismatch(this->dofs(), dof, this->name());
     }
 
-    std::vector<double> position = this->jointPosition();
+    // Read the component by reference to avoid copying the whole vector
+    const std::vector<double>& position = utils::getExistingComponentData<
+        ignition::gazebo::components::JointPosition>(m_ecm, m_entity);
+
+    if (position.size() != this->dofs()) {
+        throw exceptions::DOFMismatch(
+            this->dofs(), position.size(), this->name());
+    }
+
     return position[dof];
 }
 
@@ -573,13 +616,21 @@ double Joint::velocity(const size_t dof) const
         throw exceptions::DOFMismatch(this->dofs(), dof, this->name());
     }
 
-    std::vector<double> velocity = this->jointVelocity();
+    // Read the component by reference to avoid copying the whole vector
+    const std::vector<double>& velocity = utils::getExistingComponentData<
+        ignition::gazebo::components::JointVelocity>(m_ecm, m_entity);
+
+    if (velocity.size() != this->dofs()) {
+        throw exceptions::DOFMismatch(
+            this->dofs(), velocity.size(), this->name());
+    }
+
     return velocity[dof];
 }
 
 bool Joint::setPositionTarget(const double position, const size_t dof)
 {
-    const std::vector<core::JointControlMode> allowedControlModes = {
+    constexpr std::array<core::JointControlMode, 4> allowedControlModes = {
         core::JointControlMode::Position,
         core::JointControlMode::PositionInterpolated,
         core::JointControlMode::Idle,
@@ -611,6 +662,7 @@ bool Joint::setPositionTarget(const double position, const size_t dof)
     }
 
     jointPositionTarget[dof] = position;
+    Impl::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -640,6 +692,7 @@ bool Joint::setVelocityTarget(const double velocity, const size_t dof)
     }
 
     jointVelocityTarget[dof] = velocity;
+    Impl::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -668,12 +721,13 @@ bool Joint::setAccelerationTarget(const double acceleration, const size_t dof)
     }
 
     jointAccelerationTarget[dof] = acceleration;
+    Impl::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
 bool Joint::setGeneralizedForceTarget(const double force, const size_t dof)
 {
-    const std::vector<core::JointControlMode> allowedControlModes = {
+    constexpr std::array<core::JointControlMode, 4> allowedControlModes = {
         core::JointControlMode::Force,
         core::JointControlMode::Position,
         core::JointControlMode::PositionInterpolated,
@@ -841,6 +895,7 @@ bool Joint::setJointPositionTarget(const std::vector<double>& position)
         ignition::gazebo::components::JointPositionTarget>(m_ecm, m_entity);
 
     jointPositionTarget = position;
+    Impl::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -856,6 +911,7 @@ bool Joint::setJointVelocityTarget(const std::vector<double>& velocity)
         ignition::gazebo::components::JointVelocityTarget>(m_ecm, m_entity);
 
     jointVelocityTarget = velocity;
+    Impl::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -871,6 +927,7 @@ bool Joint::setJointAccelerationTarget(const std::vector<double>& acceleration)
         ignition::gazebo::components::JointAccelerationTarget>(m_ecm, m_entity);
 
     jointAccelerationTarget = acceleration;
+    Impl::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
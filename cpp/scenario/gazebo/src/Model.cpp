@@ -33,6 +33,8 @@
 #include "scenario/gazebo/components/BaseWorldAccelerationTarget.h"
 #include "scenario/gazebo/components/BaseWorldVelocityTarget.h"
 #include "scenario/gazebo/components/JointControllerPeriod.h"
+#include "scenario/gazebo/components/ModelAccumulators.h"
+#include "scenario/gazebo/components/ModelCollisionBitmask.h"
 #include "scenario/gazebo/components/WorldVelocityCmd.h"
 #include "scenario/gazebo/exceptions.h"
 #include "scenario/gazebo/helpers.h"
@@ -40,8 +42,10 @@
 #include <ignition/common/Event.hh>
 #include <ignition/gazebo/Events.hh>
 #include <ignition/gazebo/Model.hh>
+#include <ignition/gazebo/components/AngularVelocity.hh>
 #include <ignition/gazebo/components/CanonicalLink.hh>
 #include <ignition/gazebo/components/Joint.hh>
+#include <ignition/gazebo/components/LinearVelocity.hh>
 #include <ignition/gazebo/components/Link.hh>
 #include <ignition/gazebo/components/Name.hh>
 #include <ignition/gazebo/components/ParentEntity.hh>
@@ -82,6 +86,21 @@ public:
         std::optional<std::vector<std::string>> scopedJointNames;
     } buffers;
 
+    // The canonical link and its fixed transform wrt the model frame are
+    // cached in order to avoid scanning the ECM every time the base is read
+    struct
+    {
+        std::string name;
+        ignition::math::Pose3d M_H_B;
+        ignition::gazebo::Entity entity = ignition::gazebo::kNullEntity;
+    } canonicalLink;
+
+    bool updateCanonicalLink( //
+        const ignition::gazebo::EntityComponentManager* ecm,
+        const ignition::gazebo::Entity modelEntity);
+
+    const decltype(canonicalLink)& getCanonicalLink(const Model& model);
+
     static std::vector<double> getJointDataSerialized(
         const Model* model,
         const std::vector<std::string>& jointNames,
@@ -135,6 +154,10 @@ bool Model::initialize(const ignition::gazebo::Entity modelEntity,
         return false;
     }
 
+    // Cache the canonical link. If the links were not yet created, it is
+    // searched again the first time the base is accessed.
+    pImpl->updateCanonicalLink(ecm, modelEntity);
+
     return true;
 }
 
@@ -250,22 +273,8 @@ bool Model::resetBasePose(const std::array<double, 3>& position,
     pose.orientation = orientation;
     ignition::math::Pose3d world_H_base = utils::toIgnitionPose(pose);
 
-    // Get the entity of the canonical link
-    auto canonicalLinkEntity = m_ecm->EntityByComponents(
-        ignition::gazebo::components::Link(),
-        ignition::gazebo::components::CanonicalLink(),
-        ignition::gazebo::components::Name(this->baseFrame()),
-        ignition::gazebo::components::ParentEntity(m_entity));
-
-    if (canonicalLinkEntity == ignition::gazebo::kNullEntity) {
-        sError << "Failed to get entity of canonical link" << std::endl;
-        return false;
-    }
-
-    // Get the Pose component of the canonical link.
-    // This is the fixed transformation between the model and the base.
-    auto& model_H_base = utils::getExistingComponentData< //
-        ignition::gazebo::components::Pose>(m_ecm, canonicalLinkEntity);
+    // Get the fixed transformation between the model and the base
+    const auto& model_H_base = pImpl->getCanonicalLink(*this).M_H_B;
 
     // Compute the robot pose that corresponds to the desired base pose
     const ignition::math::Pose3d& world_H_model =
@@ -303,21 +312,15 @@ bool Model::resetBaseWorldAngularVelocity(const std::array<double, 3>& angular)
 bool Model::resetBaseWorldVelocity(const std::array<double, 3>& linear,
                                    const std::array<double, 3>& angular)
 {
-    // Get the entity of the canonical (base) link
-    auto canonicalLinkEntity = m_ecm->EntityByComponents(
-        ignition::gazebo::components::Link(),
-        ignition::gazebo::components::CanonicalLink(),
-        ignition::gazebo::components::Name(this->baseFrame()),
-        ignition::gazebo::components::ParentEntity(m_entity));
+    // Get the fixed transformation between the model and the base
+    const auto& M_H_B = pImpl->getCanonicalLink(*this).M_H_B;
 
-    // Get the Pose component of the canonical link.
-    // This is the fixed transformation between the model and the base.
-    auto& M_H_B = utils::getExistingComponentData< //
-        ignition::gazebo::components::Pose>(m_ecm, canonicalLinkEntity);
+    // Get the model pose
+    const auto& W_H_M = utils::getExistingComponentData< //
+        ignition::gazebo::components::Pose>(m_ecm, m_entity);
 
     // Get the rotation between base link and world
-    auto W_R_B = utils::toIgnitionQuaternion(
-        this->getLink(this->baseFrame())->orientation());
+    const ignition::math::Quaterniond W_R_B = (W_H_M * M_H_B).Rot();
 
     // Create the new model velocity
     ignition::gazebo::WorldVelocity baseWorldVelocity;
@@ -336,6 +339,76 @@ bool Model::resetBaseWorldVelocity(const std::array<double, 3>& linear,
     return true;
 }
 
+bool Model::enableAccumulators(const bool enable)
+{
+    if (enable) {
+        // If the component already exists, its value is not overridden
+        if (!this->accumulatorsEnabled()) {
+            m_ecm->CreateComponent(
+                m_entity, ignition::gazebo::components::ModelAccumulators());
+        }
+    }
+    else {
+        m_ecm->RemoveComponent(
+            m_entity,
+            ignition::gazebo::components::ModelAccumulators().TypeId());
+    }
+
+    return true;
+}
+
+bool Model::accumulatorsEnabled() const
+{
+    return m_ecm->EntityHasComponentType(
+        m_entity, ignition::gazebo::components::ModelAccumulators().TypeId());
+}
+
+Statistics Model::accumulator(const AccumulatedQuantity quantity) const
+{
+    if (!this->accumulatorsEnabled()) {
+        return {};
+    }
+
+    const auto& accumulators = utils::getExistingComponentData<
+        ignition::gazebo::components::ModelAccumulators>(m_ecm, m_entity);
+
+    const auto it = accumulators.find(quantity);
+    return it != accumulators.end() ? it->second : Statistics();
+}
+
+bool Model::resetAccumulators()
+{
+    if (!this->accumulatorsEnabled()) {
+        sError << "The accumulators of model '" << this->name()
+               << "' are not enabled" << std::endl;
+        return false;
+    }
+
+    utils::getExistingComponentData<
+        ignition::gazebo::components::ModelAccumulators>(m_ecm, m_entity)
+        .clear();
+
+    return true;
+}
+
+bool Model::setCollisionBitmask(const uint16_t bitmask)
+{
+    utils::setComponentData<
+        ignition::gazebo::components::ModelCollisionBitmask>(
+        m_ecm, m_entity, bitmask);
+
+    return true;
+}
+
+uint16_t Model::collisionBitmask() const
+{
+    auto* component =
+        m_ecm->Component<ignition::gazebo::components::ModelCollisionBitmask>(
+            m_entity);
+
+    return component ? component->Data() : 0xFFFF;
+}
+
 bool Model::valid() const
 {
     return this->validEntity() && pImpl->model.Valid(*m_ecm);
@@ -884,26 +957,7 @@ std::vector<double> Model::jointGeneralizedForceTargets(
 
 std::string Model::baseFrame() const
 {
-    // Get all the canonical links of the model
-    auto candidateBaseLinks = m_ecm->EntitiesByComponents(
-        ignition::gazebo::components::CanonicalLink(),
-        ignition::gazebo::components::ParentEntity(pImpl->model.Entity()));
-
-    if (candidateBaseLinks.size() == 0) {
-        throw exceptions::ModelError("Failed to find the canonical link",
-                                     this->name());
-    }
-
-    if (candidateBaseLinks.size() > 1) {
-        throw exceptions::ModelError("Found multiple canonical link",
-                                     this->name());
-    }
-
-    // Get the name of the base link
-    std::string baseLinkName = utils::getExistingComponentData< //
-        ignition::gazebo::components::Name>(m_ecm, candidateBaseLinks.front());
-
-    return baseLinkName;
+    return pImpl->getCanonicalLink(*this).name;
 }
 
 std::array<double, 3> Model::basePosition() const
@@ -926,67 +980,17 @@ std::array<double, 4> Model::baseOrientation() const
 
 std::array<double, 3> Model::baseBodyLinearVelocity() const
 {
-    auto baseWorldLinearVelocity =
-        utils::toIgnitionVector3(this->baseWorldLinearVelocity());
-
-    // Get the model pose
-    ignition::math::Pose3d world_H_model = utils::getExistingComponentData< //
-        ignition::gazebo::components::Pose>(m_ecm, m_entity);
-
-    return utils::fromIgnitionVector( //
-        world_H_model.Inverse().Rot() * baseWorldLinearVelocity);
+    return this->baseState().bodyLinearVelocity;
 }
 
 std::array<double, 3> Model::baseBodyAngularVelocity() const
 {
-    auto baseWorldAngularVelocity =
-        utils::toIgnitionVector3(this->baseWorldAngularVelocity());
-
-    // Get the model pose
-    ignition::math::Pose3d world_H_model = utils::getExistingComponentData< //
-        ignition::gazebo::components::Pose>(m_ecm, m_entity);
-
-    return utils::fromIgnitionVector( //
-        world_H_model.Inverse().Rot() * baseWorldAngularVelocity);
+    return this->baseState().bodyAngularVelocity;
 }
 
 std::array<double, 3> Model::baseWorldLinearVelocity() const
 {
-    // Get the entity of the canonical link
-    auto canonicalLinkEntity = m_ecm->EntityByComponents(
-        ignition::gazebo::components::Link(),
-        ignition::gazebo::components::CanonicalLink(),
-        ignition::gazebo::components::Name(this->baseFrame()),
-        ignition::gazebo::components::ParentEntity(m_entity));
-
-    // Get the Pose component of the canonical link.
-    // This is the fixed transformation between the model and the base.
-    auto& M_H_B = utils::getExistingComponentData< //
-        ignition::gazebo::components::Pose>(m_ecm, canonicalLinkEntity);
-
-    // Get the rotation between base link and world
-    auto W_R_B = utils::toIgnitionQuaternion(
-        this->getLink(this->baseFrame())->orientation());
-
-    // Get the linear velocity of the canonical link
-    ignition::math::Vector3d canonicalLinkLinearVelocity =
-        utils::toIgnitionVector3(
-            this->getLink(this->baseFrame())->worldLinearVelocity());
-
-    // Get the angular velocity of the canonical link
-    ignition::math::Vector3d canonicalLinkAngularVelocity =
-        utils::toIgnitionVector3(
-            this->getLink(this->baseFrame())->worldAngularVelocity());
-
-    // Convert the base velocity to the model mixed velocity
-    auto [modelLinearVelocity, _] = utils::fromBaseToModelVelocity( //
-        canonicalLinkLinearVelocity,
-        canonicalLinkAngularVelocity,
-        M_H_B,
-        W_R_B);
-
-    // Return the linear part
-    return utils::fromIgnitionVector(modelLinearVelocity);
+    return this->baseState().worldLinearVelocity;
 }
 
 std::array<double, 3> Model::baseWorldAngularVelocity() const
@@ -995,12 +999,55 @@ std::array<double, 3> Model::baseWorldAngularVelocity() const
     // mixed velocity. However, since there's only a rigid transformation
     // between base and model frame, and the velocity is computed in the world
     // frame, we do not need to perform any conversion.
+    const auto& canonicalLink = pImpl->getCanonicalLink(*this);
 
-    // Get the name of the base link
-    const std::string baseLink = this->baseFrame();
+    // Get the angular velocity of the base link
+    const auto& canonicalLinkAngularVelocity = utils::getExistingComponentData<
+        ignition::gazebo::components::WorldAngularVelocity>(
+        m_ecm, canonicalLink.entity);
 
-    // Return the angular velocity of the base link
-    return this->getLink(baseLink)->worldAngularVelocity();
+    return utils::fromIgnitionVector(canonicalLinkAngularVelocity);
+}
+
+BaseState Model::baseState() const
+{
+    const auto& canonicalLink = pImpl->getCanonicalLink(*this);
+
+    // Read all the components only once
+    const auto& W_H_M = utils::getExistingComponentData< //
+        ignition::gazebo::components::Pose>(m_ecm, m_entity);
+    const auto& canonicalLinkLinearVelocity = utils::getExistingComponentData<
+        ignition::gazebo::components::WorldLinearVelocity>(
+        m_ecm, canonicalLink.entity);
+    const auto& canonicalLinkAngularVelocity = utils::getExistingComponentData<
+        ignition::gazebo::components::WorldAngularVelocity>(
+        m_ecm, canonicalLink.entity);
+
+    // Get the rotation between base link and world
+    const ignition::math::Quaterniond W_R_B =
+        (W_H_M * canonicalLink.M_H_B).Rot();
+
+    // Convert the base velocity to the model mixed velocity
+    const auto [modelLinearVelocity, modelAngularVelocity] =
+        utils::fromBaseToModelVelocity(canonicalLinkLinearVelocity,
+                                       canonicalLinkAngularVelocity,
+                                       canonicalLink.M_H_B,
+                                       W_R_B);
+
+    // Get the rotation between world and model
+    const ignition::math::Quaterniond M_R_W = W_H_M.Rot().Inverse();
+
+    BaseState state;
+    state.pose = utils::fromIgnitionPose(W_H_M);
+    state.worldLinearVelocity = utils::fromIgnitionVector(modelLinearVelocity);
+    state.worldAngularVelocity =
+        utils::fromIgnitionVector(modelAngularVelocity);
+    state.bodyLinearVelocity =
+        utils::fromIgnitionVector(M_R_W * modelLinearVelocity);
+    state.bodyAngularVelocity =
+        utils::fromIgnitionVector(M_R_W * modelAngularVelocity);
+
+    return state;
 }
 
 bool Model::setBasePoseTarget(const std::array<double, 3>& position,
@@ -1012,6 +1059,7 @@ bool Model::setBasePoseTarget(const std::array<double, 3>& position,
     utils::setComponentData<ignition::gazebo::components::BasePoseTarget>(
         m_ecm, m_entity, basePoseTarget);
 
+    utils::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -1029,6 +1077,7 @@ bool Model::setBasePositionTarget(const std::array<double, 3>& position)
         ignition::gazebo::components::BasePoseTarget>(
         m_ecm, m_entity, basePoseTarget);
 
+    utils::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -1045,6 +1094,7 @@ bool Model::setBaseOrientationTarget(const std::array<double, 4>& orientation)
     utils::setComponentData<ignition::gazebo::components::BasePoseTarget>(
         m_ecm, m_entity, basePoseTarget);
 
+    utils::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -1067,6 +1117,7 @@ bool Model::setBaseWorldLinearVelocityTarget(
         ignition::gazebo::components::BaseWorldLinearVelocityTarget>(
         m_ecm, m_entity, baseWorldLinearVelocity);
 
+    utils::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -1080,6 +1131,7 @@ bool Model::setBaseWorldAngularVelocityTarget(
         ignition::gazebo::components::BaseWorldAngularVelocityTarget>(
         m_ecm, m_entity, baseWorldAngularVelocity);
 
+    utils::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -1097,6 +1149,7 @@ bool Model::setBaseWorldLinearAccelerationTarget(
         ignition::gazebo::components::BaseWorldLinearAccelerationTarget>(
         m_ecm, m_entity, baseWorldLinearAcceleration);
 
+    utils::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -1110,6 +1163,7 @@ bool Model::setBaseWorldAngularAccelerationTarget(
         ignition::gazebo::components::BaseWorldAngularAccelerationTarget>(
         m_ecm, m_entity, baseWorldAngularAcceleration);
 
+    utils::updateReferencesVersion(m_ecm, m_entity);
     return true;
 }
 
@@ -1169,6 +1223,64 @@ std::array<double, 3> Model::baseWorldAngularAccelerationTarget() const
 // Implementation Methods
 // ======================
 
+bool Model::Impl::updateCanonicalLink(
+    const ignition::gazebo::EntityComponentManager* ecm,
+    const ignition::gazebo::Entity modelEntity)
+{
+    // Get all the canonical links of the model
+    auto candidateBaseLinks = ecm->EntitiesByComponents(
+        ignition::gazebo::components::CanonicalLink(),
+        ignition::gazebo::components::ParentEntity(modelEntity));
+
+    if (candidateBaseLinks.size() != 1) {
+        return false;
+    }
+
+    const auto entity = candidateBaseLinks.front();
+
+    auto* nameComponent =
+        ecm->Component<ignition::gazebo::components::Name>(entity);
+    auto* poseComponent =
+        ecm->Component<ignition::gazebo::components::Pose>(entity);
+
+    if (!nameComponent || !poseComponent) {
+        return false;
+    }
+
+    // The Pose component of the canonical link is the fixed transformation
+    // between the model and the base
+    canonicalLink.name = nameComponent->Data();
+    canonicalLink.M_H_B = poseComponent->Data();
+    canonicalLink.entity = entity;
+
+    return true;
+}
+
+const decltype(Model::Impl::canonicalLink)&
+Model::Impl::getCanonicalLink(const Model& model)
+{
+    if (canonicalLink.entity != ignition::gazebo::kNullEntity) {
+        return canonicalLink;
+    }
+
+    if (!updateCanonicalLink(model.ecm(), model.entity())) {
+        // Get all the canonical links of the model
+        auto candidateBaseLinks = model.ecm()->EntitiesByComponents(
+            ignition::gazebo::components::CanonicalLink(),
+            ignition::gazebo::components::ParentEntity(model.entity()));
+
+        if (candidateBaseLinks.size() > 1) {
+            throw exceptions::ModelError("Found multiple canonical link",
+                                         model.name());
+        }
+
+        throw exceptions::ModelError("Failed to find the canonical link",
+                                     model.name());
+    }
+
+    return canonicalLink;
+}
+
 std::vector<double> Model::Impl::getJointDataSerialized(
     const Model* model,
     const std::vector<std::string>& jointNames,
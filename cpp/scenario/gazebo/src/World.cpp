@@ -25,10 +25,14 @@
  */
 
 #include "scenario/gazebo/World.h"
+#include "scenario/gazebo/Joint.h"
 #include "scenario/gazebo/Log.h"
 #include "scenario/gazebo/Model.h"
+#include "scenario/gazebo/components/PhysicsSubSteps.h"
+#include "scenario/gazebo/components/PhysicsThreads.h"
 #include "scenario/gazebo/components/SimulatedTime.h"
 #include "scenario/gazebo/components/Timestamp.h"
+#include "scenario/gazebo/components/WorldJointController.h"
 #include "scenario/gazebo/exceptions.h"
 #include "scenario/gazebo/helpers.h"
 
@@ -36,6 +40,8 @@
 #include <ignition/gazebo/Events.hh>
 #include <ignition/gazebo/SdfEntityCreator.hh>
 #include <ignition/gazebo/components/Gravity.hh>
+#include <ignition/gazebo/components/JointPosition.hh>
+#include <ignition/gazebo/components/JointVelocity.hh>
 #include <ignition/gazebo/components/Model.hh>
 #include <ignition/gazebo/components/Name.hh>
 #include <ignition/gazebo/components/ParentEntity.hh>
@@ -49,6 +55,7 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <thread>
 #include <unordered_map>
 
 using namespace scenario::gazebo;
@@ -65,6 +72,38 @@ public:
     {
         std::vector<std::string> modelNames;
     } buffers;
+
+    // Resolved entities of a set of models used by the batched methods
+    struct BatchLayout
+    {
+        size_t dofsPerModel = 0;
+        std::vector<std::string> modelNames;
+        std::vector<std::string> jointNames;
+        std::vector<ignition::gazebo::Entity> modelEntities;
+        std::vector<std::shared_ptr<Joint>> joints;
+        std::vector<ignition::gazebo::Entity> jointEntities;
+    };
+
+    // The layouts are indexed by the hash of their model and joint names.
+    // Only a few sets of models are expected, the cache is cleared when it
+    // grows over the maximum size.
+    using BatchKey = size_t;
+    static constexpr size_t MaxBatchLayouts = 32;
+    std::unordered_map<BatchKey, BatchLayout> batchLayouts;
+
+    static BatchKey getBatchKey(const std::vector<std::string>& modelNames,
+                                const std::vector<std::string>& jointNames);
+
+    const BatchLayout*
+    getBatchLayout(const World& world,
+                   const std::vector<std::string>& modelNames,
+                   const std::vector<std::string>& jointNames);
+
+    template <typename ComponentType>
+    std::vector<double>
+    getBatchJointData(const World& world,
+                      const std::vector<std::string>& modelNames,
+                      const std::vector<std::string>& jointNames);
 };
 
 World::World()
@@ -163,6 +202,37 @@ bool World::setPhysicsEngine(const PhysicsEngine engine)
     return true;
 }
 
+bool World::enableWorldJointController()
+{
+    if (this->worldJointControllerEnabled()) {
+        return true;
+    }
+
+    if (!this->insertWorldPlugin(
+            "WorldJointController",
+            "scenario::plugins::gazebo::WorldJointController")) {
+        sError << "Failed to insert the WorldJointController plugin"
+               << std::endl;
+        return false;
+    }
+
+    // Mark the world also here since the plugin could be configured later,
+    // after that the control mode of some joint was already changed
+    utils::setComponentData<ignition::gazebo::components::WorldJointController>(
+        m_ecm, m_entity, true);
+
+    return true;
+}
+
+bool World::worldJointControllerEnabled() const
+{
+    auto* component =
+        m_ecm->Component<ignition::gazebo::components::WorldJointController>(
+            m_entity);
+
+    return component && component->Data();
+}
+
 std::array<double, 3> World::gravity() const
 {
     auto gravity = utils::getExistingComponentData< //
@@ -191,6 +261,63 @@ bool World::setGravity(const std::array<double, 3>& gravity)
     return true;
 }
 
+bool World::setPhysicsSubSteps(const size_t subSteps)
+{
+    if (subSteps == 0) {
+        sError << "The number of physics sub-steps must be greater than zero"
+               << std::endl;
+        return false;
+    }
+
+    utils::setComponentData<ignition::gazebo::components::PhysicsSubSteps>(
+        m_ecm, m_entity, subSteps);
+
+    return true;
+}
+
+size_t World::physicsSubSteps() const
+{
+    // Worlds without the component perform a single step
+    auto* component =
+        m_ecm->Component<ignition::gazebo::components::PhysicsSubSteps>(
+            m_entity);
+
+    return component ? component->Data() : 1;
+}
+
+bool World::setPhysicsThreads(const size_t numOfThreads)
+{
+    // Limit the oversubscription of the cores
+    const size_t maxThreads =
+        4 * std::max(1u, std::thread::hardware_concurrency());
+
+    if (numOfThreads > maxThreads) {
+        sError << "The number of physics threads cannot be greater than "
+               << maxThreads << std::endl;
+        return false;
+    }
+
+    if (!this->valid()) {
+        sError << "The world is not valid" << std::endl;
+        return false;
+    }
+
+    utils::setComponentData<ignition::gazebo::components::PhysicsThreads>(
+        m_ecm, m_entity, numOfThreads);
+
+    return true;
+}
+
+size_t World::physicsThreads() const
+{
+    // Worlds without the component process the state serially
+    auto* component =
+        m_ecm->Component<ignition::gazebo::components::PhysicsThreads>(
+            m_entity);
+
+    return component ? component->Data() : 1;
+}
+
 bool World::valid() const
 {
     return this->validEntity();
@@ -321,8 +448,8 @@ bool World::insertModel(const std::string& modelFile,
     }
 
     if (utils::verboseFromEnvironment()) {
-        sDebug << "Inserting a model from the following SDF:" << std::endl;
-        std::cout << modelSdfRoot->Element()->ToString("") << std::endl;
+        sDebug << "Inserting a model from the following SDF:" << std::endl
+               << modelSdfRoot->Element()->ToString("") << std::endl;
     }
 
     // Create the model entity
@@ -392,5 +519,238 @@ bool World::removeModel(const std::string& modelName)
     // Remove the cached model
     pImpl->models.erase(modelName);
 
+    // Invalidate the resolved entities of the batched methods
+    pImpl->batchLayouts.clear();
+
     return true;
 }
+
+std::vector<double>
+World::batchJointPositions(const std::vector<std::string>& modelNames,
+                           const std::vector<std::string>& jointNames) const
+{
+    return pImpl->getBatchJointData< //
+        ignition::gazebo::components::JointPosition>(
+        *this, modelNames, jointNames);
+}
+
+std::vector<double>
+World::batchJointVelocities(const std::vector<std::string>& modelNames,
+                            const std::vector<std::string>& jointNames) const
+{
+    return pImpl->getBatchJointData< //
+        ignition::gazebo::components::JointVelocity>(
+        *this, modelNames, jointNames);
+}
+
+std::vector<double>
+World::batchBasePoses(const std::vector<std::string>& modelNames) const
+{
+    const auto* layout = pImpl->getBatchLayout(*this, modelNames, {});
+
+    if (!layout) {
+        return {};
+    }
+
+    std::vector<double> data;
+    data.reserve(7 * layout->modelEntities.size());
+
+    for (const auto modelEntity : layout->modelEntities) {
+        const auto* pose = utils::tryGetExistingComponentData< //
+            ignition::gazebo::components::Pose>(m_ecm, modelEntity);
+
+        if (!pose) {
+            sError << "Failed to read the pose of model [" << modelEntity
+                   << "]" << std::endl;
+            return {};
+        }
+
+        data.insert(data.end(),
+                    {pose->Pos().X(),
+                     pose->Pos().Y(),
+                     pose->Pos().Z(),
+                     pose->Rot().W(),
+                     pose->Rot().X(),
+                     pose->Rot().Y(),
+                     pose->Rot().Z()});
+    }
+
+    return data;
+}
+
+bool World::setBatchJointGeneralizedForceTargets(
+    const std::vector<double>& forces,
+    const std::vector<std::string>& modelNames,
+    const std::vector<std::string>& jointNames)
+{
+    const auto* layout = pImpl->getBatchLayout(*this, modelNames, jointNames);
+
+    if (!layout) {
+        return false;
+    }
+
+    if (forces.size() != layout->dofsPerModel * modelNames.size()) {
+        sError << "The size of the forces does not match the considered "
+                  "joint's DOFs"
+               << std::endl;
+        return false;
+    }
+
+    auto it = forces.begin();
+
+    try {
+        for (const auto& joint : layout->joints) {
+            for (size_t dof = 0; dof < joint->dofs(); ++dof) {
+                if (!joint->setGeneralizedForceTarget(*it++, dof)) {
+                    sError << "Failed to set force of joint '"
+                           << joint->name() << "'" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        sError << e.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+World::Impl::BatchKey
+World::Impl::getBatchKey(const std::vector<std::string>& modelNames,
+                         const std::vector<std::string>& jointNames)
+{
+    BatchKey key = modelNames.size();
+
+    auto combine = [&key](const std::string& name) {
+        key ^= std::hash<std::string>{}(name) + 0x9e3779b9 + (key << 6)
+               + (key >> 2);
+    };
+
+    for (const auto& modelName : modelNames) {
+        combine(modelName);
+    }
+
+    // Separate the models from the joints
+    combine({});
+
+    for (const auto& jointName : jointNames) {
+        combine(jointName);
+    }
+
+    return key;
+}
+
+const World::Impl::BatchLayout*
+World::Impl::getBatchLayout(const World& world,
+                            const std::vector<std::string>& modelNames,
+                            const std::vector<std::string>& jointNames)
+{
+    const BatchKey key = getBatchKey(modelNames, jointNames);
+
+    if (const auto it = batchLayouts.find(key); it != batchLayouts.end()) {
+        const BatchLayout& cached = it->second;
+
+        // The models could have been removed or replaced through another
+        // handle of the world, e.g. a plugin
+        const bool valid =
+            cached.modelNames == modelNames && cached.jointNames == jointNames
+            && std::none_of(cached.modelEntities.begin(),
+                            cached.modelEntities.end(),
+                            [&](const ignition::gazebo::Entity entity) {
+                                return utils::isModelRemoved(world.ecm(),
+                                                             entity);
+                            });
+
+        if (valid) {
+            return &cached;
+        }
+
+        batchLayouts.erase(it);
+    }
+
+    if (modelNames.empty()) {
+        sError << "No models passed to the batched method" << std::endl;
+        return nullptr;
+    }
+
+    BatchLayout layout;
+    layout.modelNames = modelNames;
+    layout.jointNames = jointNames;
+
+    try {
+        for (const auto& modelName : modelNames) {
+            auto model =
+                std::static_pointer_cast<Model>(world.getModel(modelName));
+            layout.modelEntities.push_back(model->entity());
+
+            const std::vector<std::string>& jointSerialization =
+                jointNames.empty() ? model->jointNames() : jointNames;
+
+            size_t dofs = 0;
+
+            for (const auto& jointName : jointSerialization) {
+                auto joint =
+                    std::static_pointer_cast<Joint>(model->getJoint(jointName));
+
+                dofs += joint->dofs();
+                layout.joints.push_back(joint);
+                layout.jointEntities.push_back(joint->entity());
+            }
+
+            if (modelName == modelNames.front()) {
+                layout.dofsPerModel = dofs;
+            }
+            else if (dofs != layout.dofsPerModel) {
+                sError << "Model '" << modelName << "' has " << dofs
+                       << " DoFs while model '" << modelNames.front()
+                       << "' has " << layout.dofsPerModel << " DoFs"
+                       << std::endl;
+                return nullptr;
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        sError << e.what() << std::endl;
+        return nullptr;
+    }
+
+    if (batchLayouts.size() >= MaxBatchLayouts) {
+        batchLayouts.clear();
+    }
+
+    return &(batchLayouts[key] = std::move(layout));
+}
+
+template <typename ComponentType>
+std::vector<double>
+World::Impl::getBatchJointData(const World& world,
+                               const std::vector<std::string>& modelNames,
+                               const std::vector<std::string>& jointNames)
+{
+    const auto* layout = getBatchLayout(world, modelNames, jointNames);
+
+    if (!layout) {
+        return {};
+    }
+
+    std::vector<double> data;
+    data.reserve(layout->dofsPerModel * modelNames.size());
+
+    for (const auto jointEntity : layout->jointEntities) {
+        const auto* jointData =
+            utils::tryGetExistingComponentData<ComponentType>(world.ecm(),
+                                                              jointEntity);
+
+        if (!jointData) {
+            sError << "Failed to read the state of joint [" << jointEntity
+                   << "]" << std::endl;
+            return {};
+        }
+
+        data.insert(data.end(), jointData->begin(), jointData->end());
+    }
+
+    return data;
+}
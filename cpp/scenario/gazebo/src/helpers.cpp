@@ -27,6 +27,7 @@
 #include "scenario/gazebo/helpers.h"
 #include "ignition/common/Util.hh"
 #include "scenario/gazebo/Log.h"
+#include "scenario/gazebo/components/ReferencesVersion.h"
 
 #include <Eigen/Dense>
 #include <ignition/gazebo/components/Component.hh>
@@ -341,17 +342,6 @@ bool utils::updateSDFPhysics(sdf::Root& sdfRoot,
                              const double realTimeUpdateRate,
                              const size_t worldIndex)
 {
-    if (rtf <= 0) {
-        sError << "Invalid RTF value (" << rtf << ")" << std::endl;
-        return false;
-    }
-
-    if (maxStepSize <= 0) {
-        sError << "Invalid physics max step size (" << maxStepSize << ")"
-               << std::endl;
-        return false;
-    }
-
     const sdf::World* world = sdfRoot.WorldByIndex(worldIndex);
 
     if (world->PhysicsCount() != 1) {
@@ -359,18 +349,51 @@ bool utils::updateSDFPhysics(sdf::Root& sdfRoot,
         return false;
     }
 
+    // Update the DOM operating directly on the raw elements
+    if (!updateSDFPhysics(
+            world->Element(), maxStepSize, rtf, realTimeUpdateRate)) {
+        return false;
+    }
+
     // Set the physics properties using the helper.
     // It sets the internal value but it does not update the DOM.
     auto* physics = const_cast<sdf::Physics*>(world->PhysicsByIndex(0));
     physics->SetMaxStepSize(maxStepSize);
     physics->SetRealTimeFactor(rtf);
 
-    // Update the DOM operating directly on the raw elements
-    sdf::ElementPtr worldElement = world->Element();
+    return true;
+}
+
+bool utils::updateSDFPhysics(const sdf::ElementPtr worldElement,
+                             const double maxStepSize,
+                             const double rtf,
+                             const double realTimeUpdateRate)
+{
+    if (rtf <= 0) {
+        sError << "Invalid RTF value (" << rtf << ")" << std::endl;
+        return false;
+    }
+
+    if (maxStepSize <= 0) {
+        sError << "Invalid physics max step size (" << maxStepSize << ")"
+               << std::endl;
+        return false;
+    }
 
+    if (!worldElement || worldElement->GetName() != "world") {
+        sError << "The SDF element is not a world" << std::endl;
+        return false;
+    }
+
+    // If the world has no physics element, a default one is created
     sdf::ElementPtr physicsElement = worldElement->GetElement("physics");
     assert(physicsElement);
 
+    if (physicsElement->GetNextElement("physics")) {
+        sError << "Found more than one physics profile" << std::endl;
+        return false;
+    }
+
     sdf::ElementPtr max_step_size = physicsElement->GetElement("max_step_size");
     max_step_size->AddValue("double", std::to_string(maxStepSize), true);
 
@@ -521,6 +544,37 @@ std::shared_ptr<World> utils::getParentWorld(const GazeboEntity& gazeboEntity)
     return world;
 }
 
+bool utils::isModelRemoved(ignition::gazebo::EntityComponentManager* ecm,
+                           const ignition::gazebo::Entity modelEntity)
+{
+    if (!ecm || !ecm->HasEntity(modelEntity)) {
+        return true;
+    }
+
+    // Models removed in this step are still in the ECM until the end of the
+    // step, and they are visited by EachRemoved
+    bool removed = false;
+
+    ecm->EachRemoved<ignition::gazebo::components::Model>(
+        [&](const ignition::gazebo::Entity& entity,
+            const ignition::gazebo::components::Model*) -> bool {
+            removed = (entity == modelEntity);
+            return !removed;
+        });
+
+    return removed;
+}
+
+void utils::updateReferencesVersion(
+    ignition::gazebo::EntityComponentManager* ecm,
+    const ignition::gazebo::Entity modelEntity)
+{
+    auto& version = utils::getComponentData< //
+        ignition::gazebo::components::ReferencesVersion>(ecm, modelEntity);
+
+    version++;
+}
+
 std::shared_ptr<Model> utils::getParentModel(const GazeboEntity& gazeboEntity)
 {
     if (!gazeboEntity.validEntity()) {
@@ -25,30 +25,24 @@
  */
 
 #include "ControllerRunner.h"
-#include "ControllersFactory.h"
-#include "scenario/controllers/Controller.h"
-#include "scenario/controllers/References.h"
-#include "scenario/gazebo/Link.h"
+#include "ControllerScheduler.h"
+#include "scenario/core/utils/ThreadPool.h"
 #include "scenario/gazebo/Log.h"
-#include "scenario/gazebo/Model.h"
-#include "scenario/gazebo/components/BasePoseTarget.h"
-#include "scenario/gazebo/components/BaseWorldAccelerationTarget.h"
-#include "scenario/gazebo/components/BaseWorldVelocityTarget.h"
-#include "scenario/gazebo/exceptions.h"
 #include "scenario/gazebo/helpers.h"
 
-#include <ignition/math/Helpers.hh>
-#include <ignition/math/Pose3.hh>
-#include <ignition/math/Vector3.hh>
+#include <ignition/gazebo/components/Model.hh>
+#include <ignition/gazebo/components/Name.hh>
+#include <ignition/gazebo/components/ParentEntity.hh>
+#include <ignition/gazebo/components/World.hh>
 #include <ignition/plugin/Register.hh>
 #include <sdf/Element.hh>
 
-#include <array>
+#include <atomic>
 #include <cassert>
-#include <chrono>
-#include <limits>
-#include <ratio>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using namespace scenario::gazebo;
@@ -57,32 +51,35 @@ using namespace scenario::plugins::gazebo;
 class ControllerRunner::Impl
 {
 public:
-    bool referencesHaveBeenSet = false;
+    // Scheduler of the controllers, if the plugin is inserted in a model
+    std::unique_ptr<ControllerScheduler> scheduler;
 
-    std::shared_ptr<Model> model;
-    ignition::gazebo::Entity modelEntity;
-    std::chrono::steady_clock::duration prevUpdateTime{0};
+    // If the plugin is inserted in a world, it schedules the controllers of
+    // the models listed in its context. Different models run in parallel.
+    ignition::gazebo::Entity worldEntity = ignition::gazebo::kNullEntity;
+    ignition::gazebo::EventManager* eventManager = nullptr;
 
-    std::shared_ptr<controllers::Controller> controller;
+    std::unordered_map<std::string, std::vector<sdf::ElementPtr>>
+        modelContexts;
+    std::unordered_map<std::string, std::unique_ptr<ControllerScheduler>>
+        schedulers;
+    std::unordered_set<ignition::gazebo::Entity> failedModels;
 
-    controllers::BaseReferences baseReferences;
-    controllers::JointReferences jointReferences;
+    size_t numOfThreads = 0;
+    std::unique_ptr<core::utils::ThreadPool> threadPool;
+    std::vector<ControllerScheduler*> parallelSchedulers;
 
-    struct
-    {
-        controllers::SetBaseReferences* base = nullptr;
-        controllers::UseScenarioModel* useModel = nullptr;
-        controllers::SetJointReferences* joints = nullptr;
-    } controllerInterfaces;
+    static std::vector<sdf::ElementPtr>
+    getControllerContexts(const sdf::ElementPtr parent);
 
-    bool
-    updateAllSupportedReferences(ignition::gazebo::EntityComponentManager& ecm);
+    void updateWorldSchedulers(ignition::gazebo::EntityComponentManager& ecm);
 
-    bool
-    updateBaseReferencesfromECM(ignition::gazebo::EntityComponentManager& ecm);
+    void stepWorldSchedulers(const ignition::gazebo::UpdateInfo& info,
+                             ignition::gazebo::EntityComponentManager& ecm);
 
-    bool
-    updateJointReferencesfromECM(ignition::gazebo::EntityComponentManager& ecm);
+    static size_t
+    countComponents(const ignition::gazebo::Entity modelEntity,
+                    const ignition::gazebo::EntityComponentManager& ecm);
 
     void printControllerContext(
         const std::shared_ptr<const sdf::Element> context) const;
@@ -104,24 +101,6 @@ void ControllerRunner::Configure(const ignition::gazebo::Entity& entity,
                                  ignition::gazebo::EntityComponentManager& ecm,
                                  ignition::gazebo::EventManager& eventMgr)
 {
-
-    // Store the model entity
-    pImpl->modelEntity = entity;
-
-    // Create a model that will be given to the controller
-    pImpl->model = std::make_shared<Model>();
-
-    if (!pImpl->model->initialize(entity, &ecm, &eventMgr)) {
-        sError << "Failed to initialize model for controller" << std::endl;
-        return;
-    }
-
-    if (!pImpl->model->valid()) {
-        sError << "Failed to create a model from Entity [" << entity << "]"
-               << std::endl;
-        return;
-    }
-
     if (sdf->GetName() != "plugin") {
         sError << "Received context does not contain the <plugin> element"
                << std::endl;
@@ -131,53 +110,59 @@ void ControllerRunner::Configure(const ignition::gazebo::Entity& entity,
     // This is the <plugin> element (with extra options stored in its children)
     sdf::ElementPtr pluginElement = sdf->Clone();
 
-    // Initialize the controller context
-    sdf::ElementPtr controllerContext;
+    if (utils::verboseFromEnvironment()) {
+        pImpl->printControllerContext(pluginElement);
+    }
+
+    if (ecm.EntityHasComponentType(
+            entity, ignition::gazebo::components::World::typeId)) {
 
-    // Check if it contains extra options stored in a <controller> child
-    if (pluginElement->HasElement("controller")) {
-        // Store the <controller> element
-        controllerContext = pluginElement->GetElement("controller");
+        if (pluginElement->HasElement("threads")) {
+            const int threads = pluginElement->Get<int>("threads");
 
-        if (utils::verboseFromEnvironment()) {
-            pImpl->printControllerContext(pluginElement);
+            if (threads < 0) {
+                sError << "The number of threads cannot be negative"
+                       << std::endl;
+                return;
+            }
+
+            pImpl->numOfThreads = static_cast<size_t>(threads);
         }
-    }
 
-    pImpl->controller =
-        ControllersFactory::Instance().get(controllerContext, pImpl->model);
+        if (pluginElement->HasElement("model")) {
+            for (auto model = pluginElement->GetElement("model"); model;
+                 model = model->GetNextElement("model")) {
 
-    if (!pImpl->controller) {
-        sError << "Failed to find controller in the factory" << std::endl;
-        return;
-    }
+                if (!model->HasAttribute("name")) {
+                    sError << "Found <model> element without name"
+                           << std::endl;
+                    return;
+                }
 
-    if (!pImpl->controller->initialize()) {
-        sError << "Failed to initialize the controller" << std::endl;
-        pImpl->controller = nullptr;
+                const std::string modelName =
+                    model->GetAttribute("name")->GetAsString();
+                pImpl->modelContexts[modelName] =
+                    Impl::getControllerContexts(model);
+            }
+        }
+
+        // The models are resolved when they are inserted in the world
+        pImpl->worldEntity = entity;
+        pImpl->eventManager = &eventMgr;
         return;
     }
 
-    pImpl->controllerInterfaces.useModel = dynamic_cast< //
-        controllers::UseScenarioModel*>(pImpl->controller.get());
-
-    pImpl->controllerInterfaces.base = dynamic_cast< //
-        controllers::SetBaseReferences*>(pImpl->controller.get());
-
-    pImpl->controllerInterfaces.joints = dynamic_cast< //
-        controllers::SetJointReferences*>(pImpl->controller.get());
+    auto scheduler = std::make_unique<ControllerScheduler>();
 
-    // Controller classes could inherit from various interfaces that specify the
-    // accepted references. This design allows developing generic controllers.
-    // Here we check if the controller inherits from the supported interfaces.
-    if (!(pImpl->controllerInterfaces.base
-          || pImpl->controllerInterfaces.joints)) {
-        sWarning << "Failed to find any of the supported interfaces to set "
-                 << "controller references" << std::endl;
+    if (!scheduler->initialize(entity,
+                               Impl::getControllerContexts(pluginElement),
+                               ecm,
+                               eventMgr)) {
+        sError << "Failed to initialize the controllers" << std::endl;
         return;
     }
 
-    sDebug << "Controller successfully initialized" << std::endl;
+    pImpl->scheduler = std::move(scheduler);
 }
 
 void ControllerRunner::PreUpdate(const ignition::gazebo::UpdateInfo& info,
@@ -187,200 +172,160 @@ void ControllerRunner::PreUpdate(const ignition::gazebo::UpdateInfo& info,
         return;
     }
 
-    if (!pImpl->model) {
+    if (pImpl->worldEntity != ignition::gazebo::kNullEntity) {
+        pImpl->updateWorldSchedulers(ecm);
+        pImpl->stepWorldSchedulers(info, ecm);
         return;
     }
 
-    // This plugin keep being called also after the model was removed
-    try {
-        pImpl->model->controllerPeriod();
-    }
-    catch (exceptions::ComponentNotFound) {
+    if (!pImpl->scheduler) {
         return;
     }
 
-    if (!pImpl->controller) {
-        sError << "The controller was not initialized successfully"
-               << std::endl;
+    // This plugin keeps being called also after the model was removed
+    if (utils::isModelRemoved(&ecm, pImpl->scheduler->modelEntity())) {
+        pImpl->scheduler = nullptr;
         return;
     }
 
-    using namespace std::chrono;
-
-    // Update the controller only if enough time is passed
-    duration<double> elapsedFromLastUpdate =
-        info.simTime - pImpl->prevUpdateTime;
-    assert(elapsedFromLastUpdate.count() > 0);
-
-    // Handle first iteration
-    if (pImpl->prevUpdateTime.count() == 0) {
-        elapsedFromLastUpdate =
-            duration<double>(pImpl->model->controllerPeriod());
-    }
-
-    // If enough time has passed, store the time of this actuation step. In this
-    // case the state of the robot is read and new force references are computed
-    // and actuated. Otherwise, the same force of the last step is actuated.
-    bool computeNewForce;
-
-    // Due to numerical floating point approximations, sometimes a comparison of
-    // chrono durations has an error in the 1e-18 order
-    auto greaterThan = [](const duration<double>& a,
-                          const duration<double>& b) -> bool {
-        return a.count() >= b.count() - std::numeric_limits<double>::epsilon();
-    };
-
-    if (greaterThan(elapsedFromLastUpdate,
-                    duration<double>(pImpl->model->controllerPeriod()))) {
-        // Store the current update time
-        pImpl->prevUpdateTime = info.simTime;
-
-        // Enable using the controller to compute the new force
-        computeNewForce = true;
-    }
-    else {
-        // Disable the controller and send the same force reference as last
-        // update
-        computeNewForce = false;
+    if (!pImpl->scheduler->step(info, ecm)) {
+        sError << "Failed to step the controllers" << std::endl;
+        return;
     }
+}
 
-    // Get and set the new references
-    if (computeNewForce) {
-
-        try {
-            if (!pImpl->updateAllSupportedReferences(ecm)) {
-                sError << "Failed to update supported references" << std::endl;
-                return;
-            }
-        }
-        catch (const exceptions::ComponentNotFound& e) {
-            sDebug << "Controller references not yet available" << std::endl;
-            sDebug << e.what();
-            sWarning << "[t="
-                     << utils::steadyClockDurationToDouble(info.simTime)
-                     << "] The controller is not stepping" << std::endl;
-            return;
-        }
-
-        if (pImpl->controllerInterfaces.useModel
-            && !pImpl->controllerInterfaces.useModel->updateStateFromModel()) {
-            sError << "Failed to update controller state from internal model"
-                   << std::endl;
-            return;
-        }
+std::vector<sdf::ElementPtr>
+ControllerRunner::Impl::getControllerContexts(const sdf::ElementPtr parent)
+{
+    std::vector<sdf::ElementPtr> contexts;
 
-        // The controller is stepped only when the references have been set
-        // at least once
-        pImpl->referencesHaveBeenSet = true;
+    if (!parent->HasElement("controller")) {
+        return contexts;
     }
 
-    // Step the controller
-    if (pImpl->referencesHaveBeenSet && !pImpl->controller->step(info.dt)) {
-        sError << "Failed to step the controller" << std::endl;
-        return;
+    for (auto context = parent->GetElement("controller"); context;
+         context = context->GetNextElement("controller")) {
+        contexts.push_back(context);
     }
+
+    return contexts;
 }
 
-bool ControllerRunner::Impl::updateAllSupportedReferences(
+void ControllerRunner::Impl::updateWorldSchedulers(
     ignition::gazebo::EntityComponentManager& ecm)
 {
-    bool ok = true;
+    using namespace ignition::gazebo;
 
-    if (controllerInterfaces.base) {
-        if (!updateBaseReferencesfromECM(ecm)) {
-            sError << "Failed to update base references" << std::endl;
-            ok = false;
+    // Remove the schedulers of the removed models. They are created again
+    // if a model with the same name is inserted.
+    for (auto it = schedulers.begin(); it != schedulers.end();) {
+        if (utils::isModelRemoved(&ecm, it->second->modelEntity())) {
+            it = schedulers.erase(it);
         }
         else {
-            if (!controllerInterfaces.base->setBaseReferences(baseReferences)) {
-                sError << "Failed to set base references" << std::endl;
-                ok = false;
-            }
+            ++it;
         }
     }
 
-    if (controllerInterfaces.joints) {
-        if (!updateJointReferencesfromECM(ecm)) {
-            sError << "Failed to update joint references" << std::endl;
-            ok = false;
+    for (const auto& [modelName, contexts] : modelContexts) {
+        if (schedulers.find(modelName) != schedulers.end()) {
+            continue;
         }
-        else {
-            if (!controllerInterfaces.joints->setJointReferences(
-                    jointReferences)) {
-                sError << "Failed to set joint references" << std::endl;
-                ok = false;
-            }
-        }
-    }
 
-    return ok;
-}
+        const Entity modelEntity =
+            ecm.EntityByComponents(components::Model(),
+                                   components::Name(modelName),
+                                   components::ParentEntity(worldEntity));
 
-bool ControllerRunner::Impl::updateBaseReferencesfromECM(
-    ignition::gazebo::EntityComponentManager& ecm)
-{
-    assert(controllerInterfaces.base);
-    using namespace ignition::math;
-    using namespace ignition::gazebo;
+        if (modelEntity == kNullEntity
+            || failedModels.find(modelEntity) != failedModels.end()) {
+            continue;
+        }
 
-    // =========
-    // Base Pose
-    // =========
+        auto scheduler = std::make_unique<ControllerScheduler>();
 
-    Pose3d& basePoseTarget = utils::getExistingComponentData< //
-        components::BasePoseTarget>(&ecm, modelEntity);
+        if (!scheduler->initialize(modelEntity, contexts, ecm, *eventManager)) {
+            sError << "Failed to initialize the controllers of model '"
+                   << modelName << "'" << std::endl;
+            failedModels.insert(modelEntity);
+            continue;
+        }
 
-    core::Pose basePose = utils::fromIgnitionPose(basePoseTarget);
-    baseReferences.position = basePose.position;
-    baseReferences.orientation = basePose.orientation;
+        schedulers[modelName] = std::move(scheduler);
+    }
+}
 
-    // =============
-    // Base Velocity
-    // =============
+void ControllerRunner::Impl::stepWorldSchedulers(
+    const ignition::gazebo::UpdateInfo& info,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    parallelSchedulers.clear();
+
+    for (auto& [modelName, scheduler] : schedulers) {
+        // The first step of each controller could create new components,
+        // and changing the structure of the ECM is not thread safe
+        if (!scheduler->allControllersStepped()) {
+            if (!scheduler->step(info, ecm)) {
+                sError << "Failed to step the controllers of model '"
+                       << modelName << "'" << std::endl;
+            }
+            continue;
+        }
 
-    Vector3d baseLinearVelocityTarget = utils::getExistingComponentData< //
-        components::BaseWorldLinearVelocityTarget>(&ecm, modelEntity);
+        parallelSchedulers.push_back(scheduler.get());
+    }
 
-    Vector3d baseAngularVelocityTarget = utils::getExistingComponentData< //
+    if (parallelSchedulers.empty()) {
+        return;
+    }
 
-        components::BaseWorldAngularVelocityTarget>(&ecm, modelEntity);
+    if (!threadPool) {
+        threadPool = std::make_unique<core::utils::ThreadPool>(numOfThreads);
+    }
 
-    baseReferences.linearVelocity =
-        utils::fromIgnitionVector(baseLinearVelocityTarget);
-    baseReferences.angularVelocity =
-        utils::fromIgnitionVector(baseAngularVelocityTarget);
+#ifndef NDEBUG
+    std::vector<size_t> numOfComponents;
 
-    // =================
-    // Base Acceleration
-    // =================
+    for (const auto* scheduler : parallelSchedulers) {
+        numOfComponents.push_back(
+            countComponents(scheduler->modelEntity(), ecm));
+    }
+#endif
 
-    Vector3d baseLinearAccelerationTarget = utils::getExistingComponentData< //
-        components::BaseWorldLinearAccelerationTarget>(&ecm, modelEntity);
+    // The schedulers of different models access disjoint entities
+    std::atomic<size_t> failures{0};
 
-    Vector3d baseAngularAccelerationTarget = utils::getExistingComponentData< //
-        components::BaseWorldAngularAccelerationTarget>(&ecm, modelEntity);
+    threadPool->parallelFor(parallelSchedulers.size(), [&](const size_t i) {
+        if (!parallelSchedulers[i]->step(info, ecm)) {
+            failures++;
+        }
+    });
 
-    baseReferences.linearAcceleration =
-        utils::fromIgnitionVector(baseLinearAccelerationTarget);
-    baseReferences.angularAcceleration =
-        utils::fromIgnitionVector(baseAngularAccelerationTarget);
+#ifndef NDEBUG
+    for (size_t i = 0; i < parallelSchedulers.size(); ++i) {
+        assert(countComponents(parallelSchedulers[i]->modelEntity(), ecm)
+                   == numOfComponents[i]
+               && "Controllers created components while running in parallel");
+    }
+#endif
 
-    return true;
+    if (failures > 0) {
+        sError << "Failed to step the controllers of " << failures
+               << " models" << std::endl;
+    }
 }
 
-bool ControllerRunner::Impl::updateJointReferencesfromECM(
-    ignition::gazebo::EntityComponentManager& /*ecm*/)
+size_t ControllerRunner::Impl::countComponents(
+    const ignition::gazebo::Entity modelEntity,
+    const ignition::gazebo::EntityComponentManager& ecm)
 {
-    assert(controllerInterfaces.joints);
+    size_t numOfComponents = 0;
 
-    auto& controlledJoints = controllerInterfaces.joints->controlledJoints();
-
-    jointReferences.position = model->jointPositionTargets(controlledJoints);
-    jointReferences.velocity = model->jointVelocityTargets(controlledJoints);
-    jointReferences.acceleration =
-        model->jointAccelerationTargets(controlledJoints);
+    for (const auto entity : ecm.Descendants(modelEntity)) {
+        numOfComponents += ecm.ComponentTypes(entity).size();
+    }
 
-    return true;
+    return numOfComponents;
 }
 
 void ControllerRunner::Impl::printControllerContext(
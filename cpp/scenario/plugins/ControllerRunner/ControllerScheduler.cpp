@@ -0,0 +1,638 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ControllerScheduler.h"
+#include "ControllersFactory.h"
+#include "scenario/controllers/Controller.h"
+#include "scenario/controllers/References.h"
+#include "scenario/gazebo/Joint.h"
+#include "scenario/gazebo/Log.h"
+#include "scenario/gazebo/Model.h"
+#include "scenario/gazebo/components/BasePoseTarget.h"
+#include "scenario/gazebo/components/BaseWorldAccelerationTarget.h"
+#include "scenario/gazebo/components/BaseWorldVelocityTarget.h"
+#include "scenario/gazebo/components/JointAccelerationTarget.h"
+#include "scenario/gazebo/components/JointPositionTarget.h"
+#include "scenario/gazebo/components/JointVelocityTarget.h"
+#include "scenario/gazebo/components/ReferencesVersion.h"
+#include "scenario/gazebo/exceptions.h"
+#include "scenario/gazebo/helpers.h"
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace scenario::gazebo;
+using namespace scenario::plugins::gazebo;
+
+class ControllerScheduler::Impl
+{
+public:
+    struct ScheduledController
+    {
+        std::string name;
+        std::shared_ptr<controllers::Controller> controller;
+
+        struct
+        {
+            controllers::SetBaseReferences* base = nullptr;
+            controllers::UseScenarioModel* useModel = nullptr;
+            controllers::SetJointReferences* joints = nullptr;
+            controllers::GetJointReferences* output = nullptr;
+        } interfaces;
+
+        // Period read from the context, zero uses the model controller period
+        double period = 0.0;
+
+        // Period expressed in physics steps
+        uint64_t periodTicks = 1;
+
+        // Index of the controller whose output is used as joint references
+        std::optional<size_t> input;
+
+        // True if the output is the input of another controller
+        bool chained = false;
+
+        bool referencesHaveBeenSet = false;
+
+        // True after the first call to the step of the controller
+        bool stepped = false;
+
+        // Version of the model references copied in the last update
+        std::optional<uint64_t> referencesVersion;
+
+        controllers::BaseReferences baseReferences;
+        controllers::JointReferences jointReferences;
+
+        // Entities of the controlled joints, resolved during initialization
+        std::vector<ignition::gazebo::Entity> controlledJointEntities;
+    };
+
+    std::shared_ptr<Model> model;
+    ignition::gazebo::Entity modelEntity = ignition::gazebo::kNullEntity;
+
+    std::vector<ScheduledController> controllers;
+
+    // Number of processed physics steps. The controllers are scheduled on
+    // this counter instead of the simulated time.
+    uint64_t ticks = 0;
+
+    // Step size and model controller period used to resolve the periods,
+    // and the tick from which the resolved schedule starts
+    std::chrono::steady_clock::duration stepSize{0};
+    double modelPeriod = 0.0;
+    uint64_t scheduleStart = 0;
+
+    void resolvePeriods(const std::chrono::steady_clock::duration& dt,
+                        const double modelPeriod);
+
+    bool createController(const sdf::ElementPtr context);
+
+    bool stepController(ScheduledController& scheduled,
+                        const bool computeNewOutput,
+                        const ignition::gazebo::UpdateInfo& info,
+                        ignition::gazebo::EntityComponentManager& ecm);
+
+    bool referencesChanged(const ScheduledController& scheduled,
+                           ignition::gazebo::EntityComponentManager& ecm);
+
+    bool referencesAvailable(const ScheduledController& scheduled,
+                             ignition::gazebo::EntityComponentManager& ecm);
+
+    bool updateAllSupportedReferences(
+        ScheduledController& scheduled,
+        ignition::gazebo::EntityComponentManager& ecm);
+
+    bool updateBaseReferencesfromECM(
+        ScheduledController& scheduled,
+        ignition::gazebo::EntityComponentManager& ecm);
+
+    bool updateJointReferencesfromECM(ScheduledController& scheduled);
+};
+
+ControllerScheduler::ControllerScheduler()
+    : pImpl{std::make_unique<Impl>()}
+{}
+
+ControllerScheduler::~ControllerScheduler() = default;
+
+bool ControllerScheduler::initialize(
+    const ignition::gazebo::Entity modelEntity,
+    const std::vector<sdf::ElementPtr>& contexts,
+    ignition::gazebo::EntityComponentManager& ecm,
+    ignition::gazebo::EventManager& eventMgr)
+{
+    pImpl->modelEntity = modelEntity;
+
+    // Create a model that will be given to the controllers
+    auto model = std::make_shared<Model>();
+
+    if (!model->initialize(modelEntity, &ecm, &eventMgr)) {
+        sError << "Failed to initialize model for controller" << std::endl;
+        return false;
+    }
+
+    if (!model->valid()) {
+        sError << "Failed to create a model from Entity [" << modelEntity
+               << "]" << std::endl;
+        return false;
+    }
+
+    if (contexts.empty()) {
+        sError << "No controllers found in the context" << std::endl;
+        return false;
+    }
+
+    pImpl->model = model;
+
+    for (const auto& context : contexts) {
+        if (!pImpl->createController(context)) {
+            pImpl->controllers.clear();
+            pImpl->model = nullptr;
+            return false;
+        }
+    }
+
+    sDebug << "Scheduled " << pImpl->controllers.size()
+           << " controllers of model '" << model->name() << "'" << std::endl;
+    return true;
+}
+
+bool ControllerScheduler::step(const ignition::gazebo::UpdateInfo& info,
+                               ignition::gazebo::EntityComponentManager& ecm)
+{
+    if (!pImpl->model) {
+        return false;
+    }
+
+    // The periods are converted in steps when the step size is known, and
+    // they are converted again when either the step size or the controller
+    // period of the model change
+    const double modelPeriod = pImpl->model->controllerPeriod();
+
+    if (info.dt != pImpl->stepSize || modelPeriod != pImpl->modelPeriod) {
+        pImpl->resolvePeriods(info.dt, modelPeriod);
+    }
+
+    bool ok = true;
+    const uint64_t scheduleTicks = pImpl->ticks - pImpl->scheduleStart;
+
+    for (auto& scheduled : pImpl->controllers) {
+        const bool computeNewOutput =
+            scheduleTicks % scheduled.periodTicks == 0;
+
+        // Controllers whose output is chained do not actuate the model
+        if (!computeNewOutput && scheduled.chained) {
+            continue;
+        }
+
+        if (!pImpl->stepController(scheduled, computeNewOutput, info, ecm)) {
+            sError << "Failed to step controller '" << scheduled.name << "'"
+                   << std::endl;
+            ok = false;
+        }
+    }
+
+    pImpl->ticks++;
+    return ok;
+}
+
+uint64_t ControllerScheduler::ticks() const
+{
+    return pImpl->ticks;
+}
+
+ignition::gazebo::Entity ControllerScheduler::modelEntity() const
+{
+    return pImpl->modelEntity;
+}
+
+bool ControllerScheduler::allControllersStepped() const
+{
+    return std::all_of(pImpl->controllers.begin(),
+                       pImpl->controllers.end(),
+                       [](const Impl::ScheduledController& scheduled) {
+                           return scheduled.stepped;
+                       });
+}
+
+void ControllerScheduler::Impl::resolvePeriods(
+    const std::chrono::steady_clock::duration& dt,
+    const double modelPeriod)
+{
+    this->stepSize = dt;
+    this->modelPeriod = modelPeriod;
+
+    // The new schedule starts from the current step
+    this->scheduleStart = ticks;
+
+    using namespace std::chrono;
+    const double stepSize = duration<double>(dt).count();
+
+    for (auto& scheduled : controllers) {
+        const double period =
+            scheduled.period > 0.0 ? scheduled.period : modelPeriod;
+
+        const auto ticks = std::llround(period / stepSize);
+        scheduled.periodTicks = static_cast<uint64_t>(std::max(ticks, 1ll));
+
+        const double scheduledPeriod = scheduled.periodTicks * stepSize;
+
+        if (std::abs(scheduledPeriod - period) > 1e-9 * period) {
+            sWarning << "The period of controller '" << scheduled.name
+                     << "' is not a multiple of the step size. It runs every "
+                     << scheduled.periodTicks << " steps (" << scheduledPeriod
+                     << " s)" << std::endl;
+        }
+
+        sDebug << "Controller '" << scheduled.name << "' runs every "
+               << scheduled.periodTicks << " steps" << std::endl;
+    }
+}
+
+bool ControllerScheduler::Impl::createController(
+    const sdf::ElementPtr context)
+{
+    ScheduledController scheduled;
+
+    if (context->HasAttribute("name")) {
+        context->GetAttribute("name")->Get<std::string>(scheduled.name);
+    }
+
+    for (const auto& other : controllers) {
+        if (other.name == scheduled.name) {
+            sError << "Controller '" << scheduled.name
+                   << "' is scheduled more than once" << std::endl;
+            return false;
+        }
+    }
+
+    if (context->HasAttribute("period")) {
+        context->GetAttribute("period")->Get<double>(scheduled.period);
+
+        if (!(scheduled.period > 0.0)) {
+            sError << "The period of controller '" << scheduled.name
+                   << "' must be positive" << std::endl;
+            return false;
+        }
+    }
+
+    if (context->HasAttribute("input")) {
+        std::string inputName;
+        context->GetAttribute("input")->Get<std::string>(inputName);
+
+        for (size_t i = 0; i < controllers.size(); ++i) {
+            if (controllers[i].name == inputName) {
+                scheduled.input = i;
+            }
+        }
+
+        if (!scheduled.input) {
+            sError << "The input '" << inputName << "' of controller '"
+                   << scheduled.name << "' is not a previous controller"
+                   << std::endl;
+            return false;
+        }
+
+        if (!controllers[*scheduled.input].interfaces.output) {
+            sError << "Controller '" << inputName
+                   << "' does not output joint references" << std::endl;
+            return false;
+        }
+    }
+
+    scheduled.controller = ControllersFactory::Instance().get(context, model);
+
+    if (!scheduled.controller) {
+        sError << "Failed to find controller in the factory" << std::endl;
+        return false;
+    }
+
+    if (!scheduled.controller->initialize()) {
+        sError << "Failed to initialize the controller" << std::endl;
+        return false;
+    }
+
+    auto* controller = scheduled.controller.get();
+
+    scheduled.interfaces.useModel = dynamic_cast< //
+        controllers::UseScenarioModel*>(controller);
+
+    scheduled.interfaces.base = dynamic_cast< //
+        controllers::SetBaseReferences*>(controller);
+
+    scheduled.interfaces.joints = dynamic_cast< //
+        controllers::SetJointReferences*>(controller);
+
+    scheduled.interfaces.output = dynamic_cast< //
+        controllers::GetJointReferences*>(controller);
+
+    // Controller classes could inherit from various interfaces that specify the
+    // accepted references. This design allows developing generic controllers.
+    // Here we check if the controller inherits from the supported interfaces.
+    if (!(scheduled.interfaces.base || scheduled.interfaces.joints)) {
+        sWarning << "Failed to find any of the supported interfaces to set "
+                 << "controller references" << std::endl;
+    }
+
+    if (scheduled.input && !scheduled.interfaces.joints) {
+        sError << "Controller '" << scheduled.name
+               << "' does not accept joint references from its input"
+               << std::endl;
+        return false;
+    }
+
+    if (scheduled.interfaces.joints) {
+        for (const auto& jointName :
+             scheduled.interfaces.joints->controlledJoints()) {
+            try {
+                auto joint =
+                    std::static_pointer_cast<Joint>(model->getJoint(jointName));
+                scheduled.controlledJointEntities.push_back(joint->entity());
+            }
+            catch (const exceptions::JointNotFound& e) {
+                sError << e.what() << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // The upstream controller is now stepped only at its own rate
+    if (scheduled.input) {
+        controllers[*scheduled.input].chained = true;
+    }
+
+    controllers.push_back(std::move(scheduled));
+    sDebug << "Controller successfully initialized" << std::endl;
+
+    return true;
+}
+
+bool ControllerScheduler::Impl::stepController(
+    ScheduledController& scheduled,
+    const bool computeNewOutput,
+    const ignition::gazebo::UpdateInfo& info,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    // Get and set the new references
+    if (computeNewOutput) {
+
+        if (scheduled.input) {
+            auto& upstream = controllers[*scheduled.input];
+
+            // The input is available after the first step of its controller
+            if (!upstream.referencesHaveBeenSet) {
+                return true;
+            }
+
+            if (!scheduled.interfaces.joints->setJointReferences(
+                    upstream.interfaces.output->outputJointReferences())) {
+                sError << "Failed to set joint references" << std::endl;
+                return false;
+            }
+        }
+        else if (referencesChanged(scheduled, ecm)) {
+            if (!referencesAvailable(scheduled, ecm)) {
+                sDebug << "Controller references not yet available"
+                       << std::endl;
+                sWarning << "[t="
+                         << utils::steadyClockDurationToDouble(info.simTime)
+                         << "] The controller is not stepping" << std::endl;
+                return true;
+            }
+
+            if (!updateAllSupportedReferences(scheduled, ecm)) {
+                sError << "Failed to update supported references"
+                       << std::endl;
+                return false;
+            }
+
+            const uint64_t* version = utils::tryGetExistingComponentData<
+                ignition::gazebo::components::ReferencesVersion>(&ecm,
+                                                                 modelEntity);
+
+            if (version) {
+                scheduled.referencesVersion = *version;
+            }
+        }
+
+        if (scheduled.interfaces.useModel
+            && !scheduled.interfaces.useModel->updateStateFromModel()) {
+            sError << "Failed to update controller state from internal model"
+                   << std::endl;
+            return false;
+        }
+
+        // The controller is stepped only when the references have been set
+        // at least once
+        scheduled.referencesHaveBeenSet = true;
+    }
+
+    if (!scheduled.referencesHaveBeenSet) {
+        return true;
+    }
+
+    // Chained controllers are stepped with their own period
+    using Rep = std::chrono::steady_clock::rep;
+    const std::chrono::steady_clock::duration dt =
+        scheduled.chained ? info.dt * static_cast<Rep>(scheduled.periodTicks)
+                          : info.dt;
+
+    scheduled.stepped = true;
+    return scheduled.controller->step(dt);
+}
+
+bool ControllerScheduler::Impl::referencesChanged(
+    const ScheduledController& scheduled,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    if (!scheduled.referencesVersion) {
+        return true;
+    }
+
+    // The version is incremented by all the setters of the targets
+    const uint64_t* version = utils::tryGetExistingComponentData<
+        ignition::gazebo::components::ReferencesVersion>(&ecm, modelEntity);
+
+    return !version || *version != *scheduled.referencesVersion;
+}
+
+bool ControllerScheduler::Impl::referencesAvailable(
+    const ScheduledController& scheduled,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    using namespace ignition::gazebo;
+
+    if (scheduled.interfaces.base) {
+        const bool baseReferencesAvailable =
+            utils::tryGetExistingComponent< //
+                components::BasePoseTarget>(&ecm, modelEntity)
+            && utils::tryGetExistingComponent< //
+                components::BaseWorldLinearVelocityTarget>(&ecm, modelEntity)
+            && utils::tryGetExistingComponent< //
+                components::BaseWorldAngularVelocityTarget>(&ecm, modelEntity)
+            && utils::tryGetExistingComponent< //
+                components::BaseWorldLinearAccelerationTarget>(&ecm,
+                                                               modelEntity)
+            && utils::tryGetExistingComponent< //
+                components::BaseWorldAngularAccelerationTarget>(&ecm,
+                                                                modelEntity);
+
+        if (!baseReferencesAvailable) {
+            return false;
+        }
+    }
+
+    for (const auto jointEntity : scheduled.controlledJointEntities) {
+        const bool jointReferencesAvailable =
+            utils::tryGetExistingComponent< //
+                components::JointPositionTarget>(&ecm, jointEntity)
+            && utils::tryGetExistingComponent< //
+                components::JointVelocityTarget>(&ecm, jointEntity)
+            && utils::tryGetExistingComponent< //
+                components::JointAccelerationTarget>(&ecm, jointEntity);
+
+        if (!jointReferencesAvailable) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ControllerScheduler::Impl::updateAllSupportedReferences(
+    ScheduledController& scheduled,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    bool ok = true;
+    auto& interfaces = scheduled.interfaces;
+
+    if (interfaces.base) {
+        if (!updateBaseReferencesfromECM(scheduled, ecm)) {
+            sError << "Failed to update base references" << std::endl;
+            ok = false;
+        }
+        else {
+            if (!interfaces.base->setBaseReferences(scheduled.baseReferences)) {
+                sError << "Failed to set base references" << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    if (interfaces.joints) {
+        if (!updateJointReferencesfromECM(scheduled)) {
+            sError << "Failed to update joint references" << std::endl;
+            ok = false;
+        }
+        else {
+            if (!interfaces.joints->setJointReferences(
+                    scheduled.jointReferences)) {
+                sError << "Failed to set joint references" << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+bool ControllerScheduler::Impl::updateBaseReferencesfromECM(
+    ScheduledController& scheduled,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    assert(scheduled.interfaces.base);
+    using namespace ignition::math;
+    using namespace ignition::gazebo;
+
+    auto& baseReferences = scheduled.baseReferences;
+
+    // =========
+    // Base Pose
+    // =========
+
+    Pose3d& basePoseTarget = utils::getExistingComponentData< //
+        components::BasePoseTarget>(&ecm, modelEntity);
+
+    core::Pose basePose = utils::fromIgnitionPose(basePoseTarget);
+    baseReferences.position = basePose.position;
+    baseReferences.orientation = basePose.orientation;
+
+    // =============
+    // Base Velocity
+    // =============
+
+    Vector3d baseLinearVelocityTarget = utils::getExistingComponentData< //
+        components::BaseWorldLinearVelocityTarget>(&ecm, modelEntity);
+
+    Vector3d baseAngularVelocityTarget = utils::getExistingComponentData< //
+        components::BaseWorldAngularVelocityTarget>(&ecm, modelEntity);
+
+    baseReferences.linearVelocity =
+        utils::fromIgnitionVector(baseLinearVelocityTarget);
+    baseReferences.angularVelocity =
+        utils::fromIgnitionVector(baseAngularVelocityTarget);
+
+    // =================
+    // Base Acceleration
+    // =================
+
+    Vector3d baseLinearAccelerationTarget = utils::getExistingComponentData< //
+        components::BaseWorldLinearAccelerationTarget>(&ecm, modelEntity);
+
+    Vector3d baseAngularAccelerationTarget = utils::getExistingComponentData< //
+        components::BaseWorldAngularAccelerationTarget>(&ecm, modelEntity);
+
+    baseReferences.linearAcceleration =
+        utils::fromIgnitionVector(baseLinearAccelerationTarget);
+    baseReferences.angularAcceleration =
+        utils::fromIgnitionVector(baseAngularAccelerationTarget);
+
+    return true;
+}
+
+bool ControllerScheduler::Impl::updateJointReferencesfromECM(
+    ScheduledController& scheduled)
+{
+    assert(scheduled.interfaces.joints);
+
+    auto& controlledJoints = scheduled.interfaces.joints->controlledJoints();
+    auto& jointReferences = scheduled.jointReferences;
+
+    jointReferences.position = model->jointPositionTargets(controlledJoints);
+    jointReferences.velocity = model->jointVelocityTargets(controlledJoints);
+    jointReferences.acceleration =
+        model->jointAccelerationTargets(controlledJoints);
+
+    return true;
+}
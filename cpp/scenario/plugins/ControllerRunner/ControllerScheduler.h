@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCENARIO_PLUGINS_GAZEBO_CONTROLLERSCHEDULER_H
+#define SCENARIO_PLUGINS_GAZEBO_CONTROLLERSCHEDULER_H
+
+#include <ignition/gazebo/Entity.hh>
+#include <ignition/gazebo/EntityComponentManager.hh>
+#include <ignition/gazebo/EventManager.hh>
+#include <ignition/gazebo/System.hh>
+#include <sdf/Element.hh>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace scenario::plugins::gazebo {
+    class ControllerScheduler;
+} // namespace scenario::plugins::gazebo
+
+/**
+ * Scheduler of the controllers of a model.
+ *
+ * Each controller is created from a <controller> context and runs with its
+ * own period. The optional period attribute is expressed in seconds and it
+ * defaults to the controller period of the model. Periods are converted to
+ * an integer number of physics steps, so that the schedule does not drift.
+ * They are converted again if the step size or the controller period of the
+ * model change.
+ *
+ * A controller can use as joint references the output of another controller
+ * of the model, selected by its name with the input attribute. The upstream
+ * controller has to be declared first:
+ *
+ * @code
+ * <controller name="WholeBody" period="0.01"/>
+ * <controller name="JointImpedance" period="0.001" input="WholeBody"/>
+ * @endcode
+ *
+ * Controllers whose output is the input of another controller are stepped
+ * only at their own rate. The other controllers actuate the model and are
+ * stepped at every physics step, since the forces are consumed by the
+ * physics.
+ */
+class scenario::plugins::gazebo::ControllerScheduler
+{
+public:
+    ControllerScheduler();
+    ~ControllerScheduler();
+
+    /**
+     * Create and initialize the controllers of a model.
+     *
+     * @param modelEntity The entity of the controlled model.
+     * @param contexts The <controller> elements, in execution order.
+     * @param ecm The entity-component manager.
+     * @param eventMgr The event manager.
+     * @return True for success, false otherwise.
+     */
+    bool initialize(const ignition::gazebo::Entity modelEntity,
+                    const std::vector<sdf::ElementPtr>& contexts,
+                    ignition::gazebo::EntityComponentManager& ecm,
+                    ignition::gazebo::EventManager& eventMgr);
+
+    /**
+     * Execute the controllers scheduled in the current physics step.
+     *
+     * The first step of a controller could create new components. Schedulers
+     * of different models can be stepped in parallel only after all their
+     * controllers have been stepped once.
+     *
+     * @param info The information of the current simulation step.
+     * @param ecm The entity-component manager.
+     * @return True for success, false otherwise.
+     */
+    bool step(const ignition::gazebo::UpdateInfo& info,
+              ignition::gazebo::EntityComponentManager& ecm);
+
+    /**
+     * Get the number of physics steps processed by the scheduler.
+     *
+     * @return The number of processed steps.
+     */
+    uint64_t ticks() const;
+
+    /**
+     * Check if all the controllers have been stepped at least once.
+     *
+     * @return True if all the controllers have been stepped, false otherwise.
+     */
+    bool allControllersStepped() const;
+
+    /**
+     * Get the entity of the controlled model.
+     *
+     * @return The entity of the model.
+     */
+    ignition::gazebo::Entity modelEntity() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // SCENARIO_PLUGINS_GAZEBO_CONTROLLERSCHEDULER_H
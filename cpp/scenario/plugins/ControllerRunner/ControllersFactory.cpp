@@ -26,8 +26,12 @@
 
 #include "ControllersFactory.h"
 #include "scenario/controllers/ComputedTorqueFixedBase.h"
+#include "scenario/controllers/ComputedTorqueFloatingBase.h"
+#include "scenario/controllers/ControllerPlugin.h"
 #include "scenario/gazebo/Log.h"
 
+#include <ignition/common/SystemPaths.hh>
+#include <ignition/plugin/Loader.hh>
 #include <sdf/Param.hh>
 
 #include <algorithm>
@@ -35,17 +39,124 @@
 #include <cassert>
 #include <istream>
 #include <locale>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 using namespace scenario::plugins::gazebo;
 
+namespace {
+    class ComputedTorqueFixedBasePlugin final
+        : public scenario::controllers::ControllerPlugin
+    {
+    public:
+        std::string name() const override
+        {
+            return "ComputedTorqueFixedBase";
+        }
+
+        std::vector<scenario::controllers::ParameterInfo>
+        parameters() const override
+        {
+            using scenario::controllers::ParameterType;
+
+            return {
+                {"kp", ParameterType::DoubleList},
+                {"kd", ParameterType::DoubleList},
+                {"urdf", ParameterType::String},
+                {"joints", ParameterType::StringList},
+                {"gravity", ParameterType::DoubleList, true, 3},
+            };
+        }
+
+        scenario::controllers::ControllerPtr
+        create(const scenario::controllers::Parameters& parameters,
+               scenario::core::ModelPtr model) const override
+        {
+            const auto& gravity = parameters.doubleLists.at("gravity");
+
+            return std::make_shared<
+                scenario::controllers::ComputedTorqueFixedBase>(
+                parameters.strings.at("urdf"),
+                model,
+                parameters.doubleLists.at("kp"),
+                parameters.doubleLists.at("kd"),
+                parameters.stringLists.at("joints"),
+                std::array<double, 3>{gravity[0], gravity[1], gravity[2]});
+        }
+    };
+
+    class ComputedTorqueFloatingBasePlugin final
+        : public scenario::controllers::ControllerPlugin
+    {
+    public:
+        std::string name() const override
+        {
+            return "ComputedTorqueFloatingBase";
+        }
+
+        std::vector<scenario::controllers::ParameterInfo>
+        parameters() const override
+        {
+            using scenario::controllers::ParameterType;
+
+            return {
+                {"kp", ParameterType::DoubleList},
+                {"kd", ParameterType::DoubleList},
+                {"urdf", ParameterType::String},
+                {"joints", ParameterType::StringList},
+                {"gravity", ParameterType::DoubleList, true, 3},
+            };
+        }
+
+        scenario::controllers::ControllerPtr
+        create(const scenario::controllers::Parameters& parameters,
+               scenario::core::ModelPtr model) const override
+        {
+            const auto& gravity = parameters.doubleLists.at("gravity");
+
+            return std::make_shared<
+                scenario::controllers::ComputedTorqueFloatingBase>(
+                parameters.strings.at("urdf"),
+                model,
+                parameters.doubleLists.at("kp"),
+                parameters.doubleLists.at("kd"),
+                parameters.stringLists.at("joints"),
+                std::array<double, 3>{gravity[0], gravity[1], gravity[2]});
+        }
+    };
+} // namespace
+
 class ControllersFactory::Impl
 {
 public:
+    // The factory is a singleton shared by all the ControllerRunner plugins
+    std::mutex mutex;
+
+    // The loader is declared before the registry, so that the plugins
+    // instantiated from the loaded libraries are destroyed first
+    ignition::plugin::Loader loader;
+    std::unordered_set<std::string> loadedLibraries;
+
+    // Registered controllers, indexed by their name
+    std::unordered_map<std::string,
+                       std::shared_ptr<controllers::ControllerPlugin>>
+        registry;
+
+    bool registerPlugin(std::shared_ptr<controllers::ControllerPlugin> plugin);
+    bool loadLibrary(const std::string& filename);
+
     static bool ContextValid(const sdf::ElementPtr context);
 
+    static bool
+    ParseParameters(const std::vector<controllers::ParameterInfo>& schema,
+                    const sdf::ElementPtr context,
+                    controllers::Parameters& parameters);
+
     template <typename T>
     static T GetElementValueAs(const std::string& elementName,
                                const sdf::ElementPtr parentContext);
@@ -61,20 +172,29 @@ public:
 
 ControllersFactory::ControllersFactory()
     : pImpl{std::make_unique<Impl>()}
-{}
+{
+    // Register the controllers shipped with this project
+    pImpl->registerPlugin(std::make_shared<ComputedTorqueFixedBasePlugin>());
+    pImpl->registerPlugin(
+        std::make_shared<ComputedTorqueFloatingBasePlugin>());
+}
 
 ControllersFactory::~ControllersFactory() = default;
 
 scenario::plugins::gazebo::ControllersFactory& ControllersFactory::Instance()
 {
-    static ControllersFactory instance;
-    return instance;
+    // The singleton is intentionally leaked. Controllers created by the
+    // factory could still be alive during static destruction (e.g. owned by
+    // a server destroyed at exit), and their code must not be unloaded
+    // before them.
+    static auto* instance = new ControllersFactory();
+    return *instance;
 }
 
 scenario::controllers::ControllerPtr
 ControllersFactory::get(const sdf::ElementPtr context, core::ModelPtr model)
 {
-    if (!Impl::ContextValid(context)) {
+    if (!(context && Impl::ContextValid(context))) {
         sError << "Controller context not valid" << std::endl;
         return nullptr;
     }
@@ -83,60 +203,135 @@ ControllersFactory::get(const sdf::ElementPtr context, core::ModelPtr model)
     context->GetAttribute("name")->Get<std::string>(controllerName);
     sDebug << "Found context for " << controllerName << std::endl;
 
-    if (controllerName == "ComputedTorqueFixedBase") {
+    std::shared_ptr<controllers::ControllerPlugin> plugin;
 
-        bool ok = true;
-        ok = ok && context->HasElement("kp");
-        ok = ok && context->HasElement("kd");
-        ok = ok && context->HasElement("urdf");
-        ok = ok && context->HasElement("joints");
-        ok = ok && context->HasElement("gravity");
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
 
-        if (!ok) {
-            sError << "Controller context has missing elements" << std::endl;
-            return nullptr;
+        // Controllers not shipped with this project are loaded from the
+        // library passed in the context
+        if (context->HasAttribute("filename")) {
+            std::string filename;
+            context->GetAttribute("filename")->Get<std::string>(filename);
+
+            if (!pImpl->loadLibrary(filename)) {
+                sError << "Failed to load controllers from library '"
+                       << filename << "'" << std::endl;
+                return nullptr;
+            }
         }
 
-        auto urdf = Impl::GetElementValueAs<std::string>("urdf", context);
-        auto kp = Impl::GetElementValueAs<std::vector<double>>("kp", context);
-        auto kd = Impl::GetElementValueAs<std::vector<double>>("kd", context);
-        auto gravity = Impl::GetElementValueAs< //
-            std::vector<double>>("gravity", context);
-        auto joints = Impl::GetElementValueAs< //
-            std::vector<std::string>>("joints", context);
+        auto it = pImpl->registry.find(controllerName);
 
-        if (gravity.size() != 3) {
-            sError << "Parsed gravity does not have three elements";
+        if (it == pImpl->registry.end()) {
+            sError << "Controller '" << controllerName
+                   << "' is not registered in the factory" << std::endl;
             return nullptr;
         }
 
-        auto controller =
-            std::make_shared<controllers::ComputedTorqueFixedBase>(
-                urdf,
-                model,
-                kp,
-                kd,
-                joints,
-                std::array<double, 3>{gravity[0], gravity[1], gravity[2]});
+        plugin = it->second;
+    }
+
+    controllers::Parameters parameters;
+
+    if (!Impl::ParseParameters(plugin->parameters(), context, parameters)) {
+        sError << "Failed to parse the parameters of controller '"
+               << controllerName << "'" << std::endl;
+        return nullptr;
+    }
+
+    auto controller = plugin->create(parameters, model);
 
-        return controller;
+    if (!controller) {
+        sError << "Failed to create controller '" << controllerName << "'"
+               << std::endl;
+        return nullptr;
     }
 
-    return nullptr;
+    return controller;
 }
 
-bool ControllersFactory::Impl::ContextValid(const sdf::ElementPtr context)
+bool ControllersFactory::Impl::registerPlugin(
+    std::shared_ptr<controllers::ControllerPlugin> plugin)
 {
-    // Check that the context is a <controller> element
-    if (context->GetName() != "controller") {
-        sError << "The first element of the context must be <controller>"
+    const std::string name = plugin->name();
+
+    if (registry.find(name) != registry.end()) {
+        sWarning << "Controller '" << name
+                 << "' already registered, ignoring the new plugin"
+                 << std::endl;
+        return false;
+    }
+
+    sDebug << "Registering controller '" << name << "'" << std::endl;
+    registry[name] = std::move(plugin);
+    return true;
+}
+
+bool ControllersFactory::Impl::loadLibrary(const std::string& filename)
+{
+    if (loadedLibraries.find(filename) != loadedLibraries.end()) {
+        return true;
+    }
+
+    // The libraries are searched in the same folders of the system plugins
+    ignition::common::SystemPaths systemPaths;
+    systemPaths.SetPluginPathEnv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH");
+
+    const std::string pathToLib = systemPaths.FindSharedLibrary(filename);
+
+    if (pathToLib.empty()) {
+        sError << "Failed to find library '" << filename
+               << "'. Have you checked the IGN_GAZEBO_SYSTEM_PLUGIN_PATH "
+               << "environment variable?" << std::endl;
+        return false;
+    }
+
+    const auto pluginNames = loader.LoadLib(pathToLib);
+
+    if (pluginNames.empty()) {
+        sError << "No plugins found in library '" << pathToLib << "'"
                << std::endl;
         return false;
     }
 
-    // Check that there is only one <controller> element
-    if (context->GetNextElement("controller")) {
-        sError << "Found multiple <controller> elements in controller context"
+    size_t nrOfControllers = 0;
+
+    for (const auto& pluginName : pluginNames) {
+        auto plugin = loader.Instantiate(pluginName);
+
+        if (!plugin) {
+            continue;
+        }
+
+        // The shared pointer keeps the plugin instance alive
+        auto controllerPlugin = plugin->QueryInterfaceSharedPtr< //
+            controllers::ControllerPlugin>();
+
+        if (!controllerPlugin) {
+            continue;
+        }
+
+        if (this->registerPlugin(controllerPlugin)) {
+            nrOfControllers++;
+        }
+    }
+
+    if (nrOfControllers == 0) {
+        sError << "No controllers registered from library '" << pathToLib
+               << "'" << std::endl;
+        return false;
+    }
+
+    loadedLibraries.insert(filename);
+    return true;
+}
+
+bool ControllersFactory::Impl::ContextValid(const sdf::ElementPtr context)
+{
+    // Check that the context is a <controller> element
+    if (context->GetName() != "controller") {
+        sError << "The first element of the context must be <controller>"
                << std::endl;
         return false;
     }
@@ -151,6 +346,72 @@ bool ControllersFactory::Impl::ContextValid(const sdf::ElementPtr context)
     return true;
 }
 
+bool ControllersFactory::Impl::ParseParameters(
+    const std::vector<controllers::ParameterInfo>& schema,
+    const sdf::ElementPtr context,
+    controllers::Parameters& parameters)
+{
+    using controllers::ParameterType;
+
+    for (const auto& info : schema) {
+        if (!context->HasElement(info.name)) {
+            if (info.required) {
+                sError << "Controller context has missing element <"
+                       << info.name << ">" << std::endl;
+                return false;
+            }
+
+            continue;
+        }
+
+        // Number of elements of the parsed value, used to validate the size
+        size_t size = 1;
+
+        switch (info.type) {
+            case ParameterType::String:
+                parameters.strings[info.name] =
+                    GetElementValueAs<std::string>(info.name, context);
+                break;
+            case ParameterType::StringList: {
+                auto& value = parameters.stringLists[info.name];
+                value = GetElementValueAs<std::vector<std::string>>(info.name,
+                                                                    context);
+                size = value.size();
+                break;
+            }
+            case ParameterType::Double: {
+                const auto value =
+                    GetElementValueAs<std::vector<double>>(info.name, context);
+
+                if (value.size() != 1) {
+                    sError << "Element <" << info.name
+                           << "> does not contain a single number"
+                           << std::endl;
+                    return false;
+                }
+
+                parameters.doubles[info.name] = value[0];
+                break;
+            }
+            case ParameterType::DoubleList: {
+                auto& value = parameters.doubleLists[info.name];
+                value = GetElementValueAs<std::vector<double>>(info.name,
+                                                               context);
+                size = value.size();
+                break;
+            }
+        }
+
+        if (info.size > 0 && size != info.size) {
+            sError << "Parsed element <" << info.name << "> has " << size
+                   << " elements instead of " << info.size << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
 template <typename T>
 T ControllersFactory::Impl::GetElementValueAs(
     const std::string& elementName,
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scenario/controllers/Controller.h"
+#include "scenario/controllers/ControllerPlugin.h"
+#include "scenario/core/Joint.h"
+#include "scenario/core/Model.h"
+
+#include <ignition/plugin/Register.hh>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Controllers used to test the plugins loaded by the ControllersFactory and
+// the schedule of the ControllerRunner.
+
+namespace scenario::controllers::test {
+    class ConstantForceController;
+    class ConstantForceControllerPlugin;
+    class PeriodProbeController;
+    class PeriodProbeControllerPlugin;
+    class ReferencesProbeController;
+    class ReferencesProbeControllerPlugin;
+} // namespace scenario::controllers::test
+
+// Applies a constant generalized force to the selected joints
+
+class scenario::controllers::test::ConstantForceController final
+    : public scenario::controllers::Controller
+{
+public:
+    ConstantForceController(core::ModelPtr model,
+                            const std::vector<std::string>& jointNames,
+                            const double force)
+        : m_model(std::move(model))
+        , m_jointNames(jointNames)
+        , m_force(force)
+    {}
+
+    bool initialize() override
+    {
+        for (const auto& jointName : m_jointNames) {
+            auto joint = m_model->getJoint(jointName);
+
+            if (!joint->setControlMode(core::JointControlMode::Force)) {
+                return false;
+            }
+
+            m_joints.push_back(joint);
+        }
+
+        return true;
+    }
+
+    bool step(const StepSize& /*dt*/) override
+    {
+        bool ok = true;
+
+        for (const auto& joint : m_joints) {
+            ok = joint->setGeneralizedForceTarget(m_force) && ok;
+        }
+
+        return ok;
+    }
+
+    bool terminate() override { return true; }
+
+private:
+    core::ModelPtr m_model;
+    std::vector<std::string> m_jointNames;
+    std::vector<core::JointPtr> m_joints;
+    double m_force = 0.0;
+};
+
+class scenario::controllers::test::ConstantForceControllerPlugin final
+    : public scenario::controllers::ControllerPlugin
+{
+public:
+    std::string name() const override { return "ConstantForceController"; }
+
+    std::vector<ParameterInfo> parameters() const override
+    {
+        return {
+            {"joints", ParameterType::StringList},
+            {"force", ParameterType::Double},
+        };
+    }
+
+    ControllerPtr create(const Parameters& parameters,
+                         core::ModelPtr model) const override
+    {
+        return std::make_shared<ConstantForceController>(
+            model,
+            parameters.stringLists.at("joints"),
+            parameters.doubles.at("force"));
+    }
+};
+
+// Applies to the selected joint a generalized force equal to the time
+// elapsed between the last two updates of its state, that are performed
+// with the period resolved by the scheduler
+class scenario::controllers::test::PeriodProbeController final
+    : public scenario::controllers::Controller
+    , public scenario::controllers::UseScenarioModel
+{
+public:
+    PeriodProbeController(core::ModelPtr model, const std::string& jointName)
+        : m_jointName(jointName)
+    {
+        m_model = std::move(model);
+    }
+
+    bool initialize() override
+    {
+        m_joint = m_model->getJoint(m_jointName);
+        return m_joint->setControlMode(core::JointControlMode::Force);
+    }
+
+    bool step(const StepSize& dt) override
+    {
+        m_elapsed += dt.count();
+        return m_joint->setGeneralizedForceTarget(m_lastPeriod);
+    }
+
+    bool terminate() override { return true; }
+
+    bool updateStateFromModel() override
+    {
+        m_lastPeriod = m_elapsed;
+        m_elapsed = 0.0;
+        return true;
+    }
+
+private:
+    std::string m_jointName;
+    core::JointPtr m_joint;
+    double m_elapsed = 0.0;
+    double m_lastPeriod = 0.0;
+};
+
+class scenario::controllers::test::PeriodProbeControllerPlugin final
+    : public scenario::controllers::ControllerPlugin
+{
+public:
+    std::string name() const override { return "PeriodProbeController"; }
+
+    std::vector<ParameterInfo> parameters() const override
+    {
+        return {
+            {"joint", ParameterType::String},
+        };
+    }
+
+    ControllerPtr create(const Parameters& parameters,
+                         core::ModelPtr model) const override
+    {
+        return std::make_shared<PeriodProbeController>(
+            model, parameters.strings.at("joint"));
+    }
+};
+
+// Controls a joint without actuating it. The number of times its references
+// have been read and the number of its steps are applied as generalized
+// forces to two other joints.
+class scenario::controllers::test::ReferencesProbeController final
+    : public scenario::controllers::Controller
+    , public scenario::controllers::SetJointReferences
+{
+public:
+    ReferencesProbeController(core::ModelPtr model,
+                              const std::string& jointName,
+                              const std::string& readsJointName,
+                              const std::string& stepsJointName)
+        : m_model(std::move(model))
+        , m_readsJointName(readsJointName)
+        , m_stepsJointName(stepsJointName)
+    {
+        m_controlledJoints = {jointName};
+    }
+
+    bool initialize() override
+    {
+        m_readsJoint = m_model->getJoint(m_readsJointName);
+        m_stepsJoint = m_model->getJoint(m_stepsJointName);
+
+        return m_readsJoint->setControlMode(core::JointControlMode::Force)
+               && m_stepsJoint->setControlMode(core::JointControlMode::Force);
+    }
+
+    bool step(const StepSize& /*dt*/) override
+    {
+        m_steps++;
+
+        return m_readsJoint->setGeneralizedForceTarget(m_reads)
+               && m_stepsJoint->setGeneralizedForceTarget(m_steps);
+    }
+
+    bool terminate() override { return true; }
+
+    const std::vector<std::string>& controlledJoints() override
+    {
+        return m_controlledJoints;
+    }
+
+    bool setJointReferences(const JointReferences& /*references*/) override
+    {
+        m_reads++;
+        return true;
+    }
+
+private:
+    core::ModelPtr m_model;
+    std::string m_readsJointName;
+    std::string m_stepsJointName;
+    core::JointPtr m_readsJoint;
+    core::JointPtr m_stepsJoint;
+    double m_reads = 0.0;
+    double m_steps = 0.0;
+};
+
+class scenario::controllers::test::ReferencesProbeControllerPlugin final
+    : public scenario::controllers::ControllerPlugin
+{
+public:
+    std::string name() const override { return "ReferencesProbeController"; }
+
+    std::vector<ParameterInfo> parameters() const override
+    {
+        return {
+            {"joint", ParameterType::String},
+            {"reads_joint", ParameterType::String},
+            {"steps_joint", ParameterType::String},
+        };
+    }
+
+    ControllerPtr create(const Parameters& parameters,
+                         core::ModelPtr model) const override
+    {
+        return std::make_shared<ReferencesProbeController>(
+            model,
+            parameters.strings.at("joint"),
+            parameters.strings.at("reads_joint"),
+            parameters.strings.at("steps_joint"));
+    }
+};
+
+IGNITION_ADD_PLUGIN(
+    scenario::controllers::test::ConstantForceControllerPlugin,
+    scenario::controllers::ControllerPlugin)
+
+IGNITION_ADD_PLUGIN(
+    scenario::controllers::test::PeriodProbeControllerPlugin,
+    scenario::controllers::ControllerPlugin)
+
+IGNITION_ADD_PLUGIN(
+    scenario::controllers::test::ReferencesProbeControllerPlugin,
+    scenario::controllers::ControllerPlugin)
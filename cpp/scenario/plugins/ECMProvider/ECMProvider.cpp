@@ -34,12 +34,15 @@
 #include <ignition/gazebo/components/World.hh>
 #include <ignition/plugin/Register.hh>
 
+#include <string>
+
 using namespace scenario::gazebo;
 using namespace scenario::plugins::gazebo;
 
 class ECMProvider::Impl
 {
 public:
+    std::string worldName;
 };
 
 ECMProvider::ECMProvider()
@@ -49,7 +52,12 @@ ECMProvider::ECMProvider()
 
 ECMProvider::~ECMProvider()
 {
-    ECMSingleton::Instance().clean();
+    // Other simulators could have stored their worlds in the singleton
+    if (!pImpl->worldName.empty()
+        && ECMSingleton::Instance().hasWorld(pImpl->worldName)) {
+        ECMSingleton::Instance().clean(pImpl->worldName);
+    }
+
     sDebug << "Destroying the ECMProvider" << std::endl;
 };
 
@@ -80,6 +88,8 @@ void ECMProvider::Configure(const ignition::gazebo::Entity& entity,
         return;
     }
 
+    pImpl->worldName = worldName;
+
     sDebug << "World '" << worldName
            << "' successfully processed by ECMProvider" << std::endl;
 }
@@ -121,11 +121,9 @@ void JointController::PreUpdate(const ignition::gazebo::UpdateInfo& info,
         return;
     }
 
-    // This plugin keep being called also after the model was removed
-    try {
-        pImpl->model->controllerPeriod();
-    }
-    catch (exceptions::ComponentNotFound) {
+    // This plugin keeps being called also after the model was removed
+    if (utils::isModelRemoved(&ecm, pImpl->modelEntity)) {
+        pImpl->model = nullptr;
         return;
     }
 
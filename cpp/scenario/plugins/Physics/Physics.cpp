@@ -16,8 +16,14 @@
  */
 
 #include "Physics.h"
+#include "scenario/core/utils/ThreadPool.h"
 #include "scenario/gazebo/components/ExternalWorldWrenchCmdWithDuration.h"
 #include "scenario/gazebo/components/HistoryOfAppliedJointForces.h"
+#include "scenario/gazebo/components/ModelAccumulators.h"
+#include "scenario/gazebo/components/ModelCollisionBitmask.h"
+#include "scenario/gazebo/components/PhysicsSubSteps.h"
+#include "scenario/gazebo/components/PhysicsThreads.h"
+#include "scenario/gazebo/components/RequiresEveryPhysicsStep.h"
 #include "scenario/gazebo/components/SimulatedTime.h"
 #include "scenario/gazebo/components/WorldVelocityCmd.h"
 #include "scenario/gazebo/helpers.h"
@@ -102,11 +108,19 @@
 #include <sdf/Link.hh>
 #include <sdf/Mesh.hh>
 #include <sdf/Model.hh>
+#include <sdf/Surface.hh>
 #include <sdf/World.hh>
 
-#include <deque>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace ignition;
 using namespace scenario::plugins::gazebo;
@@ -178,6 +192,17 @@ public:
     /// \param[in] _dt Duration
     void Step(const std::chrono::steady_clock::duration& _dt);
 
+    /// \brief Get the number of physics steps of the next update
+    /// \param[in] _ecm Constant reference to ECM.
+    /// \returns The number of sub-steps, or 1 if any entity requires the
+    /// state of every physics step
+    size_t SubSteps(const EntityComponentManager& _ecm) const;
+
+    /// \brief Apply again the joint and link commands before a sub-step,
+    /// since the engine clears them after every step
+    /// \param[in] _ecm Constant reference to ECM.
+    void ApplyCommands(const EntityComponentManager& _ecm);
+
     /// \brief Update components from physics simulation
     /// \param[in] _ecm Mutable reference to ECM.
     void UpdateSim(const ignition::gazebo::UpdateInfo& _info,
@@ -187,6 +212,19 @@ public:
     /// \param[in] _ecm Mutable reference to ECM.
     void UpdateCollisions(EntityComponentManager& _ecm);
 
+    /// \brief Get the thread pool used to process the model partitions,
+    /// resized if the number of threads of the world changed
+    /// \param[in] _ecm Constant reference to ECM.
+    /// \returns The thread pool.
+    scenario::core::utils::ThreadPool&
+    ThreadPool(const EntityComponentManager& _ecm);
+
+    /// \brief Update the accumulators of the models that enabled them
+    /// \param[in] _info Update information.
+    /// \param[in] _ecm Mutable reference to ECM.
+    void UpdateAccumulators(const ignition::gazebo::UpdateInfo& _info,
+                            EntityComponentManager& _ecm);
+
     /// \brief FrameData relative to world at a given offset pose
     /// \param[in] _link ign-physics link
     /// \param[in] _pose Offset pose in which to compute the frame data
@@ -215,6 +253,18 @@ public:
     /// has drained.
     std::unordered_map<Entity, bool> entityOffMap;
 
+    /// \brief Children of a model read by the accumulators.
+    struct AccumulatedEntities
+    {
+        std::vector<Entity> joints;
+        std::vector<Entity> links;
+        std::vector<Entity> collisions;
+    };
+
+    /// \brief A map between the models with accumulators and their children.
+    /// It is rebuilt only when entities are created or removed.
+    std::unordered_map<Entity, AccumulatedEntities> accumulatedEntitiesMap;
+
     /// \brief used to store whether physics objects have been created.
     bool initialized = false;
 
@@ -350,6 +400,25 @@ public:
     /// in the ECM. This is the reverse map of entityCollisionMap.
     std::unordered_map<ShapePtrType, Entity> collisionEntityMap;
 
+    /// \brief A map between collision entity ids in the ECM and their name,
+    /// cached to fill the contact wrenches without querying the ECM.
+    std::unordered_map<Entity, std::string> collisionNameMap;
+
+    /// \brief Contact between a pair of collisions, as seen from the first.
+    struct ContactRecord
+    {
+        Entity collision1;
+        Entity collision2;
+        size_t index;
+        const WorldShapeType::ContactPoint* point;
+        const WorldShapeType::ExtraContactData* extra;
+        bool flipped;
+    };
+
+    /// \brief The contacts of the last step sorted by pair of collisions.
+    /// The vector is cleared at every step, keeping its memory.
+    std::vector<ContactRecord> contactRecords;
+
     /// \brief A map between link entity ids in the ECM to Link Entities in
     /// ign-physics, with attach feature.
     /// All links on this map are also in `entityLinkMap`. The difference is
@@ -443,6 +512,58 @@ public:
     /// \brief Boolean value that is true only the first call of Configure and
     /// PreUpdate.
     bool firstRun = true;
+
+    /// \brief Link whose state has to be read from the engine.
+    struct LinkUpdate
+    {
+        Entity entity;
+        Entity model;
+        LinkPtrType link;
+        components::Pose* pose;
+        bool canonical;
+    };
+
+    /// \brief Change of a component, whose bookkeeping in the ECM is not
+    /// thread safe.
+    struct ChangedComponent
+    {
+        Entity entity;
+        ComponentTypeId typeId;
+        ComponentState state;
+    };
+
+    /// \brief Entities of a model, processed by a single thread. The engine
+    /// can be queried concurrently only for different models.
+    struct ModelPartition
+    {
+        std::vector<LinkUpdate> links;
+        std::vector<std::pair<const JointPtrType*, components::JointPosition*>>
+            jointPositions;
+        std::vector<std::pair<const JointPtrType*, components::JointVelocity*>>
+            jointVelocities;
+        std::vector<ChangedComponent> changes;
+    };
+
+    /// \brief Update the components of a link from the engine
+    /// \param[in] _link The link to update.
+    /// \param[in] _ecm Mutable reference to ECM.
+    /// \param[out] _changes The changed components of the link.
+    void UpdateLink(const LinkUpdate& _link,
+                    EntityComponentManager& _ecm,
+                    std::vector<ChangedComponent>& _changes) const;
+
+    /// \brief The partitions of the last update. They are kept across
+    /// updates to reuse their memory.
+    std::vector<ModelPartition> partitions;
+
+    /// \brief Map between model entities and their partition.
+    std::unordered_map<Entity, size_t> modelPartitionMap;
+
+    /// \brief Thread pool used to process the partitions.
+    std::unique_ptr<scenario::core::utils::ThreadPool> threadPool;
+
+    /// \brief The number of threads requested for the thread pool.
+    size_t threadPoolSize = 1;
 };
 
 Physics::Physics()
@@ -585,10 +706,24 @@ void Physics::Update(const UpdateInfo& _info, EntityComponentManager& _ecm)
 
         // Only step if not paused.
         if (!_info.paused) {
-            this->pImpl->Step(_info.dt);
+            const size_t subSteps = this->pImpl->SubSteps(_ecm);
+
+            // Split the update in sub-steps keeping the commands constant.
+            // The last sub-step absorbs the remainder of the division.
+            const auto subStepDt =
+                _info.dt
+                / static_cast<std::chrono::steady_clock::rep>(subSteps);
+
+            for (size_t i = 1; i < subSteps; ++i) {
+                this->pImpl->Step(subStepDt);
+                this->pImpl->ApplyCommands(_ecm);
+            }
+
+            this->pImpl->Step(_info.dt - subStepDt * (subSteps - 1));
         }
 
         this->pImpl->UpdateSim(_info, _ecm);
+        this->pImpl->UpdateAccumulators(_info, _ecm);
 
         // Entities scheduled to be removed should be removed from physics
         // after the simulation step. Otherwise, since the to-be-removed
@@ -740,6 +875,23 @@ void Physics::Impl::CreatePhysicsEntities(const EntityComponentManager& _ecm)
         collision.SetRawPose(_pose->Data());
         collision.SetPoseRelativeTo("");
 
+        // Apply the collision bitmask of the parent model, if any. It is
+        // honored by the engine when generating the collision pairs.
+        const components::ModelCollisionBitmask* bitmaskComp = nullptr;
+
+        if (const auto* linkParentComp =
+                _ecm.Component<components::ParentEntity>(_parent->Data())) {
+            bitmaskComp = _ecm.Component<components::ModelCollisionBitmask>(
+                linkParentComp->Data());
+        }
+
+        if (bitmaskComp) {
+            sdf::Surface surface =
+                collision.Surface() ? *collision.Surface() : sdf::Surface();
+            surface.Contact()->SetCollideBitmask(bitmaskComp->Data());
+            collision.SetSurface(surface);
+        }
+
         ShapePtrType collisionPtrPhys;
         if (_geom->Data().Type() == sdf::GeometryType::MESH) {
             const sdf::Mesh* meshSdf = _geom->Data().MeshShape();
@@ -803,6 +955,7 @@ void Physics::Impl::CreatePhysicsEntities(const EntityComponentManager& _ecm)
             std::make_pair(_entity, collisionPtrPhys));
         this->collisionEntityMap.insert(
             std::make_pair(collisionPtrPhys, _entity));
+        this->collisionNameMap.insert(std::make_pair(_entity, _name->Data()));
         return true;
     };
 
@@ -1058,6 +1211,8 @@ void Physics::Impl::RemovePhysicsEntities(const EntityComponentManager& _ecm)
     _ecm.EachRemoved<components::Model>([&](const Entity& _entity,
                                             const components::Model *
                                             /* _model */) -> bool {
+        this->accumulatedEntitiesMap.erase(_entity);
+
         // Remove model if found
         auto modelIt = this->entityModelMap.find(_entity);
         if (modelIt != this->entityModelMap.end()) {
@@ -1070,6 +1225,7 @@ void Physics::Impl::RemovePhysicsEntities(const EntityComponentManager& _ecm)
                     if (collIt != this->entityCollisionMap.end()) {
                         this->collisionEntityMap.erase(collIt->second);
                         this->entityCollisionMap.erase(collIt);
+                        this->collisionNameMap.erase(childCollision);
                     }
                 }
                 // First erase the entry associated with this link from the
@@ -1526,10 +1682,125 @@ void Physics::Impl::Step(const std::chrono::steady_clock::duration& _dt)
     }
 }
 
+size_t Physics::Impl::SubSteps(const EntityComponentManager& _ecm) const
+{
+    bool requiresEveryStep = false;
+
+    _ecm.Each<components::RequiresEveryPhysicsStep>(
+        [&](const Entity&, const components::RequiresEveryPhysicsStep*) {
+            requiresEveryStep = true;
+            return false;
+        });
+
+    if (requiresEveryStep) {
+        return 1;
+    }
+
+    size_t subSteps = 1;
+
+    _ecm.Each<components::World, components::PhysicsSubSteps>(
+        [&](const Entity&,
+            const components::World*,
+            const components::PhysicsSubSteps* _subSteps) {
+            subSteps = std::max(subSteps, _subSteps->Data());
+            return true;
+        });
+
+    return subSteps;
+}
+
+void Physics::Impl::ApplyCommands(const EntityComponentManager& _ecm)
+{
+    // The commands were already validated by UpdatePhysics
+    _ecm.Each<components::JointForceCmd>(
+        [&](const Entity& _entity, const components::JointForceCmd* _force) {
+            auto jointIt = this->entityJointMap.find(_entity);
+            if (jointIt == this->entityJointMap.end())
+                return true;
+
+            auto offIt = this->entityOffMap.find(_ecm.ParentEntity(_entity));
+            if (offIt != this->entityOffMap.end() && offIt->second)
+                return true;
+
+            std::size_t nDofs = std::min(
+                _force->Data().size(), jointIt->second->GetDegreesOfFreedom());
+            for (std::size_t i = 0; i < nDofs; ++i) {
+                jointIt->second->SetForce(i, _force->Data()[i]);
+            }
+            return true;
+        });
+
+    _ecm.Each<components::JointVelocityCmd>(
+        [&](const Entity& _entity,
+            const components::JointVelocityCmd* _velocityCmd) {
+            // Force commands have precedence over velocity commands
+            if (_ecm.Component<components::JointForceCmd>(_entity))
+                return true;
+
+            auto velocityIt = this->entityJointVelocityCommandMap.find(_entity);
+            if (velocityIt == this->entityJointVelocityCommandMap.end()
+                || !velocityIt->second)
+                return true;
+
+            for (std::size_t i = 0; i < _velocityCmd->Data().size(); ++i) {
+                velocityIt->second->SetVelocityCommand(
+                    i, _velocityCmd->Data()[i]);
+            }
+            return true;
+        });
+
+    auto addWrench = [&](const Entity& _entity, const msgs::Wrench& _wrench) {
+        auto linkForceIt = this->entityLinkForceMap.find(_entity);
+        if (linkForceIt == this->entityLinkForceMap.end()
+            || !linkForceIt->second)
+            return;
+
+        linkForceIt->second->AddExternalForce(
+            math::eigen3::convert(msgs::Convert(_wrench.force())));
+        linkForceIt->second->AddExternalTorque(
+            math::eigen3::convert(msgs::Convert(_wrench.torque())));
+    };
+
+    _ecm.Each<components::ExternalWorldWrenchCmd>(
+        [&](const Entity& _entity,
+            const components::ExternalWorldWrenchCmd* _wrenchComp) {
+            addWrench(_entity, _wrenchComp->Data());
+            return true;
+        });
+
+    _ecm.Each<components::ExternalWorldWrenchCmdWithDuration>(
+        [&](const Entity& _entity,
+            const components::ExternalWorldWrenchCmdWithDuration*
+                _wrenchWithDurComp) {
+            addWrench(_entity, _wrenchWithDurComp->Data().totalWrench());
+            return true;
+        });
+}
+
 void Physics::Impl::UpdateSim(const ignition::gazebo::UpdateInfo& _info,
                               EntityComponentManager& _ecm)
 {
-    // local pose
+    // Collect the links and the joints, partitioned by model
+    for (auto& partition : this->partitions) {
+        partition.links.clear();
+        partition.jointPositions.clear();
+        partition.jointVelocities.clear();
+        partition.changes.clear();
+    }
+
+    this->modelPartitionMap.clear();
+
+    auto partitionOf = [&](const Entity _model) -> ModelPartition& {
+        auto [it, inserted] = this->modelPartitionMap.insert(
+            {_model, this->modelPartitionMap.size()});
+
+        if (inserted && this->partitions.size() < it->second + 1) {
+            this->partitions.emplace_back();
+        }
+
+        return this->partitions[it->second];
+    };
+
     _ecm.Each<components::Link,
               components::Pose,
               components::ParentEntity>([&](const Entity& _entity,
@@ -1545,188 +1816,86 @@ void Physics::Impl::UpdateSim(const ignition::gazebo::UpdateInfo& _info,
             return true;
 
         auto linkIt = this->entityLinkMap.find(_entity);
-        if (linkIt != this->entityLinkMap.end()) {
-            auto canonicalLink =
-                _ecm.Component<components::CanonicalLink>(_entity);
-
-            // get the pose component of the parent model
-            const components::Pose* parentPose =
-                _ecm.Component<components::Pose>(_parent->Data());
-
-            auto frameData = linkIt->second->FrameDataRelativeToWorld();
-            const auto& worldPose = frameData.pose;
-
-            // if the parentPose is a nullptr, something is wrong with ECS
-            // creation
-            if (!parentPose) {
-                ignerr << "The pose component of " << _parent->Data()
-                       << " could not be found. This should never happen!\n";
-                return true;
-            }
-            if (canonicalLink) {
-                // This is the canonical link, update the model
-                // The Pose component, _pose, of this link is the initial
-                // transform of the link w.r.t its model. This component
-                // never changes because it's "fixed" to the model. Instead,
-                // we change the model's pose here. The physics engine gives
-                // us the pose of this link relative to world so to set the
-                // model's pose, we have to post-multiply it by the inverse
-                // of the initial transform of the link w.r.t to its model.
-                auto mutableParentPose =
-                    _ecm.Component<components::Pose>(_parent->Data());
-                *(mutableParentPose) = components::Pose(
-                    _pose->Data().Inverse() + math::eigen3::convert(worldPose));
-                _ecm.SetChanged(_parent->Data(),
-                                components::Pose::typeId,
-                                ComponentState::PeriodicChange);
-            }
-            else {
-                // Compute the relative pose of this link from the model
-                *_pose = components::Pose(math::eigen3::convert(worldPose)
-                                          + parentPose->Data().Inverse());
-                _ecm.SetChanged(_entity,
-                                components::Pose::typeId,
-                                ComponentState::PeriodicChange);
-            }
+        if (linkIt == this->entityLinkMap.end()) {
+            ignwarn << "Unknown link with id " << _entity << " found\n";
+            return true;
+        }
 
-            // Populate world poses, velocities and accelerations of the
-            // link. For now these components are updated only if another
-            // system has created the corresponding component on the entity.
-            auto worldPoseComp = _ecm.Component<components::WorldPose>(_entity);
-            if (worldPoseComp) {
-                auto state =
-                    worldPoseComp->SetData(
-                        math::eigen3::convert(frameData.pose), this->pose3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(_entity, components::WorldPose::typeId, state);
-            }
+        const bool canonical =
+            _ecm.Component<components::CanonicalLink>(_entity) != nullptr;
 
-            // Velocity in world coordinates
-            auto worldLinVelComp =
-                _ecm.Component<components::WorldLinearVelocity>(_entity);
-            if (worldLinVelComp) {
-                auto state =
-                    worldLinVelComp->SetData(
-                        math::eigen3::convert(frameData.linearVelocity),
-                        this->vec3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(
-                    _entity, components::WorldLinearVelocity::typeId, state);
-            }
+        auto& links = partitionOf(_parent->Data()).links;
+        links.push_back(
+            {_entity, _parent->Data(), linkIt->second, _pose, canonical});
 
-            // Angular velocity in world frame coordinates
-            auto worldAngVelComp =
-                _ecm.Component<components::WorldAngularVelocity>(_entity);
-            if (worldAngVelComp) {
-                auto state =
-                    worldAngVelComp->SetData(
-                        math::eigen3::convert(frameData.angularVelocity),
-                        this->vec3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(
-                    _entity, components::WorldAngularVelocity::typeId, state);
-            }
+        // The canonical link is processed first since it updates the model
+        // pose used by the other links
+        if (canonical) {
+            std::swap(links.front(), links.back());
+        }
 
-            // Acceleration in world frame coordinates
-            auto worldLinAccelComp =
-                _ecm.Component<components::WorldLinearAcceleration>(_entity);
-            if (worldLinAccelComp) {
-                auto state =
-                    worldLinAccelComp->SetData(
-                        math::eigen3::convert(frameData.linearAcceleration),
-                        this->vec3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(_entity,
-                                components::WorldLinearAcceleration::typeId,
-                                state);
-            }
+        return true;
+    });
 
-            // Angular acceleration in world frame coordinates
-            auto worldAngAccelComp =
-                _ecm.Component<components::WorldAngularAcceleration>(_entity);
-
-            if (worldAngAccelComp) {
-                auto state =
-                    worldAngAccelComp->SetData(
-                        math::eigen3::convert(frameData.angularAcceleration),
-                        this->vec3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(_entity,
-                                components::WorldAngularAcceleration::typeId,
-                                state);
+    _ecm.Each<components::Joint, components::JointPosition>(
+        [&](const Entity& _entity,
+            components::Joint*,
+            components::JointPosition* _jointPos) -> bool {
+            auto jointIt = this->entityJointMap.find(_entity);
+            if (jointIt != this->entityJointMap.end()) {
+                partitionOf(_ecm.ParentEntity(_entity))
+                    .jointPositions.push_back({&jointIt->second, _jointPos});
             }
+            return true;
+        });
 
-            const Eigen::Matrix3d R_bs =
-                worldPose.linear().transpose(); // NOLINT
-
-            // Velocity in body-fixed frame coordinates
-            auto bodyLinVelComp =
-                _ecm.Component<components::LinearVelocity>(_entity);
-            if (bodyLinVelComp) {
-                Eigen::Vector3d bodyLinVel = R_bs * frameData.linearVelocity;
-                auto state =
-                    bodyLinVelComp->SetData(math::eigen3::convert(bodyLinVel),
-                                            this->vec3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(
-                    _entity, components::LinearVelocity::typeId, state);
+    _ecm.Each<components::Joint, components::JointVelocity>(
+        [&](const Entity& _entity,
+            components::Joint*,
+            components::JointVelocity* _jointVel) -> bool {
+            auto jointIt = this->entityJointMap.find(_entity);
+            if (jointIt != this->entityJointMap.end()) {
+                partitionOf(_ecm.ParentEntity(_entity))
+                    .jointVelocities.push_back({&jointIt->second, _jointVel});
             }
+            return true;
+        });
 
-            // Angular velocity in body-fixed frame coordinates
-            auto bodyAngVelComp =
-                _ecm.Component<components::AngularVelocity>(_entity);
-            if (bodyAngVelComp) {
-                Eigen::Vector3d bodyAngVel = R_bs * frameData.angularVelocity;
-                auto state =
-                    bodyAngVelComp->SetData(math::eigen3::convert(bodyAngVel),
-                                            this->vec3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(
-                    _entity, components::AngularVelocity::typeId, state);
+    // Read the state of the models from the engine and update their
+    // components in parallel
+    this->ThreadPool(_ecm).parallelFor(
+        this->modelPartitionMap.size(), [&](const size_t _index) {
+            auto& partition = this->partitions[_index];
+
+            for (const auto& link : partition.links) {
+                this->UpdateLink(link, _ecm, partition.changes);
             }
 
-            // Acceleration in body-fixed frame coordinates
-            auto bodyLinAccelComp =
-                _ecm.Component<components::LinearAcceleration>(_entity);
-            if (bodyLinAccelComp) {
-                Eigen::Vector3d bodyLinAccel =
-                    R_bs * frameData.linearAcceleration;
-                auto state =
-                    bodyLinAccelComp->SetData(
-                        math::eigen3::convert(bodyLinAccel), this->vec3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(
-                    _entity, components::LinearAcceleration::typeId, state);
+            // Update joint positions
+            for (auto& [joint, jointPos] : partition.jointPositions) {
+                const std::size_t nDofs = (*joint)->GetDegreesOfFreedom();
+                jointPos->Data().resize(nDofs);
+                for (std::size_t i = 0; i < nDofs; ++i) {
+                    jointPos->Data()[i] = (*joint)->GetPosition(i);
+                }
             }
 
-            // Angular acceleration in world frame coordinates
-            auto bodyAngAccelComp =
-                _ecm.Component<components::AngularAcceleration>(_entity);
-            if (bodyAngAccelComp) {
-                Eigen::Vector3d bodyAngAccel =
-                    R_bs * frameData.angularAcceleration;
-                auto state =
-                    bodyAngAccelComp->SetData(
-                        math::eigen3::convert(bodyAngAccel), this->vec3Eql)
-                        ? ComponentState::PeriodicChange
-                        : ComponentState::NoChange;
-                _ecm.SetChanged(
-                    _entity, components::AngularAcceleration::typeId, state);
+            // Update joint velocities
+            for (auto& [joint, jointVel] : partition.jointVelocities) {
+                const std::size_t nDofs = (*joint)->GetDegreesOfFreedom();
+                jointVel->Data().resize(nDofs);
+                for (std::size_t i = 0; i < nDofs; ++i) {
+                    jointVel->Data()[i] = (*joint)->GetVelocity(i);
+                }
             }
+        });
+
+    // Mark the changed components from the calling thread
+    for (size_t index = 0; index < this->modelPartitionMap.size(); ++index) {
+        for (const auto& change : this->partitions[index].changes) {
+            _ecm.SetChanged(change.entity, change.typeId, change.state);
         }
-        else {
-            ignwarn << "Unknown link with id " << _entity << " found\n";
-        }
-        return true;
-    });
+    }
 
     // joint force
     _ecm.Each<components::Joint,
@@ -1926,44 +2095,214 @@ void Physics::Impl::UpdateSim(const ignition::gazebo::UpdateInfo& _info,
             return true;
         });
 
-    // Update joint positions
-    _ecm.Each<components::Joint, components::JointPosition>(
-        [&](const Entity& _entity,
-            components::Joint*,
-            components::JointPosition* _jointPos) -> bool {
-            auto jointIt = this->entityJointMap.find(_entity);
-            if (jointIt != this->entityJointMap.end()) {
-                _jointPos->Data().resize(
-                    jointIt->second->GetDegreesOfFreedom());
-                for (std::size_t i = 0;
-                     i < jointIt->second->GetDegreesOfFreedom();
-                     ++i) {
-                    _jointPos->Data()[i] = jointIt->second->GetPosition(i);
-                }
-            }
-            return true;
-        });
+    // TODO(louise) Skip this if there are no collision features
+    this->UpdateCollisions(_ecm);
+}
 
-    // Update joint Velocities
-    _ecm.Each<components::Joint, components::JointVelocity>(
-        [&](const Entity& _entity,
-            components::Joint*,
-            components::JointVelocity* _jointVel) -> bool {
-            auto jointIt = this->entityJointMap.find(_entity);
-            if (jointIt != this->entityJointMap.end()) {
-                _jointVel->Data().resize(
-                    jointIt->second->GetDegreesOfFreedom());
-                for (std::size_t i = 0;
-                     i < jointIt->second->GetDegreesOfFreedom();
-                     ++i) {
-                    _jointVel->Data()[i] = jointIt->second->GetVelocity(i);
-                }
-            }
+void Physics::Impl::UpdateLink(const LinkUpdate& _link,
+                               EntityComponentManager& _ecm,
+                               std::vector<ChangedComponent>& _changes) const
+{
+    auto setChanged = [&_changes](const Entity _entity,
+                                  const ComponentTypeId _typeId,
+                                  const ComponentState _state) {
+        _changes.push_back({_entity, _typeId, _state});
+    };
+
+    // get the pose component of the parent model
+    const components::Pose* parentPose =
+        _ecm.Component<components::Pose>(_link.model);
+
+    auto frameData = _link.link->FrameDataRelativeToWorld();
+    const auto& worldPose = frameData.pose;
+
+    // if the parentPose is a nullptr, something is wrong with ECS
+    // creation
+    if (!parentPose) {
+        ignerr << "The pose component of " << _link.model
+               << " could not be found. This should never happen!\n";
+        return;
+    }
+    if (_link.canonical) {
+        // This is the canonical link, update the model
+        // The Pose component, _pose, of this link is the initial
+        // transform of the link w.r.t its model. This component
+        // never changes because it's "fixed" to the model. Instead,
+        // we change the model's pose here. The physics engine gives
+        // us the pose of this link relative to world so to set the
+        // model's pose, we have to post-multiply it by the inverse
+        // of the initial transform of the link w.r.t to its model.
+        auto mutableParentPose =
+            _ecm.Component<components::Pose>(_link.model);
+        *(mutableParentPose) = components::Pose(
+            _link.pose->Data().Inverse() + math::eigen3::convert(worldPose));
+        setChanged(_link.model,
+                   components::Pose::typeId,
+                   ComponentState::PeriodicChange);
+    }
+    else {
+        // Compute the relative pose of this link from the model
+        *_link.pose = components::Pose(math::eigen3::convert(worldPose)
+                                       + parentPose->Data().Inverse());
+        setChanged(_link.entity,
+                   components::Pose::typeId,
+                   ComponentState::PeriodicChange);
+    }
+
+    // Populate world poses, velocities and accelerations of the
+    // link. For now these components are updated only if another
+    // system has created the corresponding component on the entity.
+    auto worldPoseComp = _ecm.Component<components::WorldPose>(_link.entity);
+    if (worldPoseComp) {
+        auto state =
+            worldPoseComp->SetData(
+                math::eigen3::convert(frameData.pose), this->pose3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(_link.entity, components::WorldPose::typeId, state);
+    }
+
+    // Velocity in world coordinates
+    auto worldLinVelComp =
+        _ecm.Component<components::WorldLinearVelocity>(_link.entity);
+    if (worldLinVelComp) {
+        auto state =
+            worldLinVelComp->SetData(
+                math::eigen3::convert(frameData.linearVelocity),
+                this->vec3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(
+            _link.entity, components::WorldLinearVelocity::typeId, state);
+    }
+
+    // Angular velocity in world frame coordinates
+    auto worldAngVelComp =
+        _ecm.Component<components::WorldAngularVelocity>(_link.entity);
+    if (worldAngVelComp) {
+        auto state =
+            worldAngVelComp->SetData(
+                math::eigen3::convert(frameData.angularVelocity),
+                this->vec3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(
+            _link.entity, components::WorldAngularVelocity::typeId, state);
+    }
+
+    // Acceleration in world frame coordinates
+    auto worldLinAccelComp =
+        _ecm.Component<components::WorldLinearAcceleration>(_link.entity);
+    if (worldLinAccelComp) {
+        auto state =
+            worldLinAccelComp->SetData(
+                math::eigen3::convert(frameData.linearAcceleration),
+                this->vec3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(_link.entity,
+                   components::WorldLinearAcceleration::typeId,
+                   state);
+    }
+
+    // Angular acceleration in world frame coordinates
+    auto worldAngAccelComp =
+        _ecm.Component<components::WorldAngularAcceleration>(_link.entity);
+
+    if (worldAngAccelComp) {
+        auto state =
+            worldAngAccelComp->SetData(
+                math::eigen3::convert(frameData.angularAcceleration),
+                this->vec3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(_link.entity,
+                   components::WorldAngularAcceleration::typeId,
+                   state);
+    }
+
+    const Eigen::Matrix3d R_bs =
+        worldPose.linear().transpose(); // NOLINT
+
+    // Velocity in body-fixed frame coordinates
+    auto bodyLinVelComp =
+        _ecm.Component<components::LinearVelocity>(_link.entity);
+    if (bodyLinVelComp) {
+        Eigen::Vector3d bodyLinVel = R_bs * frameData.linearVelocity;
+        auto state =
+            bodyLinVelComp->SetData(math::eigen3::convert(bodyLinVel),
+                                    this->vec3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(
+            _link.entity, components::LinearVelocity::typeId, state);
+    }
+
+    // Angular velocity in body-fixed frame coordinates
+    auto bodyAngVelComp =
+        _ecm.Component<components::AngularVelocity>(_link.entity);
+    if (bodyAngVelComp) {
+        Eigen::Vector3d bodyAngVel = R_bs * frameData.angularVelocity;
+        auto state =
+            bodyAngVelComp->SetData(math::eigen3::convert(bodyAngVel),
+                                    this->vec3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(
+            _link.entity, components::AngularVelocity::typeId, state);
+    }
+
+    // Acceleration in body-fixed frame coordinates
+    auto bodyLinAccelComp =
+        _ecm.Component<components::LinearAcceleration>(_link.entity);
+    if (bodyLinAccelComp) {
+        Eigen::Vector3d bodyLinAccel =
+            R_bs * frameData.linearAcceleration;
+        auto state =
+            bodyLinAccelComp->SetData(
+                math::eigen3::convert(bodyLinAccel), this->vec3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(
+            _link.entity, components::LinearAcceleration::typeId, state);
+    }
+
+    // Angular acceleration in world frame coordinates
+    auto bodyAngAccelComp =
+        _ecm.Component<components::AngularAcceleration>(_link.entity);
+    if (bodyAngAccelComp) {
+        Eigen::Vector3d bodyAngAccel =
+            R_bs * frameData.angularAcceleration;
+        auto state =
+            bodyAngAccelComp->SetData(
+                math::eigen3::convert(bodyAngAccel), this->vec3Eql)
+                ? ComponentState::PeriodicChange
+                : ComponentState::NoChange;
+        setChanged(
+            _link.entity, components::AngularAcceleration::typeId, state);
+    }
+}
+
+scenario::core::utils::ThreadPool&
+Physics::Impl::ThreadPool(const EntityComponentManager& _ecm)
+{
+    size_t numOfThreads = 1;
+
+    _ecm.Each<components::World, components::PhysicsThreads>(
+        [&](const Entity&,
+            const components::World*,
+            const components::PhysicsThreads* _threads) {
+            numOfThreads = _threads->Data();
             return true;
         });
 
-    // TODO(louise) Skip this if there are no collision features
-    this->UpdateCollisions(_ecm);
+    if (!this->threadPool || numOfThreads != this->threadPoolSize) {
+        this->threadPool =
+            std::make_unique<scenario::core::utils::ThreadPool>(numOfThreads);
+        this->threadPoolSize = numOfThreads;
+    }
+
+    return *this->threadPool;
 }
 
 void Physics::Impl::UpdateCollisions(EntityComponentManager& _ecm)
@@ -2001,24 +2340,12 @@ void Physics::Impl::UpdateCollisions(EntityComponentManager& _ecm)
         return;
     }
 
-    // Struct containing pointer of contact data
-    struct AllContactData
-    {
-        const WorldShapeType::ContactPoint* point;
-        const WorldShapeType::ExtraContactData* extra;
-    };
-
     // Each contact object we get from ign-physics contains the EntityPtrs
     // of the two colliding entities and other data about the contact such
-    // as the position. This map groups contacts so that it is easy to query
+    // as the position. The contacts are stored twice, once for each
+    // collision, and sorted by pair of entities so that it is easy to query
     // all the contacts of one entity.
-    using EntityContactMap =
-        std::unordered_map<Entity, std::deque<AllContactData>>;
-
-    // This data structure is essentially a mapping between a pair of
-    // entities and a list of pointers to their contact object. We use a map
-    // inside a map to create msgs::Contact objects conveniently later on.
-    std::unordered_map<Entity, EntityContactMap> entityContactMap;
+    this->contactRecords.clear();
 
     // Note that we are temporarily storing pointers to elements in this
     // ("allContacts") container. Thus, we must make sure it doesn't get
@@ -2031,30 +2358,41 @@ void Physics::Impl::UpdateCollisions(EntityComponentManager& _ecm)
         auto coll1It = this->collisionEntityMap.find(contact.collision1);
         auto coll2It = this->collisionEntityMap.find(contact.collision2);
 
+        if ((coll1It == this->collisionEntityMap.end())
+            || (coll2It == this->collisionEntityMap.end())) {
+            continue;
+        }
+
         // Check the ExpectData
         const auto* extraContactData =
             contactComposite.Query<WorldShapeType::ExtraContactData>();
 
-        if ((coll1It != this->collisionEntityMap.end())
-            && (coll2It != this->collisionEntityMap.end())) {
-
-            AllContactData allContactData;
-            allContactData.point = &contact;
-
-            if (extraContactData) {
-                allContactData.extra = extraContactData;
-            }
-
-            // Note that the ExtraContactData is valid only when the first
-            // collision is the first body. Quantities like the force and
-            // the normal must be flipped in the second case.
-            entityContactMap[coll1It->second][coll2It->second].push_back(
-                allContactData);
-            entityContactMap[coll2It->second][coll1It->second].push_back(
-                allContactData);
-        }
+        // Note that the ExtraContactData is valid only when the first
+        // collision is the first body. Quantities like the force and
+        // the normal must be flipped in the second case.
+        const size_t index = this->contactRecords.size();
+        this->contactRecords.push_back({coll1It->second,
+                                        coll2It->second,
+                                        index,
+                                        &contact,
+                                        extraContactData,
+                                        false});
+        this->contactRecords.push_back({coll2It->second,
+                                        coll1It->second,
+                                        index,
+                                        &contact,
+                                        extraContactData,
+                                        true});
     }
 
+    // The index keeps the order of the contacts of the same pair
+    std::sort(this->contactRecords.begin(),
+              this->contactRecords.end(),
+              [](const ContactRecord& _a, const ContactRecord& _b) {
+                  return std::tie(_a.collision1, _a.collision2, _a.index)
+                         < std::tie(_b.collision1, _b.collision2, _b.index);
+              });
+
     // Go through each collision entity that has a ContactData component and
     // set the component value to the list of contacts that correspond to
     // the collision entity
@@ -2062,96 +2400,234 @@ void Physics::Impl::UpdateCollisions(EntityComponentManager& _ecm)
         [&](const Entity& _collEntity1,
             components::Collision*,
             components::ContactSensorData* _contacts) -> bool {
-            if (entityContactMap.find(_collEntity1) == entityContactMap.end()) {
-                // Clear the last contact data
-                *_contacts = components::ContactSensorData();
+            auto begin = std::lower_bound(
+                this->contactRecords.begin(),
+                this->contactRecords.end(),
+                _collEntity1,
+                [](const ContactRecord& _record, const Entity _entity) {
+                    return _record.collision1 < _entity;
+                });
+
+            auto end = begin;
+            while (end != this->contactRecords.end()
+                   && end->collision1 == _collEntity1) {
+                ++end;
+            }
+
+            // Clear the last contact data. The cleared messages are kept
+            // by protobuf and reused by the next contacts.
+            msgs::Contacts& contactsComp = _contacts->Data();
+            contactsComp.Clear();
+
+            if (begin == end) {
                 return true;
             }
 
-            const auto& contactMap = entityContactMap[_collEntity1];
+            // The names are only referenced from the map and copied into
+            // the cleared wrench messages, that keep their string capacity
+            auto findName = [this](const Entity _entity) -> const std::string* {
+                auto nameIt = this->collisionNameMap.find(_entity);
+                if (nameIt == this->collisionNameMap.end()) {
+                    ignwarn << "Failed to find the name of collision ["
+                            << _entity << "], skipping its contacts"
+                            << std::endl;
+                    return nullptr;
+                }
+                return &nameIt->second;
+            };
 
-            msgs::Contacts contactsComp;
+            const std::string* collisionName1 = findName(_collEntity1);
 
-            for (const auto& [collEntity2, contactData] : contactMap) {
+            if (!collisionName1) {
+                return true;
+            }
+
+            for (auto it = begin; it != end;) {
+                const Entity collEntity2 = it->collision2;
+                const std::string* collisionName2 = findName(collEntity2);
+
+                if (!collisionName2) {
+                    while (it != end && it->collision2 == collEntity2) {
+                        ++it;
+                    }
+                    continue;
+                }
 
                 msgs::Contact* contactMsg = contactsComp.add_contact();
                 contactMsg->mutable_collision1()->set_id(_collEntity1);
                 contactMsg->mutable_collision2()->set_id(collEntity2);
 
-                for (const auto& contact : contactData) {
+                for (; it != end && it->collision2 == collEntity2; ++it) {
+                    const auto& contact = *it;
+
                     auto* position = contactMsg->add_position();
                     position->set_x(contact.point->point.x());
                     position->set_y(contact.point->point.y());
                     position->set_z(contact.point->point.z());
 
-                    if (contact.extra) {
-                        // Add the penetration depth
-                        contactMsg->add_depth(contact.extra->depth);
-
-                        // Get the name of the collisions
-                        auto collisionName1 =
-                            _ecm.Component<components::Name>(_collEntity1)
-                                ->Data();
-                        auto collisionName2 =
-                            _ecm.Component<components::Name>(collEntity2)
-                                ->Data();
-
-                        // Add the wrench (only the force component)
-                        auto* wrench = contactMsg->add_wrench();
-                        wrench->set_body_1_name(collisionName1);
-                        wrench->set_body_2_name(collisionName2);
-                        auto* wrench1 = wrench->mutable_body_1_wrench();
-                        auto* wrench2 = wrench->mutable_body_2_wrench();
-
-                        auto* force1 = wrench1->mutable_force();
-                        auto* force2 = wrench2->mutable_force();
-                        auto* torque1 = wrench1->mutable_torque();
-                        auto* torque2 = wrench2->mutable_torque();
-
-                        // The same ContactPoint and ExtraContactData are
-                        // used for the contact between collision1 and
-                        // collision2. In those structures there is some
-                        // data, like the force and normal, that cannot
-                        // commute.
-                        if (_collEntity1
-                            == this->collisionEntityMap.at(
-                                contact.point->collision1)) {
-                            assert(collEntity2
-                                   == this->collisionEntityMap.at(
-                                       contact.point->collision2));
-                            // Use the data as it is
-                            *force1 = msgs::Convert(
-                                math::eigen3::convert(contact.extra->force));
-                            *force2 = msgs::Convert(
-                                -math::eigen3::convert(contact.extra->force));
-                            // Add the wrench normal
-                            auto* normal = contactMsg->add_normal();
-                            normal->set_x(contact.extra->normal.x());
-                            normal->set_y(contact.extra->normal.y());
-                            normal->set_z(contact.extra->normal.z());
-                        }
-                        else {
-                            assert(collEntity2
-                                   == this->collisionEntityMap.at(
-                                       contact.point->collision1));
-                            // Flip the force
-                            *force1 = msgs::Convert(
-                                -math::eigen3::convert(contact.extra->force));
-                            *force2 = msgs::Convert(
-                                math::eigen3::convert(contact.extra->force));
-                            // Flip the normal
-                            auto* normal = contactMsg->add_normal();
-                            normal->set_x(-contact.extra->normal.x());
-                            normal->set_y(-contact.extra->normal.y());
-                            normal->set_z(-contact.extra->normal.z());
-                        }
-
-                        *torque1 = msgs::Convert(math::Vector3d::Zero);
-                        *torque2 = msgs::Convert(math::Vector3d::Zero);
+                    if (!contact.extra) {
+                        continue;
                     }
+
+                    // Add the penetration depth
+                    contactMsg->add_depth(contact.extra->depth);
+
+                    // Add the wrench (only the force component)
+                    auto* wrench = contactMsg->add_wrench();
+                    wrench->set_body_1_name(*collisionName1);
+                    wrench->set_body_1_id(_collEntity1);
+                    wrench->set_body_2_name(*collisionName2);
+                    wrench->set_body_2_id(collEntity2);
+                    auto* wrench1 = wrench->mutable_body_1_wrench();
+                    auto* wrench2 = wrench->mutable_body_2_wrench();
+
+                    auto* force1 = wrench1->mutable_force();
+                    auto* force2 = wrench2->mutable_force();
+                    auto* torque1 = wrench1->mutable_torque();
+                    auto* torque2 = wrench2->mutable_torque();
+
+                    // The same ContactPoint and ExtraContactData are used for
+                    // the contact between collision1 and collision2. In those
+                    // structures there is some data, like the force and
+                    // normal, that cannot commute.
+                    const double sign = contact.flipped ? -1.0 : 1.0;
+                    const Eigen::Vector3d force = sign * contact.extra->force;
+                    const Eigen::Vector3d normal = sign * contact.extra->normal;
+
+                    msgs::Set(force1, math::eigen3::convert(force));
+                    msgs::Set(force2, math::eigen3::convert(-force));
+
+                    // Add the wrench normal
+                    auto* normalMsg = contactMsg->add_normal();
+                    normalMsg->set_x(normal.x());
+                    normalMsg->set_y(normal.y());
+                    normalMsg->set_z(normal.z());
+
+                    msgs::Set(torque1, math::Vector3d::Zero);
+                    msgs::Set(torque2, math::Vector3d::Zero);
                 }
             }
-            *_contacts = components::ContactSensorData(contactsComp);
+
+            return true;
+        });
+}
+
+void Physics::Impl::UpdateAccumulators(
+    const ignition::gazebo::UpdateInfo& _info,
+    EntityComponentManager& _ecm)
+{
+    // The accumulators are updated only when the physics is stepped
+    if (_info.paused)
+        return;
+
+    using scenario::gazebo::AccumulatedQuantity;
+    const double dt = std::chrono::duration<double>(_info.dt).count();
+
+    // The children of the models change only when entities are created or
+    // removed, the cached lists are reused otherwise
+    if (_ecm.HasNewEntities() || _ecm.HasEntitiesMarkedForRemoval())
+        this->accumulatedEntitiesMap.clear();
+
+    _ecm.Each<components::Model, components::ModelAccumulators>(
+        [&](const Entity& _entity,
+            const components::Model*,
+            components::ModelAccumulators* _accumulators) -> bool {
+            auto [entitiesIt, inserted] =
+                this->accumulatedEntitiesMap.try_emplace(_entity);
+            AccumulatedEntities& entities = entitiesIt->second;
+
+            if (inserted) {
+                entities.joints =
+                    _ecm.ChildrenByComponents(_entity, components::Joint());
+                entities.links =
+                    _ecm.ChildrenByComponents(_entity, components::Link());
+
+                for (const auto& link : entities.links) {
+                    for (const auto& collision : _ecm.ChildrenByComponents(
+                             link, components::Collision())) {
+                        entities.collisions.push_back(collision);
+                    }
+                }
+            }
+
+            // Joint power and maximum joint velocity
+            double jointPower = 0.0;
+            double jointVelocity = 0.0;
+
+            for (const auto& joint : entities.joints) {
+                const auto* velocityComp =
+                    _ecm.Component<components::JointVelocity>(joint);
+                const auto* forceComp =
+                    _ecm.Component<components::JointForce>(joint);
+
+                if (!velocityComp)
+                    continue;
+
+                const auto& velocities = velocityComp->Data();
+
+                for (std::size_t i = 0; i < velocities.size(); ++i) {
+                    jointVelocity =
+                        std::max(jointVelocity, std::abs(velocities[i]));
+
+                    if (forceComp && i < forceComp->Data().size())
+                        jointPower += forceComp->Data()[i] * velocities[i];
+                }
+            }
+
+            // Total contact force and maximum link velocity
+            math::Vector3d contactForce = math::Vector3d::Zero;
+            double linkLinearVelocity = 0.0;
+
+            for (const auto& link : entities.links) {
+                const auto* velocityComp =
+                    _ecm.Component<components::WorldLinearVelocity>(link);
+
+                if (velocityComp) {
+                    linkLinearVelocity = std::max(
+                        linkLinearVelocity, velocityComp->Data().Length());
+                }
+            }
+
+            for (const auto& collision : entities.collisions) {
+                const auto* contactsComp =
+                    _ecm.Component<components::ContactSensorData>(collision);
+
+                if (!contactsComp)
+                    continue;
+
+                // The first body of the wrenches is always the collision
+                // that owns the component
+                for (const auto& contact : contactsComp->Data().contact()) {
+                    for (const auto& wrench : contact.wrench()) {
+                        contactForce +=
+                            msgs::Convert(wrench.body_1_wrench().force());
+                    }
+                }
+            }
+
+            auto accumulate = [dt](scenario::gazebo::Statistics& _statistics,
+                                   const double _value) {
+                if (_statistics.samples == 0) {
+                    _statistics.min = _value;
+                    _statistics.max = _value;
+                }
+
+                _statistics.samples++;
+                _statistics.sum += _value;
+                _statistics.integral += _value * dt;
+                _statistics.min = std::min(_statistics.min, _value);
+                _statistics.max = std::max(_statistics.max, _value);
+            };
+
+            auto& accumulators = _accumulators->Data();
+            accumulate(accumulators[AccumulatedQuantity::JointPower],
+                       jointPower);
+            accumulate(accumulators[AccumulatedQuantity::JointVelocity],
+                       jointVelocity);
+            accumulate(accumulators[AccumulatedQuantity::ContactForce],
+                       contactForce.Length());
+            accumulate(accumulators[AccumulatedQuantity::LinkLinearVelocity],
+                       linkLinearVelocity);
 
             return true;
         });
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FeedForwardPolicy.h"
+#include "scenario/gazebo/Log.h"
+
+#include <cmath>
+#include <fstream>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace scenario::plugins::gazebo;
+
+using RowMajorMatrix =
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+enum class Activation
+{
+    Linear,
+    Tanh,
+    ReLU,
+};
+
+struct Layer
+{
+    RowMajorMatrix weights;
+    Eigen::VectorXd bias;
+    Eigen::VectorXd output;
+    Activation activation = Activation::Linear;
+};
+
+class FeedForwardPolicy::Impl
+{
+public:
+    Eigen::VectorXd input;
+    std::vector<Layer> layers;
+
+    static bool ReadToken(std::istream& in, std::string& token);
+    static bool ReadValue(std::istream& in, double& value);
+    static bool ReadSize(std::istream& in, size_t& size);
+    static bool ReadActivation(std::istream& in, Activation& activation);
+};
+
+FeedForwardPolicy::FeedForwardPolicy()
+    : pImpl{std::make_unique<Impl>()}
+{}
+
+FeedForwardPolicy::~FeedForwardPolicy() = default;
+
+bool FeedForwardPolicy::load(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+
+    if (!file.is_open()) {
+        sError << "Failed to open policy file '" << fileName << "'"
+               << std::endl;
+        return false;
+    }
+
+    // Locale independent floating point conversion
+    file.imbue(std::locale::classic());
+
+    std::string token;
+    size_t nrOfLayers = 0;
+
+    if (!Impl::ReadToken(file, token) || token != "layers"
+        || !Impl::ReadSize(file, nrOfLayers)) {
+        sError << "Failed to read the number of layers" << std::endl;
+        return false;
+    }
+
+    std::vector<Layer> layers(nrOfLayers);
+
+    for (size_t l = 0; l < layers.size(); ++l) {
+        size_t rows = 0;
+        size_t cols = 0;
+        Layer& layer = layers[l];
+
+        if (!Impl::ReadToken(file, token) || token != "dense"
+            || !Impl::ReadSize(file, rows) || !Impl::ReadSize(file, cols)
+            || !Impl::ReadActivation(file, layer.activation)) {
+            sError << "Failed to read the header of layer #" << l << std::endl;
+            return false;
+        }
+
+        layer.weights.resize(static_cast<Eigen::Index>(rows),
+                             static_cast<Eigen::Index>(cols));
+        layer.bias.resize(static_cast<Eigen::Index>(rows));
+        layer.output.setZero(static_cast<Eigen::Index>(rows));
+
+        if (l > 0 && layers[l - 1].weights.rows() != layer.weights.cols()) {
+            sError << "Layer #" << l << " expects " << layer.weights.cols()
+                   << " inputs but the previous layer has "
+                   << layers[l - 1].weights.rows() << " outputs" << std::endl;
+            return false;
+        }
+
+        for (Eigen::Index i = 0; i < layer.weights.size(); ++i) {
+            if (!Impl::ReadValue(file, layer.weights.data()[i])) {
+                sError << "Failed to read the weights of layer #" << l
+                       << std::endl;
+                return false;
+            }
+        }
+
+        for (Eigen::Index i = 0; i < layer.bias.size(); ++i) {
+            if (!Impl::ReadValue(file, layer.bias[i])) {
+                sError << "Failed to read the biases of layer #" << l
+                       << std::endl;
+                return false;
+            }
+        }
+    }
+
+    if (Impl::ReadToken(file, token)) {
+        sWarning << "Ignoring trailing content in policy file '" << fileName
+                 << "'" << std::endl;
+    }
+
+    pImpl->layers = std::move(layers);
+    pImpl->input.setZero(pImpl->layers.front().weights.cols());
+
+    sDebug << "Loaded policy with " << pImpl->layers.size() << " layers ("
+           << this->inputSize() << " inputs, " << this->outputSize()
+           << " outputs)" << std::endl;
+
+    return true;
+}
+
+size_t FeedForwardPolicy::inputSize() const
+{
+    return static_cast<size_t>(pImpl->input.size());
+}
+
+size_t FeedForwardPolicy::outputSize() const
+{
+    if (pImpl->layers.empty()) {
+        return 0;
+    }
+
+    return static_cast<size_t>(pImpl->layers.back().output.size());
+}
+
+Eigen::Ref<Eigen::VectorXd> FeedForwardPolicy::input()
+{
+    return pImpl->input;
+}
+
+Eigen::Ref<const Eigen::VectorXd> FeedForwardPolicy::evaluate()
+{
+    const Eigen::VectorXd* layerInput = &pImpl->input;
+
+    for (auto& layer : pImpl->layers) {
+        // Eigen dispatches the product to its vectorized GEMV kernel.
+        // The noalias() prevents the allocation of a temporary.
+        layer.output.noalias() = layer.weights * (*layerInput);
+        layer.output += layer.bias;
+
+        switch (layer.activation) {
+            case Activation::Linear:
+                break;
+            case Activation::Tanh:
+                layer.output = layer.output.array().tanh();
+                break;
+            case Activation::ReLU:
+                layer.output = layer.output.cwiseMax(0.0);
+                break;
+        }
+
+        layerInput = &layer.output;
+    }
+
+    return *layerInput;
+}
+
+bool FeedForwardPolicy::Impl::ReadToken(std::istream& in, std::string& token)
+{
+    while (in >> token) {
+        if (token.front() != '#') {
+            return true;
+        }
+
+        // Skip the rest of the comment line
+        std::getline(in, token);
+    }
+
+    return false;
+}
+
+bool FeedForwardPolicy::Impl::ReadValue(std::istream& in, double& value)
+{
+    std::string token;
+
+    if (!ReadToken(in, token)) {
+        return false;
+    }
+
+    std::istringstream stream(token);
+    stream.imbue(std::locale::classic());
+
+    return (stream >> value) && stream.eof() && std::isfinite(value);
+}
+
+bool FeedForwardPolicy::Impl::ReadSize(std::istream& in, size_t& size)
+{
+    std::string token;
+
+    if (!ReadToken(in, token)) {
+        return false;
+    }
+
+    // Sizes are positive integers, values like "2.5" or "-1" are rejected
+    if (token.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+
+    std::istringstream stream(token);
+    stream.imbue(std::locale::classic());
+
+    return (stream >> size) && stream.eof() && size > 0;
+}
+
+bool FeedForwardPolicy::Impl::ReadActivation(std::istream& in,
+                                             Activation& activation)
+{
+    std::string token;
+
+    if (!ReadToken(in, token)) {
+        return false;
+    }
+
+    if (token == "linear") {
+        activation = Activation::Linear;
+    }
+    else if (token == "tanh") {
+        activation = Activation::Tanh;
+    }
+    else if (token == "relu") {
+        activation = Activation::ReLU;
+    }
+    else {
+        sError << "Activation '" << token << "' not supported" << std::endl;
+        return false;
+    }
+
+    return true;
+}
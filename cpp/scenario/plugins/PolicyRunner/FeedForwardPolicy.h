@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCENARIO_PLUGINS_GAZEBO_FEEDFORWARDPOLICY_H
+#define SCENARIO_PLUGINS_GAZEBO_FEEDFORWARDPOLICY_H
+
+#include <Eigen/Core>
+
+#include <memory>
+#include <string>
+
+namespace scenario::plugins::gazebo {
+    class FeedForwardPolicy;
+} // namespace scenario::plugins::gazebo
+
+/**
+ * Minimal feed-forward network evaluated in-process.
+ *
+ * The network is loaded from a plain-text weight file with the following
+ * format (whitespace separated, lines starting with '#' are ignored):
+ *
+ * @code
+ * layers <number_of_layers>
+ * dense <rows> <cols> <linear|tanh|relu>
+ * <rows * cols weights, row-major>
+ * <rows biases>
+ * ...
+ * @endcode
+ *
+ * The columns of the first layer define the input size and the rows of the
+ * last layer the output size. All the buffers are allocated when the file is
+ * loaded, the evaluation does not allocate memory.
+ */
+class scenario::plugins::gazebo::FeedForwardPolicy
+{
+public:
+    FeedForwardPolicy();
+    ~FeedForwardPolicy();
+
+    /**
+     * Load the network from a weight file.
+     *
+     * @param fileName The path to the weight file.
+     * @return True for success, false otherwise.
+     */
+    bool load(const std::string& fileName);
+
+    size_t inputSize() const;
+    size_t outputSize() const;
+
+    /**
+     * Get the preallocated input buffer.
+     *
+     * @return A reference to the input of the first layer.
+     */
+    Eigen::Ref<Eigen::VectorXd> input();
+
+    /**
+     * Evaluate the network on the data stored in the input buffer.
+     *
+     * @return A reference to the activations of the last layer.
+     */
+    Eigen::Ref<const Eigen::VectorXd> evaluate();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // SCENARIO_PLUGINS_GAZEBO_FEEDFORWARDPOLICY_H
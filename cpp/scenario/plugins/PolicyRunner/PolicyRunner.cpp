@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PolicyRunner.h"
+#include "FeedForwardPolicy.h"
+#include "scenario/gazebo/Joint.h"
+#include "scenario/gazebo/Log.h"
+#include "scenario/gazebo/Model.h"
+#include "scenario/gazebo/exceptions.h"
+#include "scenario/gazebo/helpers.h"
+
+#include <ignition/gazebo/components/JointPosition.hh>
+#include <ignition/gazebo/components/JointVelocity.hh>
+#include <ignition/plugin/Register.hh>
+#include <sdf/Element.hh>
+
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace scenario::gazebo;
+using namespace scenario::plugins::gazebo;
+
+enum class PolicyTarget
+{
+    Position,
+    Velocity,
+    Force,
+};
+
+class PolicyRunner::Impl
+{
+public:
+    bool policyEvaluated = false;
+
+    std::shared_ptr<Model> model;
+    ignition::gazebo::Entity modelEntity;
+    std::chrono::steady_clock::duration prevUpdateTime{0};
+
+    FeedForwardPolicy policy;
+    PolicyTarget target = PolicyTarget::Position;
+
+    // Joint handles and entities resolved when the plugin is configured
+    std::vector<std::shared_ptr<Joint>> joints;
+    std::vector<ignition::gazebo::Entity> jointEntities;
+
+    // Copy of the last action, actuated until the next policy evaluation
+    Eigen::VectorXd action;
+
+    bool parseContext(const sdf::ElementPtr context);
+    bool updateObservation(ignition::gazebo::EntityComponentManager& ecm);
+    bool actuate();
+};
+
+PolicyRunner::PolicyRunner()
+    : System()
+    , pImpl{std::make_unique<Impl>()}
+{}
+
+PolicyRunner::~PolicyRunner() = default;
+
+void PolicyRunner::Configure(const ignition::gazebo::Entity& entity,
+                             const std::shared_ptr<const sdf::Element>& sdf,
+                             ignition::gazebo::EntityComponentManager& ecm,
+                             ignition::gazebo::EventManager& eventMgr)
+{
+    // Store the model entity
+    pImpl->modelEntity = entity;
+
+    // Create the model used to resolve the joints
+    auto model = std::make_shared<Model>();
+
+    if (!model->initialize(entity, &ecm, &eventMgr)) {
+        sError << "Failed to initialize model for the policy" << std::endl;
+        return;
+    }
+
+    if (!model->valid()) {
+        sError << "Failed to create a model from Entity [" << entity << "]"
+               << std::endl;
+        return;
+    }
+
+    if (sdf->GetName() != "plugin") {
+        sError << "Received context does not contain the <plugin> element"
+               << std::endl;
+        return;
+    }
+
+    // This is the <plugin> element (with extra options stored in its children)
+    sdf::ElementPtr pluginElement = sdf->Clone();
+
+    if (!pluginElement->HasElement("policy")) {
+        sError << "Failed to find the <policy> element in the plugin context"
+               << std::endl;
+        return;
+    }
+
+    pImpl->model = model;
+
+    if (!pImpl->parseContext(pluginElement->GetElement("policy"))) {
+        sError << "Failed to parse the policy context" << std::endl;
+        pImpl->model = nullptr;
+        return;
+    }
+
+    sDebug << "Policy successfully initialized" << std::endl;
+}
+
+void PolicyRunner::PreUpdate(const ignition::gazebo::UpdateInfo& info,
+                             ignition::gazebo::EntityComponentManager& ecm)
+{
+    if (info.paused) {
+        return;
+    }
+
+    if (!pImpl->model) {
+        return;
+    }
+
+    // This plugin keeps being called also after the model was removed
+    if (utils::isModelRemoved(&ecm, pImpl->modelEntity)) {
+        pImpl->model = nullptr;
+        return;
+    }
+
+    using namespace std::chrono;
+
+    // Evaluate the policy only if enough time is passed
+    duration<double> elapsedFromLastUpdate =
+        info.simTime - pImpl->prevUpdateTime;
+    assert(elapsedFromLastUpdate.count() > 0);
+
+    // Handle first iteration
+    if (pImpl->prevUpdateTime.count() == 0) {
+        elapsedFromLastUpdate =
+            duration<double>(pImpl->model->controllerPeriod());
+    }
+
+    // Due to numerical floating point approximations, sometimes a comparison of
+    // chrono durations has an error in the 1e-18 order
+    auto greaterThan = [](const duration<double>& a,
+                          const duration<double>& b) -> bool {
+        return a.count() >= b.count() - std::numeric_limits<double>::epsilon();
+    };
+
+    if (greaterThan(elapsedFromLastUpdate,
+                    duration<double>(pImpl->model->controllerPeriod()))) {
+        // Store the current update time
+        pImpl->prevUpdateTime = info.simTime;
+
+        if (!pImpl->updateObservation(ecm)) {
+            sWarning << "[t="
+                     << utils::steadyClockDurationToDouble(info.simTime)
+                     << "] The policy is not stepping" << std::endl;
+            return;
+        }
+
+        pImpl->action = pImpl->policy.evaluate();
+        pImpl->policyEvaluated = true;
+    }
+
+    // The force command is consumed by the physics at every step, therefore
+    // the last action is actuated also when the policy is not evaluated
+    if (pImpl->policyEvaluated && !pImpl->actuate()) {
+        sError << "Failed to actuate the policy action" << std::endl;
+        return;
+    }
+}
+
+bool PolicyRunner::Impl::parseContext(const sdf::ElementPtr context)
+{
+    if (!(context->HasElement("weights") && context->HasElement("joints"))) {
+        sError << "Policy context has missing elements" << std::endl;
+        return false;
+    }
+
+    const auto weights = context->Get<std::string>("weights");
+
+    if (!policy.load(weights)) {
+        sError << "Failed to load policy from '" << weights << "'"
+               << std::endl;
+        return false;
+    }
+
+    std::string jointName;
+    std::stringstream jointNames(context->Get<std::string>("joints"));
+
+    while (jointNames >> jointName) {
+        std::shared_ptr<Joint> joint;
+
+        try {
+            joint = std::static_pointer_cast<Joint>(model->getJoint(jointName));
+        }
+        catch (const exceptions::JointNotFound& e) {
+            sError << e.what() << std::endl;
+            return false;
+        }
+
+        if (joint->dofs() != 1) {
+            sError << "Joint '" << jointName << "' has " << joint->dofs()
+                   << " DoFs, only single-DoF joints are supported"
+                   << std::endl;
+            return false;
+        }
+
+        joints.push_back(joint);
+        jointEntities.push_back(joint->id());
+    }
+
+    // The observation is the vector [positions, velocities] of the joints
+    if (policy.inputSize() != 2 * joints.size()) {
+        sError << "The policy expects " << policy.inputSize()
+               << " inputs but the observation of " << joints.size()
+               << " joints has " << 2 * joints.size() << " elements"
+               << std::endl;
+        return false;
+    }
+
+    if (policy.outputSize() != joints.size()) {
+        sError << "The policy has " << policy.outputSize()
+               << " outputs but it controls " << joints.size() << " joints"
+               << std::endl;
+        return false;
+    }
+
+    const std::string targetName = context->HasElement("target")
+                                       ? context->Get<std::string>("target")
+                                       : "position";
+
+    if (targetName == "position") {
+        target = PolicyTarget::Position;
+    }
+    else if (targetName == "velocity") {
+        target = PolicyTarget::Velocity;
+    }
+    else if (targetName == "force") {
+        target = PolicyTarget::Force;
+    }
+    else {
+        sError << "Policy target '" << targetName << "' not supported"
+               << std::endl;
+        return false;
+    }
+
+    action.setZero(static_cast<Eigen::Index>(joints.size()));
+    return true;
+}
+
+bool PolicyRunner::Impl::updateObservation(
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    using namespace ignition::gazebo;
+
+    auto observation = policy.input();
+    const Eigen::Index nrOfJoints = static_cast<Eigen::Index>(joints.size());
+
+    // Read the state from the ECM without copying the components data
+    for (Eigen::Index i = 0; i < nrOfJoints; ++i) {
+        const auto entity = jointEntities[static_cast<size_t>(i)];
+
+        const auto* position = utils::tryGetExistingComponentData< //
+            components::JointPosition>(&ecm, entity);
+        const auto* velocity = utils::tryGetExistingComponentData< //
+            components::JointVelocity>(&ecm, entity);
+
+        // The joint state is populated by the physics after the first step
+        if (!(position && velocity && !position->empty()
+              && !velocity->empty())) {
+            sDebug << "The state of joint [" << entity
+                   << "] is not yet available" << std::endl;
+            return false;
+        }
+
+        observation[i] = (*position)[0];
+        observation[nrOfJoints + i] = (*velocity)[0];
+    }
+
+    return true;
+}
+
+bool PolicyRunner::Impl::actuate()
+{
+    bool ok = true;
+
+    for (size_t i = 0; i < joints.size(); ++i) {
+        const double value = action[static_cast<Eigen::Index>(i)];
+
+        switch (target) {
+            case PolicyTarget::Position:
+                ok = joints[i]->setPositionTarget(value) && ok;
+                break;
+            case PolicyTarget::Velocity:
+                ok = joints[i]->setVelocityTarget(value) && ok;
+                break;
+            case PolicyTarget::Force:
+                ok = joints[i]->setGeneralizedForceTarget(value) && ok;
+                break;
+        }
+    }
+
+    return ok;
+}
+
+IGNITION_ADD_PLUGIN(scenario::plugins::gazebo::PolicyRunner,
+                    scenario::plugins::gazebo::PolicyRunner::System,
+                    scenario::plugins::gazebo::PolicyRunner::ISystemConfigure,
+                    scenario::plugins::gazebo::PolicyRunner::ISystemPreUpdate)
@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This project is dual licensed under LGPL v2.1+ or Apache License.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * This software may be modified and distributed under the terms of the
+ * GNU Lesser General Public License v2.1 or any later version.
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorldJointController.h"
+#include "scenario/gazebo/Joint.h"
+#include "scenario/gazebo/Log.h"
+#include "scenario/gazebo/components/JointControlMode.h"
+#include "scenario/gazebo/components/JointController.h"
+#include "scenario/gazebo/components/JointControllerPeriod.h"
+#include "scenario/gazebo/components/JointPID.h"
+#include "scenario/gazebo/components/JointPositionTarget.h"
+#include "scenario/gazebo/components/JointVelocityTarget.h"
+#include "scenario/gazebo/components/WorldJointController.h"
+#include "scenario/gazebo/helpers.h"
+
+#include <ignition/gazebo/Entity.hh>
+#include <ignition/gazebo/components/Joint.hh>
+#include <ignition/gazebo/components/JointPosition.hh>
+#include <ignition/gazebo/components/JointVelocity.hh>
+#include <ignition/gazebo/components/Model.hh>
+#include <ignition/gazebo/components/ParentEntity.hh>
+#include <ignition/gazebo/components/World.hh>
+#include <ignition/math/PID.hh>
+#include <ignition/plugin/Register.hh>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace scenario::gazebo;
+using namespace scenario::plugins::gazebo;
+
+class WorldJointController::Impl
+{
+public:
+    ignition::gazebo::EventManager* eventManager = nullptr;
+
+    struct ModelData
+    {
+        // Iteration of the step in which computeNewForce was updated
+        uint64_t lastVisit = std::numeric_limits<uint64_t>::max();
+
+        // The PIDs are updated every periodTicks steps. The number of steps
+        // is resolved again when the period or the step size change.
+        uint64_t ticks = 0;
+        uint64_t periodTicks = 1;
+        double period = 0;
+        std::chrono::steady_clock::duration stepSize{0};
+
+        bool computeNewForce = false;
+        bool hasModelPlugin = false;
+    };
+
+    std::unordered_map<ignition::gazebo::Entity, ModelData> models;
+    std::unordered_map<ignition::gazebo::Entity, std::shared_ptr<Joint>> joints;
+
+    void removeEntities(ignition::gazebo::EntityComponentManager& ecm);
+
+    ModelData& getModelData(const ignition::gazebo::Entity modelEntity,
+                            const ignition::gazebo::UpdateInfo& info,
+                            ignition::gazebo::EntityComponentManager& ecm);
+
+    std::shared_ptr<Joint>
+    getJoint(const ignition::gazebo::Entity jointEntity,
+             ignition::gazebo::EntityComponentManager& ecm);
+
+    static bool runPIDController(scenario::gazebo::Joint& joint,
+                                 const bool computeNewForce,
+                                 ignition::math::PID& pid,
+                                 const std::chrono::steady_clock::duration& dt,
+                                 const std::vector<double>& reference,
+                                 const std::vector<double>& current);
+};
+
+WorldJointController::WorldJointController()
+    : System()
+    , pImpl{std::make_unique<Impl>()}
+{}
+
+WorldJointController::~WorldJointController() = default;
+
+void WorldJointController::Configure(
+    const ignition::gazebo::Entity& entity,
+    const std::shared_ptr<const sdf::Element>& /*sdf*/,
+    ignition::gazebo::EntityComponentManager& ecm,
+    ignition::gazebo::EventManager& eventMgr)
+{
+    if (!ecm.EntityHasComponentType(
+            entity, ignition::gazebo::components::World::typeId)) {
+        sError << "The WorldJointController plugin must be inserted in a world"
+               << std::endl;
+        return;
+    }
+
+    pImpl->eventManager = &eventMgr;
+
+    // Mark the world, new control modes will not insert the model plugin
+    utils::setComponentData<
+        ignition::gazebo::components::WorldJointController>(
+        &ecm, entity, true);
+}
+
+void WorldJointController::PreUpdate(
+    const ignition::gazebo::UpdateInfo& info,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    if (info.paused || !pImpl->eventManager) {
+        return;
+    }
+
+    pImpl->removeEntities(ecm);
+
+    using namespace ignition::gazebo;
+
+    // Process all the controlled joints of the world in a single pass
+    ecm.Each<components::Joint,
+             components::JointControlMode,
+             components::ParentEntity>(
+        [&](const Entity& jointEntity,
+            components::Joint*,
+            components::JointControlMode* controlMode,
+            components::ParentEntity* parentEntity) -> bool {
+            const auto mode = controlMode->Data();
+
+            if (!(mode == core::JointControlMode::Position
+                  || mode == core::JointControlMode::Velocity)) {
+                return true;
+            }
+
+            auto& model = pImpl->getModelData(parentEntity->Data(), info, ecm);
+
+            // Models with their own JointController plugin are skipped
+            if (model.hasModelPlugin) {
+                return true;
+            }
+
+            auto* pid = utils::tryGetExistingComponentData< //
+                components::JointPID>(&ecm, jointEntity);
+
+            const std::vector<double>* reference = nullptr;
+            const std::vector<double>* current = nullptr;
+
+            if (mode == core::JointControlMode::Position) {
+                reference = utils::tryGetExistingComponentData< //
+                    components::JointPositionTarget>(&ecm, jointEntity);
+                current = utils::tryGetExistingComponentData< //
+                    components::JointPosition>(&ecm, jointEntity);
+            }
+            else {
+                reference = utils::tryGetExistingComponentData< //
+                    components::JointVelocityTarget>(&ecm, jointEntity);
+                current = utils::tryGetExistingComponentData< //
+                    components::JointVelocity>(&ecm, jointEntity);
+            }
+
+            // The state is populated by the physics after the first step
+            if (!(pid && reference && current) || current->empty()) {
+                return true;
+            }
+
+            auto joint = pImpl->getJoint(jointEntity, ecm);
+
+            if (!joint
+                || !Impl::runPIDController(*joint,
+                                           model.computeNewForce,
+                                           *pid,
+                                           info.dt,
+                                           *reference,
+                                           *current)) {
+                sError << "Failed to run PID controller of joint ["
+                       << jointEntity << "]" << std::endl;
+            }
+
+            return true;
+        });
+}
+
+void WorldJointController::Impl::removeEntities(
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    using namespace ignition::gazebo;
+
+    ecm.EachRemoved<components::Model>(
+        [&](const Entity& entity, const components::Model*) -> bool {
+            models.erase(entity);
+            return true;
+        });
+
+    ecm.EachRemoved<components::Joint>(
+        [&](const Entity& entity, const components::Joint*) -> bool {
+            joints.erase(entity);
+            return true;
+        });
+}
+
+WorldJointController::Impl::ModelData&
+WorldJointController::Impl::getModelData(
+    const ignition::gazebo::Entity modelEntity,
+    const ignition::gazebo::UpdateInfo& info,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    using namespace std::chrono;
+    auto& model = models[modelEntity];
+
+    // Update the model data only once per step
+    if (model.lastVisit == info.iterations) {
+        return model;
+    }
+
+    model.lastVisit = info.iterations;
+
+    const auto* modelPlugin = utils::tryGetExistingComponentData<
+        ignition::gazebo::components::JointController>(&ecm, modelEntity);
+    model.hasModelPlugin = modelPlugin && *modelPlugin;
+
+    const auto* period = utils::tryGetExistingComponentData<
+        ignition::gazebo::components::JointControllerPeriod>(&ecm,
+                                                             modelEntity);
+
+    // Models without period are controlled at every step
+    const double controllerPeriod =
+        period ? duration<double>(*period).count()
+               : duration<double>(info.dt).count();
+
+    // Schedule the updates in number of steps, the comparison of the elapsed
+    // time with the period would drift with the floating point errors
+    if (controllerPeriod != model.period || info.dt != model.stepSize) {
+        const auto ticks = std::llround(
+            controllerPeriod / duration<double>(info.dt).count());
+
+        model.periodTicks = static_cast<uint64_t>(std::max(ticks, 1ll));
+        model.period = controllerPeriod;
+        model.stepSize = info.dt;
+
+        // The new schedule starts from the current step
+        model.ticks = 0;
+    }
+
+    model.computeNewForce = model.ticks % model.periodTicks == 0;
+    model.ticks++;
+
+    return model;
+}
+
+std::shared_ptr<Joint> WorldJointController::Impl::getJoint(
+    const ignition::gazebo::Entity jointEntity,
+    ignition::gazebo::EntityComponentManager& ecm)
+{
+    if (auto it = joints.find(jointEntity); it != joints.end()) {
+        return it->second;
+    }
+
+    auto joint = std::make_shared<Joint>();
+
+    if (!joint->initialize(jointEntity, &ecm, eventManager)) {
+        sError << "Failed to initialize joint [" << jointEntity << "]"
+               << std::endl;
+        return nullptr;
+    }
+
+    joints[jointEntity] = joint;
+    return joint;
+}
+
+bool WorldJointController::Impl::runPIDController(
+    scenario::gazebo::Joint& joint,
+    const bool computeNewForce,
+    ignition::math::PID& pid,
+    const std::chrono::steady_clock::duration& dt,
+    const std::vector<double>& reference,
+    const std::vector<double>& current)
+{
+    switch (joint.type()) {
+
+        case core::JointType::Revolute:
+        case core::JointType::Prismatic: {
+
+            double force;
+
+            if (computeNewForce) {
+                assert(current.size() == 1);
+                assert(reference.size() == 1);
+
+                double error = current[0] - reference[0];
+                force = pid.Update(error, dt);
+            }
+            else {
+                force = pid.Cmd();
+            }
+
+            if (!joint.setGeneralizedForceTarget(force)) {
+                sError << "Failed to set force of joint " << joint.name()
+                       << std::endl;
+                return false;
+            }
+            return true;
+        }
+        case core::JointType::Fixed:
+        case core::JointType::Ball:
+        case core::JointType::Invalid:
+            sWarning << "Type of joint '" << joint.name() << " not supported"
+                     << std::endl;
+            return true;
+    }
+
+    return false;
+}
+
+IGNITION_ADD_PLUGIN(
+    scenario::plugins::gazebo::WorldJointController,
+    scenario::plugins::gazebo::WorldJointController::System,
+    scenario::plugins::gazebo::WorldJointController::ISystemConfigure,
+    scenario::plugins::gazebo::WorldJointController::ISystemPreUpdate)
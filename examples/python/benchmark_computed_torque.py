@@ -0,0 +1,80 @@
+# Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT). All rights reserved.
+# This software may be modified and distributed under the terms of the
+# GNU Lesser General Public License v2.1 or any later version.
+
+import time
+import numpy as np
+import gym_ignition_models
+from scenario import core
+from scenario import gazebo as scenario
+from gym_ignition.controllers.gazebo import computed_torque_fixed_base as context
+
+# This benchmark only measures the wall-clock cost of the control loop.
+# The absence of heap allocations in the control loop is checked by the
+# TestComputedTorqueAllocations C++ test (BUILD_TESTING=ON).
+
+# Number of simulator runs (each run performs 1 physics and control step)
+num_of_runs = 5000
+
+# Controller period, the control loop runs at 1 kHz
+step_size = 0.001
+
+
+def benchmark(with_controller: bool) -> float:
+
+    gazebo = scenario.GazeboSimulator(step_size, 1000.0, 1)
+    assert gazebo.initialize()
+
+    world = gazebo.get_world().to_gazebo()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf, core.Pose_identity(), "panda")
+
+    panda = world.get_model("panda").to_gazebo()
+    panda.enable_self_collisions(False)
+    assert panda.set_controller_period(step_size)
+
+    if with_controller:
+        controller_context = context.ComputedTorqueFixedBaseContext(
+            name="ComputedTorqueFixedBase",
+            kp=[10.0] * panda.dofs(),
+            ki=[0.0] * panda.dofs(),
+            kd=[3.0] * panda.dofs(),
+            urdf=panda_urdf,
+            joints=panda.joint_names(),
+            gravity=[0, 0, -9.81])
+
+        assert panda.insert_model_plugin(
+            "libControllerRunner.so",
+            "scenario::plugins::gazebo::ControllerRunner",
+            controller_context.to_xml())
+
+        assert panda.set_joint_position_targets([np.deg2rad(10)] * panda.dofs())
+        assert panda.set_joint_velocity_targets([0.0] * panda.dofs())
+        assert panda.set_joint_acceleration_targets([0.0] * panda.dofs())
+
+    gazebo.run(paused=True)
+
+    start = time.perf_counter()
+
+    for _ in range(num_of_runs):
+        assert gazebo.run()
+
+    elapsed = time.perf_counter() - start
+
+    gazebo.close()
+    return elapsed
+
+
+# The difference between the two runs is the cost of the control loop
+elapsed_physics = benchmark(with_controller=False)
+elapsed_controller = benchmark(with_controller=True)
+
+overhead = (elapsed_controller - elapsed_physics) / num_of_runs
+
+print(f"physics only:    {elapsed_physics:.3f}s "
+      f"({num_of_runs / elapsed_physics:.0f} steps/s)")
+print(f"with controller: {elapsed_controller:.3f}s "
+      f"({num_of_runs / elapsed_controller:.0f} steps/s)")
+print(f"controller step: {1e6 * overhead:.1f}us")
@@ -0,0 +1,48 @@
+# Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT). All rights reserved.
+# This software may be modified and distributed under the terms of the
+# GNU Lesser General Public License v2.1 or any later version.
+
+import time
+import gym_ignition_models
+from scenario import core
+from scenario import gazebo as scenario
+
+# Number of robots inserted in the world
+num_of_robots = 32
+
+# Number of simulator runs (each run performs 10 physics steps)
+num_of_runs = 100
+
+
+def benchmark(num_of_threads: int) -> float:
+
+    gazebo = scenario.GazeboSimulator(0.001, 1000.0, 10)
+    assert gazebo.initialize()
+
+    world = gazebo.get_world().to_gazebo()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+    assert world.set_physics_threads(num_of_threads)
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+
+    for idx in range(num_of_robots):
+        pose = core.Pose([2.0 * (idx % 8), 2.0 * (idx // 8), 0], [1., 0, 0, 0])
+        assert world.insert_model(panda_urdf, pose, f"panda{idx}")
+
+    gazebo.run(paused=True)
+
+    start = time.perf_counter()
+
+    for _ in range(num_of_runs):
+        assert gazebo.run()
+
+    elapsed = time.perf_counter() - start
+
+    gazebo.close()
+    return elapsed
+
+
+for num_of_threads in [1, 2, 4, 8]:
+    elapsed = benchmark(num_of_threads=num_of_threads)
+    print(f"threads={num_of_threads}: {elapsed:.3f}s "
+          f"({num_of_runs * 10 / elapsed:.0f} steps/s)")
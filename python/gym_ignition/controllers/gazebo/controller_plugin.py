@@ -0,0 +1,97 @@
+# Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT). All rights reserved.
+# This software may be modified and distributed under the terms of the
+# GNU Lesser General Public License v2.1 or any later version.
+
+from typing import Dict, List, NamedTuple, Optional, Union
+
+ParameterValue = Union[str, float, List[str], List[float]]
+
+
+class ControllerPluginContext(NamedTuple):
+    """
+    Context of a controller loaded by the ControllerRunner plugin.
+
+    The controller is selected by name from the controllers registered in the
+    factory. Controllers not shipped with scenario are loaded from the shared
+    library passed as filename, that is searched in the folders of the
+    IGN_GAZEBO_SYSTEM_PLUGIN_PATH environment variable.
+
+    The optional period (in seconds) defaults to the controller period of the
+    model. The optional input is the name of a previous controller of the same
+    model whose output is used as joint references.
+    """
+
+    name: str
+    parameters: Dict[str, ParameterValue]
+    filename: Optional[str] = None
+    period: Optional[float] = None
+    input: Optional[str] = None
+
+    def to_element(self) -> str:
+
+        attributes = f'name="{self.name}"'
+
+        if self.filename is not None:
+            attributes += f' filename="{self.filename}"'
+
+        if self.period is not None:
+            attributes += f' period="{self.period}"'
+
+        if self.input is not None:
+            attributes += f' input="{self.input}"'
+
+        elements = ""
+
+        for key, value in self.parameters.items():
+            elements += f"<{key}>{self._to_str(value)}</{key}>\n"
+
+        return f"<controller {attributes}>\n{elements}</controller>\n"
+
+    def to_xml(self) -> str:
+
+        xml = f"""
+        <sdf version='1.7'>
+            {self.to_element()}
+        </sdf>
+        """
+
+        return xml
+
+    @staticmethod
+    def _to_str(value: ParameterValue) -> str:
+
+        if isinstance(value, (list, tuple)):
+            return " ".join(str(element) for element in value)
+
+        return str(value)
+
+
+def to_world_xml(models: Dict[str, List[ControllerPluginContext]],
+                 threads: int = 0) -> str:
+    """
+    Create the context of the ControllerRunner plugin inserted in a world.
+
+    Args:
+        models: The controllers of each model, indexed by the model name.
+        threads: The number of threads used to run the controllers of
+            different models. If zero, the hardware concurrency is used.
+
+    Returns:
+        The context of the plugin.
+    """
+
+    elements = ""
+
+    for model_name, controllers in models.items():
+        elements += f'<model name="{model_name}">\n'
+        elements += "".join(c.to_element() for c in controllers)
+        elements += "</model>\n"
+
+    xml = f"""
+    <sdf version='1.7'>
+        <threads>{threads}</threads>
+        {elements}
+    </sdf>
+    """
+
+    return xml
@@ -8,4 +8,5 @@ from .typing import *
 from . import logger
 from . import scenario
 from . import resource_finder
+from . import kindyn_cache
 from . import inverse_kinematics_nlp
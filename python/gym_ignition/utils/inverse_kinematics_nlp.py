@@ -6,6 +6,7 @@ import os
 import numpy as np
 from enum import Enum, auto
 from typing import List, Dict, Optional, Union, NamedTuple
+from gym_ignition.utils.kindyn_cache import KinDynCache
 
 
 class TargetType(Enum):
@@ -69,7 +70,20 @@ class TargetResolutionMode(Enum):
 
 class InverseKinematicsNLP:
 
-    def __init__(self, urdf_filename: str, considered_joints: List[str] = None) -> None:
+    def __init__(self,
+                 urdf_filename: str,
+                 considered_joints: List[str] = None,
+                 kindyn_cache: KinDynCache = None) -> None:
+        """
+        Args:
+            urdf_filename: The URDF file describing the model.
+            considered_joints: The joints optimized by the IK. All the joints of the
+                model are considered if not specified.
+            kindyn_cache: The optional cache of the simulated model, obtained with
+                :py:func:`~gym_ignition.utils.kindyn_cache.get_kindyn_cache`. It
+                provides the iDynTree model, that is not loaded again from the
+                URDF file, and the state used by :py:meth:`warm_start_from_model`.
+        """
 
         import iDynTree
 
@@ -78,6 +92,11 @@ class InverseKinematicsNLP:
         self._targets_data: Dict[str, TargetData] = dict()
         self._ik: Optional[iDynTree.InverseKinematics] = None
         self._considered_joints: List[str] = considered_joints
+        self._kindyn_cache: Optional[KinDynCache] = kindyn_cache
+
+        if kindyn_cache is not None and considered_joints is not None and \
+                considered_joints != kindyn_cache.joint_names():
+            raise ValueError("The considered joints do not match the joints of the cache")
 
     # ======================
     # INITIALIZATION METHODS
@@ -100,12 +119,16 @@ class InverseKinematicsNLP:
         # Create the IK object
         self._ik = iDynTree.InverseKinematics()
 
-        # Load the iDynTree model and get the loader
-        model_loader: iDynTree.ModelLoader = self._get_model_loader(
-            urdf=self._urdf_filename, considered_joints=self._considered_joints)
+        if self._kindyn_cache is not None:
+            # Share the model already loaded by the cache
+            model = self._kindyn_cache.idyntree_model()
+        else:
+            # Load the iDynTree model and get the loader
+            model_loader: iDynTree.ModelLoader = self._get_model_loader(
+                urdf=self._urdf_filename, considered_joints=self._considered_joints)
 
-        # Get the model
-        model = model_loader.model()
+            # Get the model
+            model = model_loader.model()
 
         # If all joints are enabled, get the list of joint names in order to know the
         # serialization of the IK solution
@@ -364,6 +387,20 @@ class InverseKinematicsNLP:
         if not ok_init:
             raise RuntimeError("Failed to warm start the IK solver")
 
+    def warm_start_from_model(self) -> None:
+
+        if self._kindyn_cache is None:
+            raise RuntimeError("The IK was not created with a kinematics cache")
+
+        # The cache is already updated if other consumers read the same state
+        base_position, base_quaternion = \
+            self._kindyn_cache.frame_pose(frame_name=self._base_frame)
+
+        self.warm_start_from(IKSolution(
+            joint_configuration=self._kindyn_cache.joint_positions(),
+            base_position=base_position,
+            base_quaternion=base_quaternion))
+
     # =======
     # GETTERS
     # =======
@@ -0,0 +1,345 @@
+# Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT). All rights reserved.
+# This software may be modified and distributed under the terms of the
+# GNU Lesser General Public License v2.1 or any later version.
+
+import os
+import numpy as np
+from scenario import core
+from typing import Callable, Dict, List, Optional, Tuple
+
+
+class KinDynCache:
+    """
+    Kinematics and dynamics quantities of a model memoized until its state changes.
+
+    At every request the state of the model (joint positions and velocities, base
+    pose and velocity) is compared with the state stored in the iDynTree
+    KinDynComputations object, that is updated only if they differ. All the
+    quantities are computed lazily on their first request and they are memoized
+    until the state of the model changes, either because the simulator ran or
+    because the model was reset.
+
+    The floating base is the base frame of the model. The velocities, the mass
+    matrix and the Jacobians use the mixed representation.
+
+    Note:
+        This is a utility for Python code that computes multiple quantities of the
+        same model, e.g. a task and a controller. Use :py:func:`get_kindyn_cache` to
+        share the same cache between the consumers of the same model.
+    """
+
+    def __init__(self,
+                 model: core.Model,
+                 urdf: str,
+                 considered_joints: List[str] = None) -> None:
+
+        # Lazy import iDynTree
+        import iDynTree
+
+        if not os.path.exists(urdf):
+            raise FileNotFoundError(urdf)
+
+        self._model = model
+
+        # Get the model loader
+        model_loader = iDynTree.ModelLoader()
+
+        # Load the model
+        if considered_joints:
+            ok_load = model_loader.loadReducedModelFromFile(urdf, considered_joints)
+        else:
+            ok_load = model_loader.loadModelFromFile(urdf)
+
+        if not ok_load:
+            raise RuntimeError("Failed to load model")
+
+        self._kindyn = iDynTree.KinDynComputations()
+
+        if not self._kindyn.loadRobotModel(model_loader.model()):
+            raise RuntimeError("Failed to load the model in KinDynComputations")
+
+        self._kindyn.setFrameVelocityRepresentation(iDynTree.MIXED_REPRESENTATION)
+
+        # The base state read from the model refers to its base frame
+        if not self._kindyn.setFloatingBase(model.base_frame()):
+            raise RuntimeError(f"Failed to set the floating base '{model.base_frame()}'")
+
+        # Store the joint serialization of the iDynTree model
+        self._joint_names = [self._kindyn.model().getJointName(i)
+                             for i in range(self._kindyn.model().getNrOfJoints())]
+
+        for name in self._joint_names:
+            if name not in model.joint_names():
+                raise ValueError(f"Joint '{name}' not found in model '{model.name()}'")
+
+        # Buffers allocated once and reused at every update
+        self._dofs = len(self._joint_names)
+        self._s = iDynTree.VectorDynSize(self._dofs)
+        self._s_dot = iDynTree.VectorDynSize(self._dofs)
+        self._base_linear_velocity = iDynTree.LinVelocity()
+        self._base_angular_velocity = iDynTree.AngVelocity()
+        self._gravity = iDynTree.Vector3()
+
+        # State of the model stored in KinDynComputations
+        self._state: Optional[np.ndarray] = None
+        self._memo: Dict[Tuple, np.ndarray] = dict()
+
+        self.set_gravity(np.array([0, 0, -9.81]))
+
+    def dofs(self) -> int:
+        return self._dofs
+
+    def joint_names(self) -> List[str]:
+        return list(self._joint_names)
+
+    def idyntree_model(self):
+        """
+        Get the iDynTree model loaded by the cache.
+
+        Returns:
+            The iDynTree model with the joints of the cache.
+        """
+
+        return self._kindyn.model()
+
+    def joint_positions(self) -> np.ndarray:
+        """
+        Get the joint positions of the model serialized as :py:meth:`joint_names`.
+
+        Returns:
+            The joint positions stored in KinDynComputations.
+        """
+
+        return self._get(("joint_positions",), lambda: self._s.toNumPy().copy())
+
+    def set_gravity(self, gravity: np.ndarray) -> None:
+
+        if gravity.size != 3:
+            raise ValueError("The gravity must have 3 elements")
+
+        for i in range(3):
+            self._gravity.setVal(i, gravity[i])
+
+        self.invalidate()
+
+    def invalidate(self) -> None:
+        """
+        Force the update of the state at the next request.
+        """
+
+        self._state = None
+        self._memo.clear()
+
+    def mass_matrix(self) -> np.ndarray:
+        """
+        Get the free-floating mass matrix of the model.
+
+        Returns:
+            The (6+dofs)x(6+dofs) mass matrix.
+        """
+
+        def compute() -> np.ndarray:
+            import iDynTree
+            M = iDynTree.MatrixDynSize(6 + self._dofs, 6 + self._dofs)
+
+            if not self._kindyn.getFreeFloatingMassMatrix(M):
+                raise RuntimeError("Failed to compute the mass matrix")
+
+            return M.toNumPy()
+
+        return self._get(("mass_matrix",), compute)
+
+    def bias_forces(self) -> np.ndarray:
+        """
+        Get the free-floating bias forces of the model.
+
+        Returns:
+            The (6+dofs) vector of Coriolis, centrifugal and gravity forces.
+        """
+
+        def compute() -> np.ndarray:
+            import iDynTree
+            h = iDynTree.FreeFloatingGeneralizedTorques(self._kindyn.model())
+
+            if not self._kindyn.generalizedBiasForces(h):
+                raise RuntimeError("Failed to compute the bias forces")
+
+            return np.concatenate((h.baseWrench().toNumPy(),
+                                   h.jointTorques().toNumPy()))
+
+        return self._get(("bias_forces",), compute)
+
+    def jacobian(self, frame_name: str) -> np.ndarray:
+        """
+        Get the free-floating Jacobian of a frame.
+
+        Args:
+            frame_name: The name of the frame.
+
+        Returns:
+            The 6x(6+dofs) Jacobian of the frame.
+        """
+
+        def compute() -> np.ndarray:
+            import iDynTree
+            J = iDynTree.MatrixDynSize(6, 6 + self._dofs)
+
+            if not self._kindyn.getFrameFreeFloatingJacobian(frame_name, J):
+                raise RuntimeError(f"Failed to compute the Jacobian of '{frame_name}'")
+
+            return J.toNumPy()
+
+        return self._get(("jacobian", frame_name), compute)
+
+    def frame_pose(self, frame_name: str) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Get the pose of a frame in the world frame.
+
+        Args:
+            frame_name: The name of the frame.
+
+        Returns:
+            A tuple with the position and the quaternion (wxyz) of the frame.
+        """
+
+        if self._kindyn.getFrameIndex(frame_name) < 0:
+            raise ValueError(f"Frame '{frame_name}' not found")
+
+        def compute() -> np.ndarray:
+            H = self._kindyn.getWorldTransform(frame_name)
+            return np.concatenate((H.getPosition().toNumPy(),
+                                   H.getRotation().asQuaternion().toNumPy()))
+
+        pose = self._get(("frame_pose", frame_name), compute)
+        return pose[0:3], pose[3:7]
+
+    # ===============
+    # PRIVATE METHODS
+    # ===============
+
+    def _get(self, key: Tuple, compute: Callable[[], np.ndarray]) -> np.ndarray:
+
+        self._update_state()
+
+        if key not in self._memo:
+            self._memo[key] = compute()
+            self._memo[key].setflags(write=False)
+
+        return self._memo[key]
+
+    def _update_state(self) -> None:
+
+        s = self._model.joint_positions(self._joint_names)
+        s_dot = self._model.joint_velocities(self._joint_names)
+        position = self._model.base_position()
+        quaternion = self._model.base_orientation()
+        linear = self._model.base_world_linear_velocity()
+        angular = self._model.base_world_angular_velocity()
+
+        state = np.concatenate((s, s_dot, position, quaternion, linear, angular))
+
+        if self._state is not None and np.array_equal(self._state, state):
+            return
+
+        import iDynTree
+
+        for i in range(self._dofs):
+            self._s.setVal(i, s[i])
+            self._s_dot.setVal(i, s_dot[i])
+
+        p = iDynTree.Position()
+        for i in range(3):
+            p.setVal(i, position[i])
+
+        quat = iDynTree.Vector4()
+        for i in range(4):
+            quat.setVal(i, quaternion[i])
+
+        R = iDynTree.Rotation()
+        R.fromQuaternion(quat)
+
+        world_H_base = iDynTree.Transform()
+        world_H_base.setPosition(p)
+        world_H_base.setRotation(R)
+
+        for i in range(3):
+            self._base_linear_velocity.setVal(i, linear[i])
+            self._base_angular_velocity.setVal(i, angular[i])
+
+        base_velocity = iDynTree.Twist(self._base_linear_velocity,
+                                       self._base_angular_velocity)
+
+        if not self._kindyn.setRobotState(world_H_base, self._s,
+                                          base_velocity, self._s_dot,
+                                          self._gravity):
+            raise RuntimeError("Failed to set the state of KinDynComputations")
+
+        self._memo.clear()
+        self._state = state
+
+
+# Caches shared between the consumers of the same model. World names are unique
+# within the process and the entity of a model changes when it is removed and
+# inserted again, therefore they identify the model independently of the Python
+# objects returned by the bindings.
+_caches: Dict[Tuple[str, str, int, str], KinDynCache] = dict()
+
+
+def get_kindyn_cache(world: core.World, model_name: str, urdf: str) -> KinDynCache:
+    """
+    Get the kinematics and dynamics cache of a model.
+
+    The cache is created the first time it is requested and it is shared by all the
+    following calls with the same model and urdf file. The caches of the models
+    removed from the world are released.
+
+    Args:
+        world: The world containing the model.
+        model_name: The name of the model.
+        urdf: The URDF file describing the model.
+
+    Returns:
+        The cache of the model.
+    """
+
+    if model_name not in world.model_names():
+        raise ValueError(f"Model '{model_name}' not found in world '{world.name()}'")
+
+    _remove_stale_caches(world=world)
+
+    model = world.get_model(model_name).to_gazebo()
+    key = (world.name(), model_name, model.entity(), urdf)
+
+    if key not in _caches:
+        _caches[key] = KinDynCache(model=model, urdf=urdf)
+
+    # Read the state from the newest model object. The objects of a world that was
+    # closed must not be used even if a new world with the same name replaced it.
+    _caches[key]._model = model
+
+    return _caches[key]
+
+
+def remove_kindyn_cache(world: core.World, model_name: str) -> None:
+    """
+    Release the kinematics and dynamics caches of a model, e.g. before its removal.
+    """
+
+    for key in [k for k in _caches if k[0:2] == (world.name(), model_name)]:
+        del _caches[key]
+
+
+def _remove_stale_caches(world: core.World) -> None:
+
+    model_names = world.model_names()
+    entities: Dict[str, int] = dict()
+
+    for key in [k for k in _caches if k[0] == world.name()]:
+
+        _, model_name, entity, _ = key
+
+        if model_name in model_names and model_name not in entities:
+            entities[model_name] = world.get_model(model_name).to_gazebo().entity()
+
+        if entities.get(model_name) != entity:
+            del _caches[key]
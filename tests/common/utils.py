@@ -2,6 +2,7 @@
 # This software may be modified and distributed under the terms of the
 # GNU Lesser General Public License v2.1 or any later version.
 
+import os
 import pytest
 from typing import Tuple
 import gym_ignition_models
@@ -140,3 +141,21 @@ def get_empty_world_sdf() -> str:
 
     world_file = misc.string_to_file(world_sdf_string)
     return world_file
+
+
+def require_test_controllers() -> None:
+    """
+    Skip the calling test if the library of the test controllers is not found.
+
+    The library is built only with the C++ tests enabled (BUILD_TESTING=ON) and it
+    is not installed. The <build>/tests/plugins folder of the build tree must be
+    added to the IGN_GAZEBO_SYSTEM_PLUGIN_PATH environment variable.
+    """
+
+    plugin_path = os.environ.get("IGN_GAZEBO_SYSTEM_PLUGIN_PATH", "")
+
+    for folder in plugin_path.split(os.pathsep):
+        if folder and os.path.isfile(os.path.join(folder, "libTestControllers.so")):
+            return
+
+    pytest.skip("libTestControllers.so not found in IGN_GAZEBO_SYSTEM_PLUGIN_PATH")
@@ -0,0 +1,101 @@
+# Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT). All rights reserved.
+# This software may be modified and distributed under the terms of the
+# GNU Lesser General Public License v2.1 or any later version.
+
+import pytest
+pytestmark = pytest.mark.gym_ignition
+
+import numpy as np
+from typing import Tuple
+import gym_ignition_models
+from scenario import core
+from scenario import gazebo as scenario
+from gym_ignition.utils import kindyn_cache
+from gym_ignition.utils.inverse_kinematics_nlp import InverseKinematicsNLP
+from ..common.utils import default_world_fixture as default_world
+
+
+@pytest.mark.parametrize("default_world", [(1.0 / 1_000, 1.0, 1)], indirect=True)
+def test_kindyn_cache(default_world: Tuple[scenario.GazeboSimulator, scenario.World]):
+
+    pytest.importorskip("iDynTree")
+
+    # Get the simulator and the world
+    gazebo, world = default_world
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf, core.Pose_identity(), "panda")
+    panda = world.get_model("panda")
+
+    assert gazebo.run(paused=True)
+
+    # Consumers of the same model share the same cache, also if they got different
+    # model objects from the world
+    cache = kindyn_cache.get_kindyn_cache(world=world, model_name="panda",
+                                          urdf=panda_urdf)
+    assert cache is kindyn_cache.get_kindyn_cache(world=world, model_name="panda",
+                                                  urdf=panda_urdf)
+    assert cache.dofs() == panda.dofs()
+
+    M = cache.mass_matrix()
+    h = cache.bias_forces()
+    J = cache.jacobian("panda_hand")
+    position, quaternion = cache.frame_pose("panda_hand")
+
+    assert M.shape == (6 + panda.dofs(), 6 + panda.dofs())
+    assert h.shape == (6 + panda.dofs(),)
+    assert J.shape == (6, 6 + panda.dofs())
+    assert np.allclose(M, M.T)
+    assert quaternion.size == 4
+
+    link_position = panda.get_link("panda_hand").position()
+    assert position == pytest.approx(link_position, abs=1e-6)
+
+    # The quantities are memoized within the same step
+    assert cache.mass_matrix() is M
+    assert cache.jacobian("panda_hand") is J
+
+    # Reset the robot without changing the simulated time
+    time = world.time()
+    assert panda.to_gazebo().reset_joint_positions([0.5] * panda.dofs())
+    assert gazebo.run(paused=True)
+    assert world.time() == time
+
+    # The quantities are computed again with the new state
+    assert cache.mass_matrix() is not M
+    assert not np.allclose(cache.mass_matrix(), M)
+
+    _, new_quaternion = cache.frame_pose("panda_hand")
+    assert not np.allclose(new_quaternion, quaternion)
+
+    with pytest.raises(ValueError):
+        cache.frame_pose("not_existing_frame")
+
+    # The IK shares the model and the state of the cache
+    ik = InverseKinematicsNLP(urdf_filename=panda_urdf, kindyn_cache=cache)
+    ik.initialize(verbosity=0)
+    ik.warm_start_from_model()
+    assert ik.get_solution().joint_configuration == \
+        pytest.approx(panda.joint_positions(cache.joint_names()))
+
+    kindyn_cache.remove_kindyn_cache(world=world, model_name="panda")
+    new_cache = kindyn_cache.get_kindyn_cache(world=world, model_name="panda",
+                                              urdf=panda_urdf)
+    assert new_cache is not cache
+    cache = new_cache
+
+    # The cache of a removed model is released, also if a model with the same name
+    # is inserted again
+    assert world.remove_model("panda")
+    assert gazebo.run(paused=True)
+    assert world.insert_model(panda_urdf, core.Pose_identity(), "panda")
+    assert gazebo.run(paused=True)
+
+    new_cache = kindyn_cache.get_kindyn_cache(world=world, model_name="panda",
+                                              urdf=panda_urdf)
+    assert new_cache is not cache
+    assert new_cache.mass_matrix().shape == M.shape
+
+    with pytest.raises(ValueError):
+        kindyn_cache.get_kindyn_cache(world=world, model_name="not_existing_model",
+                                      urdf=panda_urdf)
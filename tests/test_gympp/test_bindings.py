@@ -118,6 +118,31 @@ def test_box_space():
         assert box.contains(sample)
 
 
+def test_box_space_multidimensional():
+
+    shape = [2, 3]
+    low = bindings.VectorD([-float(i) for i in range(6)])
+    high = bindings.VectorD([float(i) for i in range(6)])
+    box = bindings.Box(low, high, shape)
+
+    assert list(box.shape()) == shape
+    assert list(box.strides()) == [3, 1]
+    assert box.size() == 6
+    assert list(box.low()) == list(low)
+    assert list(box.high()) == list(high)
+
+    assert box.contains(bindings.Sample(bindings.VectorD([0] * 6)))
+    assert not box.contains(bindings.Sample(bindings.VectorD([0, 2, 0, 0, 0, 0])))
+    assert not box.contains(bindings.Sample(bindings.VectorD([0] * 3)))
+
+    for n in range(50):
+
+        sample = box.sample()
+
+        assert sample.get_buffer_d().size() == 6
+        assert box.contains(sample)
+
+
 def test_space_box_metadata(create_space_box_md):
 
     md = create_space_box_md
@@ -224,3 +224,53 @@ def test_cube_multiple_contacts(gazebo: scenario.GazeboSimulator,
             for point in contact.points:
                 assert point.force[2] > 0
                 assert point.normal == pytest.approx([0, 0, 1], abs=0.001)
+
+
+@pytest.mark.parametrize("gazebo, same_group",
+                         [((0.001, 1.0, 1), True),
+                          ((0.001, 1.0, 1), False)],
+                         indirect=["gazebo"],
+                         ids=utils.id_gazebo_fn)
+def test_collision_bitmask(gazebo: scenario.GazeboSimulator, same_group: bool):
+
+    assert gazebo.initialize()
+    world = gazebo.get_world().to_gazebo()
+
+    # Insert the Physics system
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    # Insert the ground plane
+    assert world.insert_model(gym_ignition_models.get_model_file("ground_plane"))
+
+    # Insert a cube resting on the ground and another cube above it
+    cube_urdf = utils.get_cube_urdf()
+    assert world.insert_model(cube_urdf,
+                              core.Pose([0, 0, 0.101], [1., 0, 0, 0]),
+                              "cube1")
+    assert world.insert_model(cube_urdf,
+                              core.Pose([0, 0, 0.5], [1., 0, 0, 0]),
+                              "cube2")
+
+    cube1 = world.get_model("cube1").to_gazebo()
+    cube2 = world.get_model("cube2").to_gazebo()
+
+    assert cube1.collision_bitmask() == 0xFFFF
+
+    # The bitmasks must be set before the collisions are created by the physics
+    assert cube1.set_collision_bitmask(0x0001)
+    assert cube2.set_collision_bitmask(0x0001 if same_group else 0x0002)
+    assert cube1.collision_bitmask() == 0x0001
+
+    # Make the cubes fall for 1s
+    for _ in range(1000):
+        gazebo.run()
+
+    # Both cubes collide with the ground plane
+    assert cube1.base_position()[2] == pytest.approx(0.1, abs=0.01)
+
+    if same_group:
+        # The second cube rests on the first one
+        assert cube2.base_position()[2] == pytest.approx(0.3, abs=0.01)
+    else:
+        # The second cube goes through the first one
+        assert cube2.base_position()[2] == pytest.approx(0.1, abs=0.01)
@@ -9,9 +9,11 @@ import numpy as np
 from scenario import core
 import gym_ignition_models
 from ..common import utils
+from gym_ignition.utils import misc
 from scenario import gazebo as scenario
 from ..common.utils import gazebo_fixture as gazebo
 from gym_ignition.controllers.gazebo import computed_torque_fixed_base as context
+from gym_ignition.controllers.gazebo import controller_plugin
 
 # Set the verbosity
 scenario.set_verbosity(scenario.Verbosity_debug)
@@ -107,3 +109,373 @@ def test_computed_torque_fixed_base(gazebo: scenario.GazeboSimulator):
                                                     abs=np.deg2rad(1))
     assert panda.joint_velocities() == pytest.approx(panda.joint_velocity_targets(),
                                                      abs=0.05)
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 5.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_controller_plugin_context(gazebo: scenario.GazeboSimulator):
+
+    assert gazebo.initialize()
+    step_size = gazebo.step_size()
+
+    world = gazebo.get_world()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf, core.Pose_identity(), "panda")
+
+    panda: scenario.Model = world.get_model("panda").to_gazebo()
+    panda.enable_self_collisions(False)
+    panda.set_controller_period(step_size)
+
+    # Create the generic context of the controller registered in the factory
+    controller_context = controller_plugin.ControllerPluginContext(
+        name="ComputedTorqueFixedBase",
+        parameters=dict(kp=[10.0] * panda.dofs(),
+                        kd=[3.0] * panda.dofs(),
+                        urdf=panda_urdf,
+                        joints=panda.joint_names(),
+                        gravity=[0, 0, -9.81]))
+
+    assert panda.insert_model_plugin("libControllerRunner.so",
+                                     "scenario::plugins::gazebo::ControllerRunner",
+                                     controller_context.to_xml())
+
+    assert panda.set_joint_position_targets([0.0] * panda.dofs())
+    assert panda.set_joint_velocity_targets([0.0] * panda.dofs())
+    assert panda.set_joint_acceleration_targets([0.0] * panda.dofs())
+
+    for _ in range(3000):
+        assert gazebo.run()
+
+    # The controller created by the registry tracks the references
+    assert panda.joint_positions() == pytest.approx(panda.joint_position_targets(),
+                                                    abs=np.deg2rad(1))
+
+    # Changing the references updates their version, and the controller
+    # copies the new references
+    joints_no_fingers = [j for j in panda.joint_names() if j.startswith("panda_joint")]
+    q_ref = [np.deg2rad(10)] * len(joints_no_fingers)
+    assert panda.set_joint_position_targets(q_ref, joints_no_fingers)
+
+    for _ in range(3000):
+        assert gazebo.run()
+
+    assert panda.joint_positions(joints_no_fingers) == pytest.approx(q_ref,
+                                                                     abs=np.deg2rad(1))
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 5.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_controller_scheduler_world(gazebo: scenario.GazeboSimulator):
+
+    assert gazebo.initialize()
+
+    world = gazebo.get_world().to_gazebo()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    model_names = [f"panda{idx}" for idx in range(2)]
+
+    for idx, name in enumerate(model_names):
+        pose = core.Pose([0, 2.0 * idx, 0], [1., 0, 0, 0])
+        assert world.insert_model(panda_urdf, pose, name)
+
+    contexts = {}
+
+    for name in model_names:
+        panda = world.get_model(name).to_gazebo()
+        panda.enable_self_collisions(False)
+
+        # The controller runs every two physics steps
+        contexts[name] = [controller_plugin.ControllerPluginContext(
+            name="ComputedTorqueFixedBase",
+            period=2 * gazebo.step_size(),
+            parameters=dict(kp=[10.0] * panda.dofs(),
+                            kd=[3.0] * panda.dofs(),
+                            urdf=panda_urdf,
+                            joints=panda.joint_names(),
+                            gravity=[0, 0, -9.81]))]
+
+        assert panda.set_joint_position_targets([0.0] * panda.dofs())
+        assert panda.set_joint_velocity_targets([0.0] * panda.dofs())
+        assert panda.set_joint_acceleration_targets([0.0] * panda.dofs())
+
+    # A single world plugin runs the controllers of all the models
+    assert world.insert_world_plugin(
+        "libControllerRunner.so",
+        "scenario::plugins::gazebo::ControllerRunner",
+        controller_plugin.to_world_xml(models=contexts, threads=2))
+
+    for _ in range(3000):
+        assert gazebo.run()
+
+    for name in model_names:
+        panda = world.get_model(name)
+        assert panda.joint_positions() == \
+            pytest.approx(panda.joint_position_targets(), abs=np.deg2rad(1))
+
+
+def get_floating_arm_urdf_string() -> str:
+
+    def link(name: str, mass: float, length: float) -> str:
+        i = 1 / 12 * mass * length ** 2
+        return f"""
+        <link name="{name}">
+            <inertial>
+              <origin rpy="0 0 0" xyz="0 0 {length / 2}"/>
+              <mass value="{mass}"/>
+              <inertia ixx="{i}" ixy="0" ixz="0" iyy="{i}" iyz="0" izz="0.01"/>
+            </inertial>
+        </link>"""
+
+    def joint(name: str, parent: str, child: str, z: float) -> str:
+        return f"""
+        <joint name="{name}" type="revolute">
+            <parent link="{parent}"/>
+            <child link="{child}"/>
+            <origin rpy="0 0 0" xyz="0 0 {z}"/>
+            <axis xyz="0 1 0"/>
+            <limit effort="1000" lower="-3.14" upper="3.14" velocity="100"/>
+        </joint>"""
+
+    # A two-link arm attached to a free-floating base, without collisions
+    return f"""
+    <robot name="floating_arm">
+        {link("base", 5.0, 0.2)}
+        {link("link1", 1.0, 0.5)}
+        {link("link2", 1.0, 0.5)}
+        {joint("joint1", "base", "link1", 0.2)}
+        {joint("joint2", "link1", "link2", 0.5)}
+    </robot>"""
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 5.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_computed_torque_floating_base(gazebo: scenario.GazeboSimulator):
+
+    assert gazebo.initialize()
+    step_size = gazebo.step_size()
+
+    world = gazebo.get_world()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    # The model falls freely during the test, and its base is accelerated
+    # by the motion of the arm
+    urdf = misc.string_to_file(get_floating_arm_urdf_string())
+    assert world.insert_model(urdf, core.Pose([0, 0, 20.0], [1., 0, 0, 0]),
+                              "floating_arm")
+
+    model: scenario.Model = world.get_model("floating_arm").to_gazebo()
+    assert model.set_controller_period(step_size)
+
+    controller_context = controller_plugin.ControllerPluginContext(
+        name="ComputedTorqueFloatingBase",
+        parameters=dict(kp=[100.0] * model.dofs(),
+                        kd=[20.0] * model.dofs(),
+                        urdf=urdf,
+                        joints=model.joint_names(),
+                        gravity=[0, 0, -9.81]))
+
+    assert model.insert_model_plugin("libControllerRunner.so",
+                                     "scenario::plugins::gazebo::ControllerRunner",
+                                     controller_context.to_xml())
+
+    q_ref = [0.3, -0.5]
+    assert model.set_joint_position_targets(q_ref)
+    assert model.set_joint_velocity_targets([0.0] * model.dofs())
+    assert model.set_joint_acceleration_targets([0.0] * model.dofs())
+
+    for _ in range(1500):
+        assert gazebo.run()
+
+    # The joints track the references while the base is floating
+    assert model.base_position()[2] < 15.0
+    assert model.joint_positions() == pytest.approx(q_ref, abs=np.deg2rad(1))
+    assert model.joint_velocities() == pytest.approx([0.0] * model.dofs(),
+                                                     abs=0.05)
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_controller_plugin_library(gazebo: scenario.GazeboSimulator):
+
+    utils.require_test_controllers()
+    assert gazebo.initialize()
+
+    world = gazebo.get_world()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf, core.Pose_identity(), "panda")
+
+    panda: scenario.Model = world.get_model("panda").to_gazebo()
+    panda.enable_self_collisions(False)
+    assert panda.set_controller_period(gazebo.step_size())
+
+    joint_names = ["panda_joint1", "panda_joint2"]
+
+    # The controller is not registered in the factory, it is loaded from
+    # the test library found in the build tree
+    controller_context = controller_plugin.ControllerPluginContext(
+        name="ConstantForceController",
+        filename="libTestControllers.so",
+        parameters=dict(joints=joint_names, force=1.5))
+
+    assert panda.insert_model_plugin("libControllerRunner.so",
+                                     "scenario::plugins::gazebo::ControllerRunner",
+                                     controller_context.to_xml())
+
+    assert gazebo.run()
+
+    for name in joint_names:
+        joint = panda.get_joint(name)
+        assert joint.control_mode() == core.JointControlMode_force
+        assert joint.generalized_force_target() == pytest.approx(1.5)
+
+    # A second runner reuses the library already loaded by the factory
+    assert world.insert_model(panda_urdf, core.Pose([0, 1.0, 0], [1., 0, 0, 0]),
+                              "panda2")
+    panda2 = world.get_model("panda2").to_gazebo()
+    assert panda2.set_controller_period(gazebo.step_size())
+
+    assert panda2.insert_model_plugin("libControllerRunner.so",
+                                      "scenario::plugins::gazebo::ControllerRunner",
+                                      controller_context.to_xml())
+
+    assert gazebo.run()
+
+    for name in joint_names:
+        assert panda2.get_joint(name).generalized_force_target() == \
+            pytest.approx(1.5)
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_controller_period_after_step_size_change(
+        gazebo: scenario.GazeboSimulator):
+
+    utils.require_test_controllers()
+    assert gazebo.initialize()
+
+    world = gazebo.get_world()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf, core.Pose_identity(), "panda")
+
+    panda: scenario.Model = world.get_model("panda").to_gazebo()
+    panda.enable_self_collisions(False)
+    assert panda.set_controller_period(0.004)
+
+    # The probe applies a force equal to the time elapsed between the
+    # updates of its state, performed with the period of the controller
+    controller_context = controller_plugin.ControllerPluginContext(
+        name="PeriodProbeController",
+        filename="libTestControllers.so",
+        parameters=dict(joint="panda_joint1"))
+
+    assert panda.insert_model_plugin("libControllerRunner.so",
+                                     "scenario::plugins::gazebo::ControllerRunner",
+                                     controller_context.to_xml())
+
+    joint = panda.get_joint("panda_joint1")
+
+    for _ in range(100):
+        assert gazebo.run()
+
+    assert joint.generalized_force_target() == pytest.approx(0.004)
+
+    # The controller runs every 2 steps after the step size changes
+    assert gazebo.set_step_size(0.002)
+
+    for _ in range(100):
+        assert gazebo.run()
+
+    assert joint.generalized_force_target() == pytest.approx(0.004)
+
+    # The controller runs every 4 steps after the model period changes
+    assert panda.set_controller_period(0.008)
+
+    for _ in range(100):
+        assert gazebo.run()
+
+    assert joint.generalized_force_target() == pytest.approx(0.008)
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_references_version(gazebo: scenario.GazeboSimulator):
+
+    utils.require_test_controllers()
+    assert gazebo.initialize()
+
+    world = gazebo.get_world()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf, core.Pose_identity(), "panda")
+
+    panda: scenario.Model = world.get_model("panda").to_gazebo()
+    panda.enable_self_collisions(False)
+    assert panda.set_controller_period(gazebo.step_size())
+
+    # The probe applies the number of reads of its references and the
+    # number of its steps as forces of two other joints
+    controller_context = controller_plugin.ControllerPluginContext(
+        name="ReferencesProbeController",
+        filename="libTestControllers.so",
+        parameters=dict(joint="panda_joint1",
+                        reads_joint="panda_joint2",
+                        steps_joint="panda_joint3"))
+
+    assert panda.insert_model_plugin("libControllerRunner.so",
+                                     "scenario::plugins::gazebo::ControllerRunner",
+                                     controller_context.to_xml())
+
+    joint = panda.get_joint("panda_joint1")
+    reads = panda.get_joint("panda_joint2")
+    steps = panda.get_joint("panda_joint3")
+
+    def set_references() -> None:
+        assert joint.set_position_target(0.0)
+        assert joint.set_velocity_target(0.0)
+        assert joint.set_acceleration_target(0.0)
+
+    assert joint.set_control_mode(core.JointControlMode_force)
+    set_references()
+
+    for _ in range(10):
+        assert gazebo.run()
+
+    # The references are read only once if their version does not change
+    assert reads.generalized_force_target() == pytest.approx(1)
+    assert steps.generalized_force_target() == pytest.approx(10)
+
+    # Changing the control mode removes the targets. The controller notices
+    # it from the version and stops stepping until the references are set.
+    assert joint.set_control_mode(core.JointControlMode_force)
+
+    for _ in range(10):
+        assert gazebo.run()
+
+    assert reads.generalized_force_target() == pytest.approx(1)
+    assert steps.generalized_force_target() == pytest.approx(10)
+
+    set_references()
+    assert gazebo.run()
+
+    assert reads.generalized_force_target() == pytest.approx(2)
+    assert steps.generalized_force_target() == pytest.approx(11)
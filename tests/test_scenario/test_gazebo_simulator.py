@@ -5,10 +5,14 @@
 import pytest
 pytestmark = pytest.mark.scenario
 
+import time
+from scenario import core
 from ..common import utils
+from gym_ignition.utils import misc
 import gym_ignition_models
 from scenario import gazebo as scenario
 from ..common.utils import gazebo_fixture as gazebo
+from ..common.utils import default_world_fixture as default_world
 
 # Set the verbosity
 scenario.set_verbosity(scenario.Verbosity_debug)
@@ -129,3 +133,165 @@ def test_load_default_world(gazebo: scenario.GazeboSimulator):
     # TODO: understand how to compare shared ptr returned by swig with nullptr
     # world3 = gazebo.get_world("foo")
     # assert world3
+
+
+@pytest.mark.parametrize("default_world",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_runtime_step_size(default_world):
+
+    # Get the simulator and the world
+    gazebo, world = default_world
+
+    assert gazebo.run()
+    assert world.time() == pytest.approx(0.001)
+
+    assert not gazebo.set_step_size(0)
+    assert not gazebo.set_steps_per_run(0)
+
+    # Coarse steps
+    assert gazebo.set_step_size(0.01)
+    assert gazebo.set_steps_per_run(5)
+    assert gazebo.step_size() == pytest.approx(0.01)
+    assert gazebo.steps_per_run() == 5
+
+    assert gazebo.run()
+    assert world.time() == pytest.approx(0.001 + 5 * 0.01)
+
+    # Fine steps
+    assert gazebo.set_step_size(0.0005)
+    assert gazebo.set_steps_per_run(2)
+
+    assert gazebo.run()
+    assert world.time() == pytest.approx(0.001 + 5 * 0.01 + 2 * 0.0005)
+
+
+@pytest.mark.parametrize("default_world",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_runtime_step_size_physics(default_world):
+
+    # Get the simulator and the world
+    gazebo, world = default_world
+
+    # Insert a cube far from the ground
+    assert world.insert_model(utils.get_cube_urdf(),
+                              core.Pose([0, 0, 10.0], [1., 0, 0, 0]),
+                              "cube")
+    cube = world.get_model("cube")
+
+    # Make the physics process the cube with the initial step size
+    assert gazebo.run()
+    t0 = world.time()
+    v0 = cube.base_world_linear_velocity()[2]
+    assert t0 == pytest.approx(0.001)
+
+    # Change the step size after the first physics step
+    assert gazebo.set_step_size(0.01)
+    assert gazebo.set_steps_per_run(10)
+    assert gazebo.run()
+
+    # Both the simulated time and the integration of the physics must use
+    # the new step size. Under free fall the velocity is exact for any dt.
+    assert world.time() == pytest.approx(t0 + 10 * 0.01)
+    assert cube.base_world_linear_velocity()[2] == \
+           pytest.approx(v0 - 9.81 * 10 * 0.01, abs=1e-6)
+
+
+@pytest.mark.parametrize("default_world",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_termination_predicates(default_world):
+
+    # Get the simulator and the world
+    gazebo, world = default_world
+
+    # Insert a falling cube
+    assert world.insert_model(utils.get_cube_urdf(),
+                              core.Pose([0, 0, 1.0], [1., 0, 0, 0]),
+                              "cube")
+    assert gazebo.run(paused=True)
+
+    assert not gazebo.add_base_height_termination("fallen", "missing", 0.5)
+    assert gazebo.add_base_height_termination("fallen", "cube", 0.5)
+
+    # The cube falls below the threshold in ~320 steps and stops the run
+    assert gazebo.set_steps_per_run(1000)
+    assert gazebo.run()
+
+    terminations = gazebo.terminations()
+    assert len(terminations) == 1
+    assert terminations[0].predicate == "fallen"
+    assert terminations[0].world_name == world.name()
+    assert 0 < terminations[0].step < 1000
+
+    assert world.time() == pytest.approx(terminations[0].step * 0.001)
+    assert world.get_model("cube").base_position()[2] < 0.5
+
+    # The cube touches the ground in the following run
+    gazebo.clear_termination_predicates()
+    assert gazebo.add_contact_termination("ground_contact", "cube", ["cube"])
+
+    assert gazebo.run()
+    terminations = gazebo.terminations()
+    assert len(terminations) == 1
+    assert terminations[0].predicate == "ground_contact"
+    assert 0 < terminations[0].step < 1000
+
+    # Without predicates, all the steps are executed
+    gazebo.clear_termination_predicates()
+    time_before_run = world.time()
+
+    assert gazebo.run()
+    assert len(gazebo.terminations()) == 0
+    assert world.time() == pytest.approx(time_before_run + 1000 * 0.001)
+
+
+def get_world_with_boxes_sdf(number_of_boxes: int) -> str:
+
+    box = """
+        <model name="box{idx}">
+            <pose>{x} 0 0.5 0 0 0</pose>
+            <link name="link">
+                <collision name="collision">
+                    <geometry><box><size>0.1 0.1 0.1</size></box></geometry>
+                </collision>
+                <visual name="visual">
+                    <geometry><box><size>0.1 0.1 0.1</size></box></geometry>
+                </visual>
+            </link>
+        </model>"""
+
+    boxes = "".join(box.format(idx=idx, x=0.2 * idx) for idx in range(number_of_boxes))
+
+    world_sdf_string = f"""<?xml version="1.0" ?>
+    <sdf version="1.7">
+        <world name="boxes">
+            {boxes}
+        </world>
+    </sdf>"""
+
+    return misc.string_to_file(world_sdf_string)
+
+
+@pytest.mark.parametrize("gazebo, number_of_boxes",
+                         [((0.001, 1.0, 1), 1),
+                          ((0.001, 1.0, 1), 100),
+                          ((0.001, 1.0, 1), 1000)],
+                         indirect=["gazebo"],
+                         ids=str)
+def test_startup_time(gazebo: scenario.GazeboSimulator, number_of_boxes: int):
+
+    assert gazebo.insert_world_from_sdf(get_world_with_boxes_sdf(number_of_boxes))
+
+    now = time.perf_counter()
+    assert gazebo.initialize()
+    elapsed = time.perf_counter() - now
+
+    world = gazebo.get_world("boxes")
+    assert len(world.model_names()) == number_of_boxes
+
+    print(f"\nboxes={number_of_boxes}: startup={elapsed * 1000:.1f} ms")
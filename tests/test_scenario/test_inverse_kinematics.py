@@ -0,0 +1,84 @@
+# Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT). All rights reserved.
+# This software may be modified and distributed under the terms of the
+# GNU Lesser General Public License v2.1 or any later version.
+
+import pytest
+pytestmark = pytest.mark.scenario
+
+import numpy as np
+from scenario import core
+import gym_ignition_models
+from ..common import utils
+from scenario import gazebo as scenario
+from ..common.utils import gazebo_fixture as gazebo
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_inverse_kinematics(gazebo: scenario.GazeboSimulator):
+
+    assert gazebo.initialize()
+    world = gazebo.get_world().to_gazebo()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf, core.Pose_identity(), "panda")
+    panda = world.get_model("panda").to_gazebo()
+
+    # Move the arm within its limits and populate the state of the model
+    arm_joints = [f"panda_joint{i}" for i in range(1, 8)]
+    q_home = [0, -0.785, 0, -2.356, 0, 1.571, 0.785]
+    assert panda.reset_joint_positions(q_home, arm_joints)
+    assert gazebo.run()
+
+    ik = scenario.InverseKinematics()
+    assert not ik.initialize(panda, "not_existing_link")
+    assert ik.initialize(panda, "panda_link8")
+
+    assert ik.dofs() == len(arm_joints)
+    assert list(ik.joint_names()) == arm_joints
+
+    # The kinematics matches the simulated model
+    q0 = np.array(panda.joint_positions(arm_joints))
+    pose = np.array(ik.forward_kinematics(q0))
+    link8 = panda.get_link("panda_link8")
+    assert pose[0:3] == pytest.approx(link8.position(), abs=1e-6)
+    assert np.abs(pose[3:7] @ np.array(link8.orientation())) == \
+        pytest.approx(1.0, abs=1e-6)
+
+    # Build a batch of reachable targets along a joint space trajectory
+    q_targets = [q0 + np.deg2rad(10) * (i + 1) * np.ones_like(q0) / 5
+                 for i in range(5)]
+    targets = np.concatenate([ik.forward_kinematics(q) for q in q_targets])
+
+    assert ik.set_tolerance(1E-5)
+    assert ik.set_max_iterations(200)
+    assert ik.solve(targets)
+
+    solution = np.array(ik.solution()).reshape(5, ik.dofs())
+    assert np.all(np.array(ik.residuals()) <= 1E-5)
+
+    for q, target in zip(solution, targets.reshape(5, 7)):
+        pose = np.array(ik.forward_kinematics(q))
+        assert pose[0:3] == pytest.approx(target[0:3], abs=1E-4)
+        assert np.abs(pose[3:7] @ target[3:7]) == pytest.approx(1.0, abs=1E-4)
+
+    # The solver is warm started from the last solution
+    assert ik.solve(targets[-7:])
+    assert np.array(ik.solution()) == pytest.approx(solution[-1], abs=1E-6)
+
+    # Wrong targets are rejected
+    assert not ik.solve(targets[0:6])
+    assert not ik.set_warm_start([0.0])
+
+    # Position-only targets
+    assert ik.set_rotation_weight(0.0)
+    assert ik.set_warm_start(q0.tolist())
+    target = np.array(ik.forward_kinematics(q_targets[2]))
+    target[3:7] = [1.0, 0, 0, 0]
+    assert ik.solve(target)
+
+    pose = np.array(ik.forward_kinematics(ik.solution()))
+    assert pose[0:3] == pytest.approx(target[0:3], abs=1E-4)
@@ -7,6 +7,7 @@ pytestmark = pytest.mark.scenario
 
 import numpy as np
 from typing import Tuple
+from scipy.spatial.transform import Rotation
 from scenario import core
 from ..common import utils
 import gym_ignition_models
@@ -167,6 +168,30 @@ def test_model_base(gazebo: scenario.GazeboSimulator):
     assert model.get_link("support").world_angular_velocity() == \
         pytest.approx(ang_velocity, abs=0.01)
 
+    # The base state must match the state of the canonical link, that is read
+    # from its own components
+    base_state = model.base_state()
+    support = model.get_link("support")
+    assert base_state.pose.position == pytest.approx(support.position())
+    assert base_state.pose.orientation == pytest.approx(support.orientation())
+    assert base_state.world_linear_velocity == \
+        pytest.approx(support.world_linear_velocity())
+    assert base_state.world_angular_velocity == \
+        pytest.approx(support.world_angular_velocity())
+    assert base_state.world_angular_velocity == pytest.approx(ang_velocity, abs=0.01)
+    assert base_state.body_linear_velocity == \
+        pytest.approx(support.body_linear_velocity())
+    assert base_state.body_angular_velocity == \
+        pytest.approx(support.body_angular_velocity())
+
+    # The body velocities are the world velocities expressed in the base frame
+    w, x, y, z = base_state.pose.orientation
+    W_R_B = Rotation.from_quat([x, y, z, w]).as_matrix()
+    assert base_state.body_linear_velocity == \
+        pytest.approx(W_R_B.T @ np.array(base_state.world_linear_velocity))
+    assert base_state.body_angular_velocity == \
+        pytest.approx(W_R_B.T @ np.array(base_state.world_angular_velocity))
+
 
 @pytest.mark.parametrize("gazebo",
                          [(0.001, 1.0, 1)],
@@ -255,3 +280,58 @@ def test_history_of_joint_forces(
 
         assert panda.history_of_applied_joint_forces() == \
             pytest.approx(history_last_three_runs)
+
+
+@pytest.mark.parametrize("default_world", [(1.0 / 1_000, 1.0, 1)], indirect=True)
+def test_accumulators(
+        default_world: Tuple[scenario.GazeboSimulator, scenario.World]):
+
+    # Get the simulator and the world
+    gazebo, world = default_world
+
+    # Insert a falling cube
+    assert world.insert_model(utils.get_cube_urdf(),
+                              core.Pose([0, 0, 1.0], [1., 0, 0, 0]),
+                              "cube")
+    assert gazebo.run(paused=True)
+
+    cube = world.get_model("cube").to_gazebo()
+    assert cube.enable_contacts(True)
+
+    assert not cube.accumulators_enabled()
+    assert cube.enable_accumulators(True)
+    assert cube.accumulators_enabled()
+
+    # Paused runs do not update the accumulators
+    assert gazebo.run(paused=True)
+    assert cube.accumulator(scenario.AccumulatedQuantity_link_linear_velocity).samples == 0
+
+    # Run multiple steps in a single run
+    assert gazebo.set_steps_per_run(100)
+    assert gazebo.run()
+
+    velocity = cube.accumulator(scenario.AccumulatedQuantity_link_linear_velocity)
+    assert velocity.samples == 100
+    assert velocity.min == pytest.approx(9.8 * 0.001, abs=0.01)
+    assert velocity.max == pytest.approx(9.8 * 0.1, abs=0.01)
+
+    # The integral of the velocity is the travelled distance
+    assert velocity.integral == pytest.approx(1.0 - cube.base_position()[2],
+                                              abs=0.005)
+
+    # The cube has no joints and is not in contact
+    assert cube.accumulator(scenario.AccumulatedQuantity_joint_power).max == 0
+    assert cube.accumulator(scenario.AccumulatedQuantity_contact_force).max == 0
+
+    assert cube.reset_accumulators()
+    assert cube.accumulator(scenario.AccumulatedQuantity_link_linear_velocity).samples == 0
+
+    # Let the cube hit the ground. The impact is captured even if the state at
+    # the end of the run is at rest.
+    assert gazebo.set_steps_per_run(1000)
+    assert gazebo.run()
+
+    mass = 5.0
+    contact_force = cube.accumulator(scenario.AccumulatedQuantity_contact_force)
+    assert contact_force.samples == 1000
+    assert contact_force.max > mass * 9.8
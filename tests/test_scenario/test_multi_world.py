@@ -5,6 +5,10 @@
 import pytest
 pytestmark = pytest.mark.scenario
 
+import time
+from typing import List
+from scenario import core
+import gym_ignition_models
 from ..common import utils
 from scenario import gazebo as scenario
 from ..common.utils import gazebo_fixture as gazebo
@@ -107,3 +111,95 @@ def test_insert_world_multiple_calls(gazebo: scenario.GazeboSimulator):
     assert world2.name() == "world2"
 
     assert world1.id() != world2.id()
+
+
+def get_falling_cubes_simulator(number_of_worlds: int,
+                                parallel: bool,
+                                number_of_threads: int = 0) -> scenario.GazeboSimulator:
+
+    gazebo = scenario.GazeboSimulator(0.001, 1000.0, 10)
+    empty_world_sdf = utils.get_empty_world_sdf()
+
+    for idx in range(number_of_worlds):
+        assert gazebo.insert_world_from_sdf(empty_world_sdf, f"world{idx}")
+
+    assert gazebo.enable_parallel_worlds(parallel, number_of_threads)
+    assert gazebo.initialize()
+    assert gazebo.parallel_worlds_enabled() == parallel
+    assert not gazebo.enable_parallel_worlds(not parallel)
+
+    for idx in range(number_of_worlds):
+
+        world = gazebo.get_world(f"world{idx}").to_gazebo()
+        assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+        assert world.insert_model(gym_ignition_models.get_model_file("ground_plane"))
+
+        # Make the evolution of each world different
+        cube_pose = core.Pose([0, 0, 0.5 + 0.1 * idx], [1., 0, 0, 0])
+        assert world.insert_model(utils.get_cube_urdf(), cube_pose, "cube")
+
+        cube = world.get_model("cube").to_gazebo()
+        assert cube.reset_base_world_angular_velocity([0.5, -0.1 * idx, 1.0])
+
+    assert gazebo.run(paused=True)
+    return gazebo
+
+
+def get_cube_trajectories(gazebo: scenario.GazeboSimulator,
+                          number_of_runs: int) -> List[List[float]]:
+
+    trajectories = [[] for _ in gazebo.world_names()]
+
+    for _ in range(number_of_runs):
+        assert gazebo.run()
+
+        for idx, trajectory in enumerate(trajectories):
+            cube = gazebo.get_world(f"world{idx}").get_model("cube")
+            trajectory.extend(cube.base_position())
+            trajectory.extend(cube.base_orientation())
+
+    return trajectories
+
+
+def test_parallel_worlds_bit_identical():
+
+    number_of_worlds = 4
+
+    gazebo = get_falling_cubes_simulator(number_of_worlds, parallel=False)
+    sequential = get_cube_trajectories(gazebo, number_of_runs=100)
+    gazebo.close()
+
+    gazebo = get_falling_cubes_simulator(number_of_worlds,
+                                         parallel=True,
+                                         number_of_threads=number_of_worlds)
+    parallel = get_cube_trajectories(gazebo, number_of_runs=100)
+    gazebo.close()
+
+    # The trajectories must match exactly, not only approximately
+    assert parallel == sequential
+
+
+@pytest.mark.parametrize("number_of_worlds", [1, 4, 16])
+def test_parallel_worlds_scaling(number_of_worlds: int):
+
+    number_of_runs = 100
+    elapsed = dict()
+
+    for parallel in [False, True]:
+
+        gazebo = get_falling_cubes_simulator(number_of_worlds, parallel=parallel)
+
+        now = time.perf_counter()
+
+        for _ in range(number_of_runs):
+            assert gazebo.run()
+
+        elapsed[parallel] = time.perf_counter() - now
+        gazebo.close()
+
+    steps = number_of_worlds * number_of_runs * 10
+
+    print(f"\nworlds={number_of_worlds}: "
+          f"sequential={steps / elapsed[False]:.0f} steps/s "
+          f"parallel={steps / elapsed[True]:.0f} steps/s "
+          f"speedup={elapsed[False] / elapsed[True]:.2f}x")
@@ -113,3 +113,74 @@ def test_position_pid(default_world: Tuple[scenario.GazeboSimulator, scenario.Wo
         # Check that trajectory is being followed
         assert joint1.position() == pytest.approx(joint1_reference, abs=np.deg2rad(3))
         assert joint6.position() == pytest.approx(joint6_reference, abs=np.deg2rad(3))
+
+
+@pytest.mark.parametrize("default_world", [(1.0 / 1_000, 1.0, 1)], indirect=True)
+def test_remove_controlled_model(default_world: Tuple[scenario.GazeboSimulator,
+                                                      scenario.World]):
+
+    # Get the simulator and the world
+    gazebo, world = default_world
+
+    # Insert a panda model
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf)
+    panda = world.get_model("panda").to_gazebo()
+
+    # Control the model with the joint controller plugin
+    assert panda.set_joint_control_mode(core.JointControlMode_position)
+    assert panda.set_joint_position_targets(panda.joint_positions())
+
+    for _ in range(10):
+        assert gazebo.run()
+
+    # The plugins of the removed model stop processing without errors
+    assert world.remove_model("panda")
+
+    for _ in range(10):
+        assert gazebo.run()
+
+    assert "panda" not in world.model_names()
+
+
+@pytest.mark.parametrize("default_world", [(1.0 / 1_000, 1.0, 1)], indirect=True)
+def test_world_joint_controller(default_world: Tuple[scenario.GazeboSimulator,
+                                                     scenario.World]):
+
+    # Get the simulator and the world
+    gazebo, world = default_world
+
+    # Control the joints of all models from a single world plugin
+    assert not world.world_joint_controller_enabled()
+    assert world.enable_world_joint_controller()
+    assert world.world_joint_controller_enabled()
+
+    # Insert multiple panda models
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    model_names = [f"panda{idx}" for idx in range(3)]
+
+    for idx, name in enumerate(model_names):
+        pose = core.Pose([0, 2.0 * idx, 0], [1., 0, 0, 0])
+        assert world.insert_model(panda_urdf, pose, name)
+
+    # Update the model state without stepping the physics
+    assert gazebo.run(paused=True)
+
+    for name in model_names:
+        panda = world.get_model(name).to_gazebo()
+        panda.set_controller_period(gazebo.step_size())
+
+        for joint_name, pid in panda_pid_gains_1000Hz.items():
+            assert panda.get_joint(joint_name).set_pid(pid=pid)
+
+        assert panda.set_joint_control_mode(core.JointControlMode_position)
+
+    # Just fight gravity for a while
+    for _ in range(1_000):
+        assert gazebo.run()
+
+    # Check that no model moved
+    for name in model_names:
+        panda = world.get_model(name)
+        assert panda.joint_positions() == \
+            pytest.approx(panda.joint_position_targets(), abs=np.deg2rad(1))
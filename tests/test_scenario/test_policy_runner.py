@@ -0,0 +1,104 @@
+# Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT). All rights reserved.
+# This software may be modified and distributed under the terms of the
+# GNU Lesser General Public License v2.1 or any later version.
+
+import pytest
+pytestmark = pytest.mark.scenario
+
+import numpy as np
+from scenario import core
+import gym_ignition_models
+from ..common import utils
+from scenario import gazebo as scenario
+from ..common.utils import gazebo_fixture as gazebo
+from .test_pid_controllers import panda_pid_gains_1000Hz
+
+# Set the verbosity
+scenario.set_verbosity(scenario.Verbosity_debug)
+
+
+def write_linear_policy(file_name: str, weights: np.ndarray, bias: np.ndarray) -> None:
+
+    rows, cols = weights.shape
+
+    with open(file_name, "w") as f:
+        f.write("# Single linear layer\n")
+        f.write("layers 1\n")
+        f.write(f"dense {rows} {cols} linear\n")
+        f.write(" ".join(str(w) for w in weights.flatten()) + "\n")
+        f.write(" ".join(str(b) for b in bias) + "\n")
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_policy_runner(gazebo: scenario.GazeboSimulator, tmp_path):
+
+    assert gazebo.initialize()
+    step_size = gazebo.step_size()
+
+    # Get the default world
+    world = gazebo.get_world()
+
+    # Insert the physics
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    # Insert the panda arm
+    model_name = "panda"
+    panda_urdf = gym_ignition_models.get_model_file("panda")
+    assert world.insert_model(panda_urdf, core.Pose_identity(), model_name)
+    panda = world.get_model(model_name).to_gazebo()
+
+    # Set the PID gains
+    for joint_name, pid in panda_pid_gains_1000Hz.items():
+        assert panda.get_joint(joint_name).set_pid(pid=pid)
+
+    joints = [j for j in panda.joint_names() if j.startswith("panda_joint")]
+    assert panda.set_joint_control_mode(core.JointControlMode_position, joints)
+    assert panda.set_controller_period(step_size)
+
+    # The policy computes the position targets from the joint positions and
+    # velocities. The targets converge to the fixed point q = A q + b,
+    # that is chosen in the middle of the joint limits.
+    n = len(joints)
+    A = 0.5 * np.eye(n) + 0.05 * (np.eye(n, k=1) + np.eye(n, k=-1))
+    D = -0.01 * np.eye(n)
+    weights = np.hstack([A, D])
+
+    limits = [panda.get_joint(j).position_limit() for j in joints]
+    fixed_point = np.array([(l.min + l.max) / 2 for l in limits])
+    bias = (np.eye(n) - A) @ fixed_point
+
+    policy_file = str(tmp_path / "policy.txt")
+    write_linear_policy(file_name=policy_file, weights=weights, bias=bias)
+
+    context = f"""
+    <sdf version='1.7'>
+        <policy>
+            <weights>{policy_file}</weights>
+            <joints>{" ".join(joints)}</joints>
+            <target>position</target>
+        </policy>
+    </sdf>
+    """
+
+    assert panda.insert_model_plugin("libPolicyRunner.so",
+                                     "scenario::plugins::gazebo::PolicyRunner",
+                                     context)
+
+    # Step the simulator and check that the fixed point has been reached
+    for _ in range(3000):
+        assert gazebo.run()
+
+    assert panda.joint_positions(joints) == \
+        pytest.approx(fixed_point, abs=np.deg2rad(1))
+
+    # The targets are the output of the network evaluated on the last
+    # observation, that at steady state matches the current one
+    observation = np.concatenate([panda.joint_positions(joints),
+                                  panda.joint_velocities(joints)])
+    expected_targets = weights @ observation + bias
+
+    assert panda.joint_position_targets(joints) == \
+        pytest.approx(expected_targets, abs=1e-3)
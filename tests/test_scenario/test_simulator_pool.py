@@ -0,0 +1,273 @@
+# Copyright (C) 2020 Istituto Italiano di Tecnologia (IIT). All rights reserved.
+# This software may be modified and distributed under the terms of the
+# GNU Lesser General Public License v2.1 or any later version.
+
+import pytest
+pytestmark = pytest.mark.scenario
+
+import numpy as np
+from scenario import core
+from ..common import utils
+from gym_ignition.utils import misc
+from scenario import gazebo as scenario
+
+# Set the verbosity
+scenario.set_verbosity(scenario.Verbosity_debug)
+
+
+def get_world_with_box_sdf() -> str:
+
+    world_sdf_string = """
+    <?xml version="1.0" ?>
+    <sdf version="1.7">
+        <world name="default">
+            <model name="box">
+                <pose>0 0 1.0 0 0 0</pose>
+                <link name="box_link">
+                    <inertial>
+                        <mass>1.0</mass>
+                    </inertial>
+                    <collision name="box_collision">
+                        <geometry>
+                            <box>
+                                <size>0.1 0.1 0.1</size>
+                            </box>
+                        </geometry>
+                    </collision>
+                </link>
+            </model>
+        </world>
+    </sdf>"""
+
+    return misc.string_to_file(world_sdf_string)
+
+
+def get_world_with_pendulum_sdf() -> str:
+
+    world_sdf_string = """
+    <?xml version="1.0" ?>
+    <sdf version="1.7">
+        <world name="default">
+            <model name="pendulum">
+                <pose>0 0 1.0 0 0 0</pose>
+                <link name="support">
+                    <inertial>
+                        <mass>1.0</mass>
+                    </inertial>
+                </link>
+                <link name="pole">
+                    <pose>0 0 -0.25 0 0 0</pose>
+                    <inertial>
+                        <mass>0.5</mass>
+                    </inertial>
+                </link>
+                <joint name="world_to_support" type="fixed">
+                    <parent>world</parent>
+                    <child>support</child>
+                </joint>
+                <joint name="pivot" type="revolute">
+                    <parent>support</parent>
+                    <child>pole</child>
+                    <axis>
+                        <xyz>1 0 0</xyz>
+                    </axis>
+                </joint>
+            </model>
+        </world>
+    </sdf>"""
+
+    return misc.string_to_file(world_sdf_string)
+
+
+def test_acquire_release():
+
+    pool = scenario.GazeboSimulatorPool(2, 0.001, 1.0, 1)
+    assert pool.initialize()
+
+    assert pool.size() == 2
+    assert pool.available() == 2
+
+    gazebo1 = pool.acquire()
+    gazebo2 = pool.acquire()
+    assert gazebo1 is not None
+    assert gazebo2 is not None
+    assert pool.available() == 0
+
+    # The simulators are initialized and have their own worlds
+    assert gazebo1.initialized()
+    assert gazebo2.initialized()
+    assert len(gazebo1.world_names()) == 1
+    assert len(gazebo2.world_names()) == 1
+    assert gazebo1.world_names() != gazebo2.world_names()
+
+    # The pool is empty
+    assert pool.acquire() is None
+
+    assert pool.release(gazebo1)
+    assert pool.available() == 1
+
+    assert pool.release(gazebo2)
+    assert pool.available() == 2
+
+
+def test_release_restores_state():
+
+    pool = scenario.GazeboSimulatorPool(1, 0.001, 1.0, 1, get_world_with_box_sdf())
+    assert pool.initialize()
+
+    gazebo = pool.acquire()
+    world = gazebo.get_world()
+    world_name = world.name()
+
+    assert world.model_names() == ["box"]
+    initial_position = world.get_model("box").base_position()
+
+    # Insert a new model and let the box fall
+    assert world.insert_model(utils.get_cube_urdf(), core.Pose_identity(),
+                              "cube")
+    assert gazebo.set_step_size(0.002)
+
+    for _ in range(100):
+        assert gazebo.run()
+
+    assert "cube" in world.model_names()
+    assert world.get_model("box").base_position()[2] < initial_position[2]
+
+    assert pool.release(gazebo)
+
+    # The same simulator is handed out again in its pristine state
+    gazebo = pool.acquire()
+    world = gazebo.get_world()
+
+    assert world.name() == world_name
+    assert world.model_names() == ["box"]
+    assert gazebo.step_size() == pytest.approx(0.001)
+    assert world.get_model("box").base_position() == \
+        pytest.approx(initial_position)
+    assert np.linalg.norm(world.get_model("box").base_world_linear_velocity()) \
+        == pytest.approx(0.0)
+
+    assert pool.release(gazebo)
+
+
+def test_release_restores_control():
+
+    pool = scenario.GazeboSimulatorPool(1, 0.001, 1.0, 1,
+                                        get_world_with_pendulum_sdf())
+    assert pool.initialize()
+
+    gazebo = pool.acquire()
+    world = gazebo.get_world()
+    world_name = world.name()
+    pendulum = world.get_model("pendulum")
+    pivot = pendulum.get_joint("pivot")
+
+    initial_control_mode = pivot.control_mode()
+    initial_pid = pivot.pid()
+    assert initial_control_mode != core.JointControlMode_position
+
+    # Control the pendulum in position, this also loads the JointController
+    assert pivot.set_control_mode(core.JointControlMode_position)
+    assert pivot.set_pid(core.PID(1000, 0, 100))
+    assert pivot.set_position_target(0.5)
+
+    for _ in range(200):
+        assert gazebo.run()
+
+    assert world.time() > 0
+    assert pivot.position() > 0.1
+
+    assert pool.release(gazebo)
+
+    # The same simulator is handed out again in its pristine state
+    gazebo = pool.acquire()
+    world = gazebo.get_world()
+    pendulum = world.get_model("pendulum")
+    pivot = pendulum.get_joint("pivot")
+
+    assert world.name() == world_name
+    assert world.time() == pytest.approx(0.0)
+    assert pivot.control_mode() == initial_control_mode
+    assert pivot.pid().p == pytest.approx(initial_pid.p)
+    assert pivot.pid().d == pytest.approx(initial_pid.d)
+    assert pivot.position() == pytest.approx(0.0)
+
+    # The old position target must not act on the pendulum
+    for _ in range(100):
+        assert gazebo.run()
+
+    assert pivot.position() == pytest.approx(0.0, abs=1e-3)
+    assert world.time() == pytest.approx(0.1)
+
+    assert pool.release(gazebo)
+
+
+def test_release_replaces_simulators_with_plugins():
+
+    pool = scenario.GazeboSimulatorPool(1, 0.001, 1.0, 1)
+    assert pool.initialize()
+
+    gazebo = pool.acquire()
+    world = gazebo.get_world()
+    world_name = world.name()
+
+    # World plugins cannot be unloaded
+    assert world.to_gazebo().enable_world_joint_controller()
+    assert gazebo.run(paused=True)
+
+    assert pool.release(gazebo)
+    assert pool.available() == 1
+
+    # A new simulator with a new world replaced the old one
+    gazebo = pool.acquire()
+    assert gazebo.get_world().name() != world_name
+    assert not gazebo.get_world().to_gazebo().world_joint_controller_enabled()
+
+    assert pool.release(gazebo)
+
+
+def test_release_reuses_simulators():
+
+    pool = scenario.GazeboSimulatorPool(1, 0.001, 1.0, 1,
+                                        get_world_with_box_sdf())
+    assert pool.initialize()
+
+    gazebo = pool.acquire()
+    world_name = gazebo.get_world().name()
+
+    # Stepping the simulator must not prevent the rewind
+    for _ in range(5):
+
+        for _ in range(50):
+            assert gazebo.run()
+
+        assert gazebo.get_world().time() > 0
+        assert pool.release(gazebo)
+
+        gazebo = pool.acquire()
+        assert gazebo.get_world().name() == world_name
+        assert gazebo.get_world().time() == 0.0
+
+    assert pool.release(gazebo)
+
+
+def test_release_replaces_closed_simulators():
+
+    pool = scenario.GazeboSimulatorPool(1, 0.001, 1.0, 1)
+    assert pool.initialize()
+
+    gazebo = pool.acquire()
+    world_name = gazebo.get_world().name()
+
+    # Closing an acquired simulator destroys its server
+    assert gazebo.close()
+    assert not gazebo.initialized()
+
+    assert pool.release(gazebo)
+    assert pool.available() == 1
+
+    gazebo = pool.acquire()
+    assert gazebo.initialized()
+    assert gazebo.get_world().name() != world_name
+
+    assert pool.release(gazebo)
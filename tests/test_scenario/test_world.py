@@ -208,3 +208,164 @@ def test_sim_time_starts_from_zero(gazebo: scenario.GazeboSimulator):
 
     gazebo.run(paused=False)
     assert world.time() == 3 * dt
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.001, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_batched_accessors(gazebo: scenario.GazeboSimulator):
+
+    import numpy as np
+    import gym_ignition_models
+
+    assert gazebo.initialize()
+    world = gazebo.get_world().to_gazebo()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    # Insert multiple pendula
+    model_names = [f"pendulum{idx}" for idx in range(3)]
+    pendulum_urdf = gym_ignition_models.get_model_file("pendulum")
+
+    for idx, name in enumerate(model_names):
+        pose = core.Pose([0, float(idx), 1.0], [1., 0, 0, 0])
+        assert world.insert_model(pendulum_urdf, pose, name)
+
+    gazebo.run(paused=True)
+
+    for idx, name in enumerate(model_names):
+        pendulum = world.get_model(name)
+        assert pendulum.to_gazebo().reset_joint_positions([0.1 * (idx + 1)])
+
+    gazebo.run(paused=True)
+
+    # Check the stacked buffers against the per-model getters
+    positions = np.array(world.batch_joint_positions(model_names))
+    velocities = np.array(world.batch_joint_velocities(model_names))
+    base_poses = np.array(world.batch_base_poses(model_names))
+
+    assert positions.size == len(model_names)
+    assert velocities.size == len(model_names)
+    assert base_poses.size == 7 * len(model_names)
+
+    for idx, name in enumerate(model_names):
+        model = world.get_model(name)
+        assert positions[idx] == pytest.approx(model.joint_positions()[0])
+        assert velocities[idx] == pytest.approx(model.joint_velocities()[0])
+        assert base_poses[7 * idx:7 * idx + 3] == \
+            pytest.approx(model.base_position())
+        assert base_poses[7 * idx + 3:7 * (idx + 1)] == \
+            pytest.approx(model.base_orientation())
+
+    # The batched setter applies the forces to the right models
+    for name in model_names:
+        model = world.get_model(name)
+        assert model.set_joint_control_mode(core.JointControlMode_force)
+
+    forces = [0.0, 10.0, -10.0]
+    assert world.set_batch_joint_generalized_force_targets(forces, model_names)
+
+    for idx, name in enumerate(model_names):
+        model = world.get_model(name)
+        assert model.joint_generalized_force_targets() == \
+            pytest.approx([forces[idx]])
+
+    # Wrong sizes and unknown models are rejected
+    assert not world.set_batch_joint_generalized_force_targets([0.0],
+                                                               model_names)
+    assert len(world.batch_joint_positions(["unknown_model"])) == 0
+
+    # The cached layout is invalidated when a model is removed
+    assert world.remove_model(model_names[-1])
+    gazebo.run(paused=True)
+    assert len(world.batch_joint_positions(model_names)) == 0
+    assert len(world.batch_joint_positions(model_names[:-1])) == 2
+
+    # A model inserted again with the same name is resolved again
+    pose = core.Pose([0, 10.0, 1.0], [1., 0, 0, 0])
+    assert world.insert_model(pendulum_urdf, pose, model_names[-1])
+    gazebo.run(paused=True)
+
+    base_poses = np.array(world.batch_base_poses(model_names))
+    assert base_poses.size == 7 * len(model_names)
+    assert base_poses[-7:-4] == pytest.approx([0, 10.0, 1.0])
+
+
+@pytest.mark.parametrize("gazebo",
+                         [(0.004, 1.0, 1)],
+                         indirect=True,
+                         ids=utils.id_gazebo_fn)
+def test_physics_sub_steps(gazebo: scenario.GazeboSimulator):
+
+    assert gazebo.initialize()
+    world = gazebo.get_world().to_gazebo()
+    assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+    assert world.physics_sub_steps() == 1
+    assert not world.set_physics_sub_steps(0)
+    assert world.set_physics_sub_steps(4)
+    assert world.physics_sub_steps() == 4
+
+    # Insert a falling cube
+    cube_urdf = utils.get_cube_urdf()
+    pose = core.Pose([0, 0, 10.0], [1., 0, 0, 0])
+    assert world.insert_model(cube_urdf, pose, "cube")
+    cube = world.get_model("cube")
+
+    gazebo.run(paused=True)
+
+    for _ in range(100):
+        assert gazebo.run()
+
+    # The simulated time is not affected by the sub-steps
+    assert world.time() == pytest.approx(100 * gazebo.step_size())
+
+    # The free fall is integrated with the smaller sub-step size
+    t = world.time()
+    g = world.gravity()[2]
+    assert cube.base_position()[2] == pytest.approx(10.0 + 0.5 * g * t * t,
+                                                    abs=0.004)
+    assert cube.base_world_linear_velocity()[2] == pytest.approx(g * t)
+
+
+def test_physics_threads():
+
+    import gym_ignition_models
+
+    def simulate(num_of_threads: int):
+
+        gazebo = scenario.GazeboSimulator(0.001, 1000.0, 10)
+        assert gazebo.initialize()
+
+        world = gazebo.get_world().to_gazebo()
+        assert world.set_physics_engine(scenario.PhysicsEngine_dart)
+
+        assert world.physics_threads() == 1
+        assert not world.set_physics_threads(1_000_000)
+        assert world.physics_threads() == 1
+        assert world.set_physics_threads(num_of_threads)
+        assert world.physics_threads() == num_of_threads
+
+        # Insert multiple robots
+        model_names = [f"panda{idx}" for idx in range(4)]
+        panda_urdf = gym_ignition_models.get_model_file("panda")
+
+        for idx, name in enumerate(model_names):
+            pose = core.Pose([0, 2.0 * idx, 0], [1., 0, 0, 0])
+            assert world.insert_model(panda_urdf, pose, name)
+
+        gazebo.run(paused=True)
+
+        for _ in range(20):
+            assert gazebo.run()
+
+        state = [(world.get_model(name).joint_positions(),
+                  world.get_model(name).joint_velocities(),
+                  world.get_model(name).get_link("panda_link7").position())
+                 for name in model_names]
+
+        gazebo.close()
+        return state
+
+    # The state processed in parallel matches the serial one
+    assert simulate(num_of_threads=4) == simulate(num_of_threads=1)